@@ -327,7 +327,7 @@ int mp3_PickARandomNumberBetween0AndN(int n)
     int result = GetRandomByte();                   //Get a random number by picking a random byte.
     
     int randMax = 255;                              // 255 is the maximum value of a byte.
-    int randExcess = (randMax % n) + 1;             // Caluclate the biased remainder.  1/256 edge case when (randMax == n) but the result is just some wasted cycles, so acceptable.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
     int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
     while (result > randLimit)                      // Reject any random bytes with values above randLimit...
     {
@@ -357,7 +357,7 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
     }
     else
     {
-        int randValue = mp3_PickARandomNumberBetween0AndN(99);
+        int randValue = mp3_PickARandomNumberBetween0AndN(100);
         if (randValue < percentChanceOfTrue)
         {
             return 1;
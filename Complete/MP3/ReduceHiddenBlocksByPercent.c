@@ -6,6 +6,12 @@
 // PARAM: Boolean|REDUCE_ITEM_BLOCKS
 // PARAM: Boolean|REDUCE_COIN_BLOCKS
 // PARAM: Boolean|REDUCE_STAR_BLOCKS
+// PARAM: Boolean|USE_TURN_SCHEDULE
+// BOARD_RAM_BYTES: HIDDEN_BLOCK_OVERLAY|4
+// BOARD_RAM: HIDDEN_BLOCK_SCHEDULE_0|8|USE_TURN_SCHEDULE
+// BOARD_RAM: HIDDEN_BLOCK_SCHEDULE_1|8|USE_TURN_SCHEDULE
+// BOARD_RAM: HIDDEN_BLOCK_SCHEDULE_2|8|USE_TURN_SCHEDULE
+// BOARD_RAM: HIDDEN_BLOCK_SCHEDULE_3|8|USE_TURN_SCHEDULE
 
 // Redefining params here for vs code highlighting, not actually used in partyplanner.
 #ifndef USES_BOARD_RAM
@@ -23,16 +29,27 @@
 #ifndef REDUCE_STAR_BLOCKS
     #define REDUCE_STAR_BLOCKS 1
 #endif
+#ifndef USE_TURN_SCHEDULE
+    #define USE_TURN_SCHEDULE 0
+#endif
 
 //***************************************************************************//
 //******************** BOARD RAM WARNING ************************************//
 //***************************************************************************//
-// This board uses the following addresses (board RAM)
-//              D_800CD0A6;   //board_ram15
-//              D_800CD0A7;   //board_ram16
-//              D_800CD0A8;   //board_ram17
+// This event declares four bytes of board RAM with the BOARD_RAM lines in the header, and four more
+// when USE_TURN_SCHEDULE is True:
+//              HIDDEN_BLOCK_OVERLAY        4 bytes in a row - which blocks are hidden, and their real spaces
+//              HIDDEN_BLOCK_SCHEDULE_0-3   8 bits each - only reserved when USE_TURN_SCHEDULE is True
 //
-// If any other events on your board use these values, you will get unexpected behavior! 
+// HIDDEN_BLOCK_OVERLAY is an mp3lib overlay: a mask of the blocks this event has hidden, followed by
+// the space index each of them really belongs on.  The four SCHEDULE bytes hold this game's 32-bit
+// turn schedule (see the Description).  Re-run the tool after turning USE_TURN_SCHEDULE on, so they
+// get placed; until then the event flips a coin every roll.
+// The first roll of each game (turn 1, first player) clears these bytes, so this event never restores a
+// hidden block space left over from the previous game.  It doesn't need the "Board State Header" event,
+// but works alongside it.
+// Run "python3 Tools/board_ram_alloc.py your_board.json --write" to place them around the other events
+// on your board; it will tell you if anything clashes.
 //
 // You can disable this events use of board RAM by setting the "USES_BOARD_RAM" parameter to
 // "False" in PartyPlanner when you place the event.
@@ -46,7 +63,7 @@
 //******************** Version Info! ****************************************//
 //***************************************************************************//
 //
-// This is version: 1.0
+// This is version: 1.4
 //
 // There may be an update available at:
 // https://github.com/c-kennelly/mario-party-custom-events
@@ -85,10 +102,28 @@
 //
 // Leaving any of these as false will leave those blocks unmodified by this event.
 // For example you might just set REDUCE_STAR_BLOCKS to TRUE and set the HIDDEN_BLOCK_REDUCTION_PERCENT to 100 to disable star blocks only.
+//
+// USE_TURN_SCHEDULE - Flipping a coin on every roll means the number of turns with hidden blocks swings a lot
+// from game to game: at 66%, a 35 turn game could leave blocks findable on 5 turns or on 20.  Set this to TRUE
+// and, on the first roll of the game, the event instead deals out a schedule of the turns where blocks are
+// allowed.  Exactly (100 - HIDDEN_BLOCK_REDUCTION_PERCENT)% of the turns are allowed, one picked at random from
+// each even stretch of the game, so the blocks are spread out and every game gets the same number of chances.
+// Every roll after that is just a lookup in the schedule.  The schedule is 32 bits, so in games longer than
+// 32 turns each bit covers two turns.  Needs USES_BOARD_RAM, and 4 more bytes of it (see the BOARD RAM WARNING).
+//
+// Tools/hidden_block_sim.py simulates both modes if you want to compare them for your turn count.
 
 //***************************************************************************//
 //***********************     Changelist      *******************************//
 //***************************************************************************//
+//   Version 1.5 - Clears its own board RAM on the first roll of the game (turn 1, first player), so it no longer
+//                 needs the Board State Header event.  It still works alongside it.
+//   Version 1.4 - Hidden blocks are saved and restored with an mp3lib overlay instead of by hand.
+//   Version 1.3 - Added USE_TURN_SCHEDULE.  Blocks are only restored if they're still hidden, so a block the game
+//                 moved after someone found it isn't put back on its old space.
+//   Version 1.2 - Relies on the Board State Header event to clear board RAM each game, instead of
+//                 guessing at the first roll from the item block space.  0 now means "nothing saved".
+//   Version 1.1 - Board RAM is declared and placed by Tools/board_ram_alloc.py instead of hardcoded.
 //   Version 1.0 - First version of the event!
 
 //***************************************************************************//
@@ -101,13 +136,54 @@
 #include "ultra64.h"
 
 extern s8 D_800CC4E5;   // The hidden_block_item space index from the mp3 sym table
-extern s8 D_800CD0A6;   // BoardRAM to store the hidden_block_item space value
-
 extern s8 D_800CE1C5;   // The hidden_block_coins_space index from the mp3 sym table
-extern s8 D_800CD0A7;   // BoardRAM to store the hidden_block_coins space value
-
 extern s8 D_800D124F;   // The hidden_block_star index from the mp3 sym table
-extern s8 D_800CD0A8;   // BoardRAM to store the hidden_block_star value
+extern s8 D_800CD05A;   // total_turns from the mp3 sym table
+extern s8 D_800CD05B;   // current_turn from the mp3 sym table.  Starts at 1.
+
+// Each bit of the schedule is one turn, or a run of turns in games longer than this.
+#define HIDDEN_BLOCK_SCHEDULE_BITS 32
+
+// mp3lib overlay types.  Structs have to be declared above the code that uses them.
+#define MP3_OVERLAY_MAX_ENTRIES 8           // One bit each in the dirty mask byte
+
+struct mp3_OverlayEntry {
+    u8 *address;                            // The game global
+    u8 width;                               // 1, 2, or 4 bytes
+    u8 offset;                              // Where its saved value starts in the storage, after the mask byte
+};
+
+struct mp3_Overlay {
+    u8 *storage;                            // Dirty mask byte, then the saved values
+    int count;
+    int savedBytes;
+    struct mp3_OverlayEntry entries[MP3_OVERLAY_MAX_ENTRIES];
+};
+
+// BoardRAM for the overlay and the schedule, filled in by Tools/board_ram_alloc.py --write:
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Game Night" board.
+// Re-run the tool instead of editing these by hand.  Event: Reduce Hidden Blocks By Percent
+#define BOARD_RAM_LAYOUT_VERSION                 3
+extern u8 D_800CD099;
+#define HIDDEN_BLOCK_OVERLAY                     (&D_800CD099)
+#define HIDDEN_BLOCK_OVERLAY_SIZE                4
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_SetBits(byte, shift, width, value)    ((byte) = ((byte) & ~(mplib_BitMask(width) << (shift))) \
+                                                        | (((value) & mplib_BitMask(width)) << (shift)))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_SetField(NAME, value)                 mplib_SetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH, value)
+
+// The tool only reserves the schedule's bytes when a placement turns USE_TURN_SCHEDULE on.
+#ifdef HIDDEN_BLOCK_SCHEDULE_0_BYTE
+    #define HIDDEN_BLOCK_SCHEDULE_RESERVED 1
+#else
+    #define HIDDEN_BLOCK_SCHEDULE_RESERVED 0
+#endif
 
 
 //***************************************************************************//
@@ -116,107 +192,143 @@ extern s8 D_800CD0A8;   // BoardRAM to store the hidden_block_star value
 
 void main() 
 {   
-    InitializeBoardRAMOnFirstPassIfEnabled();
+    ClearBoardRAMOnFirstRoll();
 
-	if (mp3_ReturnTruePercentOfTime(HIDDEN_BLOCK_REDUCTION_PERCENT))
+    int hideBlocks;
+    if((USE_TURN_SCHEDULE == 1) && (USES_BOARD_RAM == 1) && (HIDDEN_BLOCK_SCHEDULE_RESERVED == 1))
+    {
+        hideBlocks = !IsHiddenBlockTurnInSchedule();
+    }
+    else
+    {
+        hideBlocks = mp3_ReturnTruePercentOfTime(HIDDEN_BLOCK_REDUCTION_PERCENT);
+    }
+
+    // The overlay remembers where each block really belongs while we've hidden it.
+    // Always register all three in this order, so each finds its saved space again next roll.
+    struct mp3_Overlay overlay;
+    mp3_OverlayInit(&overlay, HIDDEN_BLOCK_OVERLAY);
+    int itemBlock = mp3_OverlayRegister(&overlay, &D_800CC4E5, 1);
+    int coinBlock = mp3_OverlayRegister(&overlay, &D_800CE1C5, 1);
+    int starBlock = mp3_OverlayRegister(&overlay, &D_800D124F, 1);
+
+	if (hideBlocks)
 	{
-        // Logic has hit, blocks will be unreachable this turn if BoardRAM is enabled.
-        StoreHiddenBlocksInBoardRAMIfEnabled();
-        MakeHiddenBlocksUnreachable();
+        // Logic has hit, blocks will be unreachable this turn.
+        if(REDUCE_ITEM_BLOCKS == 1)
+        {
+            MakeHiddenBlockUnreachable(&overlay, itemBlock);
+        }
+        if(REDUCE_COIN_BLOCKS == 1)
+        {
+            MakeHiddenBlockUnreachable(&overlay, coinBlock);
+        }
+        if(REDUCE_STAR_BLOCKS == 1)
+        {
+            MakeHiddenBlockUnreachable(&overlay, starBlock);
+        }
 	}
-	else
+	else if(USES_BOARD_RAM == 1)
 	{
-        // Logic has skipped, blocks will be reachable this turn if BoardRAM is enabled.
-        RestoreHiddenBlocksFromBoardRAMIfEnabled();
+        // Logic has skipped, so put back any blocks we hid.  Does nothing if none are hidden.
+        mp3_OverlayRestore(&overlay);
 	}
 }
 
-void MakeHiddenBlocksUnreachable()
+// Board RAM isn't cleared when a new game starts, so the first roll of the game clears whatever the
+// last game left in this event's bytes.  The Board State Header event does the same for the whole
+// board when it's placed; this keeps the event working on boards without it.  It isn't a guess: turn 1's
+// first roll only happens once a game, whatever the bytes hold, and on a board with the header it just
+// clears bytes that are already 0.
+void ClearBoardRAMOnFirstRoll()
 {
-    s8 unreachableHiddenBlockSpaceIndex = 0x00;
-    if(REDUCE_ITEM_BLOCKS == 1)
+    if((USES_BOARD_RAM != 1) || (D_800CD05B != 1) || (GetCurrentPlayerIndex() != 0))
     {
-        D_800CC4E5 = unreachableHiddenBlockSpaceIndex;
-    }
-    
-    if(REDUCE_COIN_BLOCKS == 1)
-    {
-        D_800CE1C5 = unreachableHiddenBlockSpaceIndex;
+        return;
     }
 
-    if(REDUCE_STAR_BLOCKS == 1)
-    {
-        D_800D124F = unreachableHiddenBlockSpaceIndex;
-    }
+    bzero(HIDDEN_BLOCK_OVERLAY, HIDDEN_BLOCK_OVERLAY_SIZE);
+    WriteHiddenBlockSchedule(0);
 }
 
-void StoreHiddenBlocksInBoardRAMIfEnabled()
+// Moves the block to an unreachable space.  With board RAM, the overlay saves the block's real space
+// the first time so it can be restored; a block that's already hidden costs nothing.
+// Without board RAM there's nowhere to save it, so it stays hidden for the rest of the game.
+void MakeHiddenBlockUnreachable(struct mp3_Overlay *overlay, int index)
 {
-    if(USES_BOARD_RAM != 1)
-    {
-        return;
-    }
-
-    if(REDUCE_ITEM_BLOCKS == 1)
+    s8 unreachableHiddenBlockSpaceIndex = 0x00;
+    if(USES_BOARD_RAM == 1)
     {
-        // Store the item block space in BoardRAM.
-        D_800CD0A6 = D_800CC4E5;
+        mp3_OverlayPatch(overlay, index, unreachableHiddenBlockSpaceIndex);
     }
-    
-    if(REDUCE_COIN_BLOCKS == 1)
+    else
     {
-        // Store the coin block space in BoardRAM.
-        D_800CD0A7 = D_800CE1C5;
+        *(overlay->entries[index].address) = unreachableHiddenBlockSpaceIndex;
     }
+}
 
-    if(REDUCE_STAR_BLOCKS == 1)
+// Returns 1 if hidden blocks are allowed this turn.  The first roll of the game (when the schedule is
+// still 0, thanks to ClearBoardRAMOnFirstRoll) deals out the schedule and saves it in board RAM.
+int IsHiddenBlockTurnInSchedule()
+{
+    u32 schedule = ReadHiddenBlockSchedule();
+    if(schedule == 0)
     {
-        // Store the star block space in BoardRAM.
-        D_800CD0A8 = D_800D124F;
+        schedule = BuildHiddenBlockSchedule();
+        WriteHiddenBlockSchedule(schedule);
     }
+
+    int scheduleBit = (D_800CD05B - 1) / GetTurnsPerScheduleBit();
+    return (schedule >> scheduleBit) & 1;
 }
 
-void RestoreHiddenBlocksFromBoardRAMIfEnabled()
+// Games longer than HIDDEN_BLOCK_SCHEDULE_BITS turns share each bit between neighbouring turns.
+int GetTurnsPerScheduleBit()
 {
-    if(USES_BOARD_RAM != 1)
-    {
-        return;
-    }
+    return (D_800CD05A + HIDDEN_BLOCK_SCHEDULE_BITS - 1) / HIDDEN_BLOCK_SCHEDULE_BITS;
+}
 
-    if(REDUCE_ITEM_BLOCKS == 1)
-    {
-        // Restore the item block space value from BoardRAM so it can be found again.
-        D_800CC4E5 = D_800CD0A6;
-    }
-    
-    if(REDUCE_COIN_BLOCKS == 1)
-    {
-        // Restore the coin block space value from BoardRAM so it can be found again
-        D_800CE1C5 = D_800CD0A7;
-    }
+// Allows exactly (100 - HIDDEN_BLOCK_REDUCTION_PERCENT)% of the schedule bits, rounded to the nearest bit.
+// The bits are split into one even window per allowed bit and one bit is picked at random from each window,
+// so the allowed turns are spread across the game instead of clumping.
+u32 BuildHiddenBlockSchedule()
+{
+    int turnsPerBit = GetTurnsPerScheduleBit();
+    int scheduleBits = (D_800CD05A + turnsPerBit - 1) / turnsPerBit;
+    int allowedPercent = 100 - mplib_max(0, mplib_min(HIDDEN_BLOCK_REDUCTION_PERCENT, 100));
+    int allowedBits = ((scheduleBits * allowedPercent) + 50) / 100;
 
-    if(REDUCE_STAR_BLOCKS == 1)
+    u32 schedule = 0;
+    int window;
+    for(window = 0; window < allowedBits; window++)
     {
-        // Restore the star block space value from BoardRAM so it can be found again.
-        D_800D124F = D_800CD0A8;
+        int windowStart = (window * scheduleBits) / allowedBits;
+        int windowEnd = ((window + 1) * scheduleBits) / allowedBits;
+        schedule |= (1u << (windowStart + mp3_PickARandomNumberBetween0AndN(windowEnd - windowStart)));
     }
+    return schedule;
 }
 
-void InitializeBoardRAMOnFirstPassIfEnabled()
+u32 ReadHiddenBlockSchedule()
 {
-    if(USES_BOARD_RAM != 1)
-    {
-        return;
-    }
+#if HIDDEN_BLOCK_SCHEDULE_RESERVED
+    return ((u32)mplib_GetField(HIDDEN_BLOCK_SCHEDULE_3) << 24)
+         | (mplib_GetField(HIDDEN_BLOCK_SCHEDULE_2) << 16)
+         | (mplib_GetField(HIDDEN_BLOCK_SCHEDULE_1) << 8)
+         |  mplib_GetField(HIDDEN_BLOCK_SCHEDULE_0);
+#else
+    return 0;
+#endif
+}
 
-    if(D_800CC4E5 != 0)
-    {
-        return;
-    }
-        
-    D_800CD0A6 = -1;
-    D_800CD0A7 = -1;
-    D_800CD0A8 = -1;
+void WriteHiddenBlockSchedule(u32 schedule)
+{
+#if HIDDEN_BLOCK_SCHEDULE_RESERVED
+    mplib_SetField(HIDDEN_BLOCK_SCHEDULE_3, schedule >> 24);
+    mplib_SetField(HIDDEN_BLOCK_SCHEDULE_2, schedule >> 16);
+    mplib_SetField(HIDDEN_BLOCK_SCHEDULE_1, schedule >> 8);
+    mplib_SetField(HIDDEN_BLOCK_SCHEDULE_0, schedule);
+#endif
 }
 
 
@@ -238,6 +350,88 @@ void InitializeBoardRAMOnFirstPassIfEnabled()
 //***************************************************************************//
 
 
+void mp3_OverlayInit(struct mp3_Overlay *overlay, u8 *storage)
+{
+    overlay->storage = storage;
+    overlay->count = 0;
+    overlay->savedBytes = 0;
+}
+
+// Registers a global and returns its entry index, or -1 if the overlay is full.
+// Register in the same order every time the event runs, so each entry finds its saved value again.
+int mp3_OverlayRegister(struct mp3_Overlay *overlay, void *address, int width)
+{
+    if(overlay->count >= MP3_OVERLAY_MAX_ENTRIES)
+    {
+        return -1;
+    }
+
+    struct mp3_OverlayEntry *entry = &overlay->entries[overlay->count];
+    entry->address = (u8*)address;
+    entry->width = width;
+    entry->offset = 1 + overlay->savedBytes;
+    overlay->savedBytes += width;
+    return overlay->count++;
+}
+
+int mp3_OverlayIsPatched(struct mp3_Overlay *overlay, int index)
+{
+    return (overlay->storage[0] >> index) & 1;
+}
+
+// Writes a value to the entry's global, saving the real value first if it isn't already patched.
+void mp3_OverlayPatch(struct mp3_Overlay *overlay, int index, u32 value)
+{
+    struct mp3_OverlayEntry *entry = &overlay->entries[index];
+    u8 *saved = &overlay->storage[entry->offset];
+    int i;
+
+    if(!mp3_OverlayIsPatched(overlay, index))
+    {
+        bcopy(entry->address, saved, entry->width);
+        overlay->storage[0] |= (1 << index);
+    }
+
+    // The N64 is big-endian, so the value's low bytes go at the end.
+    for(i = entry->width - 1; i >= 0; i--)
+    {
+        if(entry->address[i] != (u8)value)
+        {
+            entry->address[i] = (u8)value;
+        }
+        value >>= 8;
+    }
+}
+
+// Puts the entry's real value back, if it's patched.
+void mp3_OverlayRestoreEntry(struct mp3_Overlay *overlay, int index)
+{
+    if(!mp3_OverlayIsPatched(overlay, index))
+    {
+        return;
+    }
+
+    struct mp3_OverlayEntry *entry = &overlay->entries[index];
+    bcopy(&overlay->storage[entry->offset], entry->address, entry->width);
+    overlay->storage[0] &= ~(1 << index);
+}
+
+// Puts back every patched global.  Returns right away when nothing is patched.
+void mp3_OverlayRestore(struct mp3_Overlay *overlay)
+{
+    int dirtyMask = overlay->storage[0];
+    int index = 0;
+    while(dirtyMask != 0)
+    {
+        if(dirtyMask & 1)
+        {
+            mp3_OverlayRestoreEntry(overlay, index);
+        }
+        dirtyMask >>= 1;
+        index++;
+    }
+}
+
 // Picks a random number between 0 and N, using rejection sampling to avoid modulo bias.
 // Don't use this!!! -->  { return GetRandomByte() % n; } or you may bias your random generation!
 // https://zuttobenkyou.wordpress.com/2012/10/18/generating-random-numbers-without-modulo-bias/
@@ -248,7 +442,7 @@ int mp3_PickARandomNumberBetween0AndN(int n)
     int result = GetRandomByte();                   //Get a random number by picking a random byte.
     
     int randMax = 255;                              // 255 is the maximum value of a byte.
-    int randExcess = (randMax % n) + 1;             // Caluclate the biased remainder.  1/256 edge case when (randMax == n) but the result is just some wasted cycles, so acceptable.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
     int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
     while (result > randLimit)                      // Reject any random bytes with values above randLimit...
     {
@@ -277,7 +471,7 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
     }
     else
     {
-        int randValue = mp3_PickARandomNumberBetween0AndN(99);
+        int randValue = mp3_PickARandomNumberBetween0AndN(100);
         if (randValue < percentChanceOfTrue)
         {
             return 1;
@@ -287,4 +481,18 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
             return 0;
         }
     }
-}
\ No newline at end of file
+}
+
+// Returns the smaller of two numbers.  Ties go to the first argument.
+int mplib_min(int a1, int a2)
+{
+    if (a1 <= a2) { return a1; }
+    else { return a2; }
+}
+
+// Returns the largest of two numbers.  Ties go to the first argument.
+int mplib_max(int a1, int a2)
+{
+    if (a1 >= a2) { return a1; }
+    else { return a2; }
+}
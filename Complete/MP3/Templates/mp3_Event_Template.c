@@ -3,6 +3,7 @@
 // EXECUTION: Direct
 // PARAM: Boolean|USES_BOARD_RAM
 // PARAM: +Number|COIN_REWARD
+// BOARD_RAM: TODO_REPLACE_THIS_FIELD|4
 
 // Redefining params here for vs code highlighting, not actually used in partyplanner.
 #ifndef COIN_REWARD
@@ -23,21 +24,19 @@
 //***************************************************************************//
 //******************** BOARD RAM WARNING ************************************//
 //***************************************************************************//
-// This board uses the following addresses (board RAM)
-//                  TODO: Take this list down to only the ones used.
-//              D_800CD0A0;   //board_ram9
-//              D_800CD0A1;   //board_ram10
-//              D_800CD0A2;   //board_ram11
-//              D_800CD0A3;   //board_ram12
-//              D_800CD0A4;   //board_ram13
-//              D_800CD0A5;   //board_ram14
-//              D_800CD0A6;   //board_ram15
-//              D_800CD0A7;   //board_ram16
-//              D_800CD0A8;   //board_ram17
+// This event declares the board RAM it needs with "// BOARD_RAM: NAME|bits" lines in the header,
+// right under the PARAMs.  Each field can be 1-8 bits wide.
+//                  TODO: Replace the example field with the ones this event needs.
 //
-// If any other events on your board use these values, you will get unexpected behavior! 
+// Don't pick the addresses by hand!  Run the allocator against your board and it will pack
+// every event's fields into the free board RAM and fill in the BOARD RAM SLOTS block below:
 //
-// You can disable this quiz's use of board RAM by setting the "USES_BOARD_RAM" parameter to
+//      python3 Tools/board_ram_alloc.py path/to/your_board.json --write
+//
+// If the fields don't fit, or another event on your board already uses the same bytes,
+// the tool tells you which events clash instead of letting you get unexpected behavior.
+//
+// You can disable this event's use of board RAM by setting the "USES_BOARD_RAM" parameter to
 // "False" in PartyPlanner when you place the event.
 //
 // TODO: Describe what the board uses board_ram for.  Describe what the behavior falls back to if
@@ -84,10 +83,9 @@
 // For more exploration: http://n64devkit.square7.ch/header/
 #include "ultra64.h"
 
-// Event parameter can disable this:
-extern u8 D_800CD0A3;	//IsInitialized - 1 == yes.
-extern u8 D_800CD0A4;	//firstPlayerIndex
-extern u8 D_800CD0A5;	//secondPlayerIndex
+// Event parameter can disable this.  Filled in by Tools/board_ram_alloc.py --write:
+//******************** BOARD RAM SLOTS (generated) ****************************
+//******************** /BOARD RAM SLOTS ***************************************
 
 // The Player struct for Mario Party 3, used for player manipulation.
 // Reference wiki article can be found here:
@@ -226,7 +224,7 @@ int mp3_PickARandomNumberBetween0AndN(int n)
     int result = GetRandomByte();                   //Get a random number by picking a random byte.
     
     int randMax = 255;                              // 255 is the maximum value of a byte.
-    int randExcess = (randMax % n) + 1;             // Caluclate the biased remainder.  1/256 edge case when (randMax == n) but the result is just some wasted cycles, so acceptable.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
     int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
     while (result > randLimit)                      // Reject any random bytes with values above randLimit...
     {
@@ -256,7 +254,7 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
     }
     else
     {
-        int randValue = mp3_PickARandomNumberBetween0AndN(99);
+        int randValue = mp3_PickARandomNumberBetween0AndN(100);
         if (randValue < percentChanceOfTrue)
         {
             return 1;
@@ -101,7 +101,7 @@ int mp3_PickARandomNumberBetween0AndN(int n)
     int result = GetRandomByte();                   //Get a random number by picking a random byte.
     
     int randMax = 255;                              // 255 is the maximum value of a byte.
-    int randExcess = (randMax % n) + 1;             // Caluclate the biased remainder.  1/256 edge case when (randMax == n) but the result is just some wasted cycles, so acceptable.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
     int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
     while (result > randLimit)                      // Reject any random bytes with values above randLimit...
     {
@@ -130,7 +130,7 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
     }
     else
     {
-        int randValue = mp3_PickARandomNumberBetween0AndN(99);
+        int randValue = mp3_PickARandomNumberBetween0AndN(100);
         if (randValue < percentChanceOfTrue)
         {
             return 1;
@@ -207,9 +207,9 @@ int mp3_IsPlayerCertainCharacter(int playerIndex, enum mp3_Character character)
 
 char* mp3_GetCharacterNameStringFromPlayerIndex(int playerIndex)
 {
-    char* characterName = func_80035934(8);         // malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
+    char* characterName = func_80035934(16);        // malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
                                                     // transition, such as a minigame.  Or, you can call free() with func_80035958(ptr)
-    bzero(characterName, 8);                        // Zero out the memory allocated above so we don't get unexpected behavior.
+    bzero(characterName, 16);                       // Zero out the memory allocated above so we don't get unexpected behavior.
     
     int characterInt = -1;     
 
@@ -317,6 +317,939 @@ void mp3_SwapCursedMushroomBits(int firstPlayerIndex, int secondPlayerIndex)
     //bits in a byte from two positions - doesn't matter if it's an int or not.
 }
 
+// Character shuffles, for Swap Character's Shuffle modes where everyone is guaranteed a new character.
+// Rerolling random orders until nobody keeps their character works, but there's no limit on how many
+// times it calls GetRandomByte().  These always use the same number of random bytes and the same time.
+#define MP3_CHARACTER_COUNT 8
+
+// Picks a random number between 0 and N-1 (N up to 256) from exactly two random bytes.
+// Unlike mp3_PickARandomNumberBetween0AndN this never rerolls: it scales a 16 bit roll down to N.
+// The price is a bias of under N/65536 between values (about 0.01% for N = 9), which no player will notice.
+int mp3_PickARandomNumberBetween0AndNFixedRolls(int n)
+{
+    u32 roll = (GetRandomByte() << 8) | GetRandomByte();
+    return (roll * n) >> 16;
+}
+
+// All 9 ways to shuffle 4 players so nobody keeps their own character (the derangements of 4).
+// 2 bits per player: player i gets the character of player (entry >> (i * 2)) & 3.
+static const u8 MP3_DERANGEMENTS_OF_4[9] = {
+    0xB1, 0x39, 0x8D,   // 1032, 1230, 1302
+    0x72, 0x4E, 0x1E,   // 2031, 2301, 2310
+    0x93, 0x4B, 0x1B    // 3012, 3201, 3210
+};
+
+// Fills newCharacters[4] so every player gets another player's character.
+// One roll picks one of the 9 derangements, each equally likely.
+void mp3_ShuffleCharactersAmongPlayers(u8 *currentCharacters, u8 *newCharacters)
+{
+    int derangement = MP3_DERANGEMENTS_OF_4[mp3_PickARandomNumberBetween0AndNFixedRolls(9)];
+    int i;
+
+    for(i = 0; i < 4; i++)
+    {
+        newCharacters[i] = currentCharacters[(derangement >> (i * 2)) & 3];
+    }
+}
+
+// Fills newCharacters[4] from all 8 characters, so players can also land on characters nobody is playing.
+// Nobody keeps their own character, and no two players get the same one.
+//
+// This is a partial Fisher-Yates shuffle of the 8 characters, stopped after 4 draws.  Before each
+// player draws, their own character is parked at the end of the pool, just out of reach of the roll.
+// Always 4 rolls, one per player.
+void mp3_ShuffleCharactersFromPool(u8 *currentCharacters, u8 *newCharacters)
+{
+    u8 pool[MP3_CHARACTER_COUNT];
+    int last = MP3_CHARACTER_COUNT - 1;
+    int i, j;
+
+    for(i = 0; i < MP3_CHARACTER_COUNT; i++)
+    {
+        pool[i] = i;
+    }
+
+    for(i = 0; i < 4; i++)
+    {
+        // pool[i] to pool[last] are the characters nobody has drawn yet.
+        int ownIndex = -1;
+        for(j = i; j <= last; j++)
+        {
+            if(pool[j] == currentCharacters[i])
+            {
+                ownIndex = j;
+            }
+        }
+
+        int drawSize = MP3_CHARACTER_COUNT - i;
+        if(ownIndex >= 0)
+        {
+            pool[ownIndex] = pool[last];
+            pool[last] = currentCharacters[i];
+            drawSize--;     // Leave our own character out of the draw
+        }
+
+        int pick = i + mp3_PickARandomNumberBetween0AndNFixedRolls(drawSize);
+        u8 drawn = pool[pick];
+        pool[pick] = pool[i];
+        pool[i] = drawn;
+        newCharacters[i] = drawn;
+    }
+}
+
+// Item values for the Player struct's items[3] array.  An empty slot holds MP3_ITEM_NONE.
+// Same table as Gwonam's Get Random Item event.
+#define MP3_ITEM_NONE 0xFF
+enum mp3_Item {Mushroom, SkeletonKey, PoisonMushroom, ReverseMushroom, CellularShopper, WarpBlock,
+               PlunderChest, BowserPhone, DuelingGlove, LuckyLamp, GoldenMushroom, BooBell, BooRepellant,
+               BowserSuit, MagicLamp, KoopaCard, BarterBox, LuckyCoin, WackyWatch};
+
+// Reads all three item slots with a single load instead of checking them one byte at a time.
+// items[3] sits at offset 24 of the Player struct, so it's word aligned.  The N64 is big-endian, so
+// items[0] lands in the top byte and bowser_suit_flag (offset 27) in the bottom byte, which we shift away.
+u32 mp3_ReadItemSlotsWord(struct Player *p)
+{
+    return (*((u32*)p->items)) >> 8;
+}
+
+// Takes the 3-byte word from mp3_ReadItemSlotsWord() and returns a 3-bit mask with bit N set
+// when slot N holds the given value.  Each slot is tested at the same time:
+// XOR turns matching bytes into zero, and the add/OR/NOT sets the high bit of every zero byte.
+int mplib_MatchItemSlots(u32 itemSlots, int value)
+{
+    u32 x = itemSlots ^ ((value & 0xFF) * 0x010101);
+    u32 zeroBytes = ~(((x & 0x7F7F7F) + 0x7F7F7F) | x) & 0x808080;
+
+    return ((zeroBytes >> 23) & 1) | ((zeroBytes >> 14) & 2) | ((zeroBytes >> 5) & 4);
+}
+
+// Returns the lowest slot set in a mask from mplib_MatchItemSlots(), or -1 if no slots are set.
+int mplib_FirstItemSlotInMask(int slotMask)
+{
+    if(slotMask & 1) { return 0; }
+    if(slotMask & 2) { return 1; }
+    if(slotMask & 4) { return 2; }
+    return -1;
+}
+
+// Returns the first empty item slot for the player, or -1 if their inventory is full.
+int mp3_FindFreeItemSlot(int playerIndex)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if(p == NULL)
+    {
+        return -1;
+    }
+
+    return mplib_FirstItemSlotInMask(mplib_MatchItemSlots(mp3_ReadItemSlotsWord(p), MP3_ITEM_NONE));
+}
+
+// Returns how many items the player is holding (0-3).
+int mp3_CountPlayerItems(int playerIndex)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if(p == NULL)
+    {
+        return 0;
+    }
+
+    int emptySlots = mplib_MatchItemSlots(mp3_ReadItemSlotsWord(p), MP3_ITEM_NONE);
+    return 3 - ((emptySlots & 1) + ((emptySlots >> 1) & 1) + ((emptySlots >> 2) & 1));
+}
+
+// Returns 1 if the player is holding at least one of the given item, 0 if not.
+int mp3_PlayerHasItem(int playerIndex, enum mp3_Item item)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if(p == NULL)
+    {
+        return 0;
+    }
+
+    if(mplib_MatchItemSlots(mp3_ReadItemSlotsWord(p), item) != 0)
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// Puts the item in the player's first empty slot.  No messages are shown, so you can
+// give an item in the same event that shows your own flavor text.
+// Returns the slot the item went into, or -1 if the player's inventory was full.
+int mp3_GivePlayerItem(int playerIndex, enum mp3_Item item)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if(p == NULL)
+    {
+        return -1;
+    }
+
+    int slot = mplib_FirstItemSlotInMask(mplib_MatchItemSlots(mp3_ReadItemSlotsWord(p), MP3_ITEM_NONE));
+    if(slot >= 0)
+    {
+        p->items[slot] = item;
+    }
+
+    return slot;
+}
+
+// Removes the first copy of the item from the player's inventory and slides any items
+// after it forward, so the occupied slots stay packed at the front like the game expects.
+// Returns the slot the item was removed from, or -1 if the player didn't have it.
+int mp3_RemovePlayerItem(int playerIndex, enum mp3_Item item)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if(p == NULL)
+    {
+        return -1;
+    }
+
+    u32 itemSlots = mp3_ReadItemSlotsWord(p);
+    int slot = mplib_FirstItemSlotInMask(mplib_MatchItemSlots(itemSlots, item));
+    if(slot < 0)
+    {
+        return -1;
+    }
+
+    // Keep the slots in front of the removed one, shift the slots behind it forward by one,
+    // and refill the last slot with MP3_ITEM_NONE.
+    u32 frontMask = (~(0xFFFFFF >> (slot * 8))) & 0xFFFFFF;
+    u32 behindMask = 0xFFFF >> (slot * 8);
+    itemSlots = (itemSlots & frontMask) | ((itemSlots & behindMask) << 8) | MP3_ITEM_NONE;
+
+    // Write all three slots back in one store, preserving bowser_suit_flag in the low byte.
+    u32 *itemWord = (u32*)p->items;
+    *itemWord = (itemSlots << 8) | (*itemWord & 0xFF);
+
+    return slot;
+}
+
+// Board state header.
+// Board RAM isn't cleared between games, so an event that checks "is my byte still 0?" to decide
+// whether to set itself up can pick up whatever the last game left behind.  The "Board State Header"
+// event owns two board RAM fields that say whether the rest of board RAM belongs to THIS game:
+//
+//      MP3LIB_BOARD_STATE_STAMP    6 bits  - bits 5-4: layout version, BOARD_RAM_LAYOUT_VERSION from
+//                                                      Tools/board_ram_alloc.py
+//                                            bits 3-0: per-game seed, 1-15, picked when a game starts
+//      MP3LIB_BOARD_STATE_CHECK    8 bits  - mp3_BoardStateCheck() of the stamp and the turn it was stamped on
+//
+// The event runs once at the start of every turn.  If the header isn't valid for this turn, it
+// clears all of board RAM and stamps a new header, so every other event can count on its fields
+// reading 0 at the start of a game and doesn't need its own first-run heuristic.
+//
+// The seed is never 0, so board RAM that reads all zeros is never taken for a header.  A header left
+// over from the end of another game never passes on turn 1 (see mp3_BoardStateCheck), and any other
+// stray bytes only pass if the version and the whole check byte happen to match, about 1 time in 500.
+#define MP3_BOARD_STATE_VERSION_SHIFT   4
+#define MP3_BOARD_STATE_SEED_MASK       0x0F
+
+extern s8 D_800CD05B;       // current_turn from the mp3 sym table.  Starts at 1.
+
+// Turn 1 always gets the base value for the version and seed, and every later turn gets one of the
+// other 255 values.  So a header stamped on any later turn of any game can never pass for a turn 1 header.
+int mp3_BoardStateCheck(int layoutVersion, int seed, int turn)
+{
+    int base = ((seed * 0x9D) + (layoutVersion * 0x3B)) & 0xFF;
+    if(turn <= 1)
+    {
+        return base;
+    }
+    return base ^ (1 + ((turn - 2) % 255));
+}
+
+u8 mp3_MakeBoardStateStamp(int layoutVersion, int seed)
+{
+    return ((layoutVersion & 3) << MP3_BOARD_STATE_VERSION_SHIFT) | (seed & MP3_BOARD_STATE_SEED_MASK);
+}
+
+int mp3_GetBoardStateSeed(u8 stamp)
+{
+    return stamp & MP3_BOARD_STATE_SEED_MASK;
+}
+
+// Returns 1 if the header was stamped by this game on this turn or the one before it.
+// On turn 1 only a turn 1 stamp counts, which is what catches a previous game's leftovers.
+int mp3_IsBoardStateHeaderCurrent(u8 stamp, u8 check, int layoutVersion, int turn)
+{
+    int seed = mp3_GetBoardStateSeed(stamp);
+    if((seed == 0) || (((stamp >> MP3_BOARD_STATE_VERSION_SHIFT) & 3) != (layoutVersion & 3)))
+    {
+        return 0;
+    }
+
+    if(check == mp3_BoardStateCheck(layoutVersion, seed, turn))
+    {
+        return 1;   // Already stamped this turn, e.g. the scene was reloaded.
+    }
+    return (turn > 1) && (check == mp3_BoardStateCheck(layoutVersion, seed, turn - 1));
+}
+
+// Returns this game's seed (1-15) if the header is current, or 0 if it isn't, i.e. board RAM can't be
+// trusted to belong to this game.  Declare the header's fields in your event to call this:
+//
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+int mp3_GetCurrentBoardStateSeed()
+{
+    u8 stamp = mplib_GetField(MP3LIB_BOARD_STATE_STAMP);
+    if(!mp3_IsBoardStateHeaderCurrent(stamp, mplib_GetField(MP3LIB_BOARD_STATE_CHECK), BOARD_RAM_LAYOUT_VERSION, D_800CD05B))
+    {
+        return 0;
+    }
+    return mp3_GetBoardStateSeed(stamp);
+}
+
+// board_ram1.  Declared like the generated slot blocks declare it (a single u8) so the two don't
+// clash, and the rest of board RAM is reached through its address.  Not a claim on any one byte.
+extern u8 D_800CD098;
+#define MP3_BOARD_RAM_BYTES 17
+
+// Zeroes every byte of board RAM (board_ram1 - board_ram17).
+void mp3_ClearBoardRAM()
+{
+    bzero(&D_800CD098, MP3_BOARD_RAM_BYTES);
+}
+
+// Per-placement instance state.
+// Every copy of an event placed on a board runs the same code and sees the same globals, so two
+// Character Doors (or two quiz spaces) can't keep separate state in board RAM without every copy
+// taking its own bytes.  Instead, each placement gets a few bytes in a small table on the perm heap
+// (MallocPerm survives scene transitions, unlike func_80035934), found by the space it sits on.
+//
+// Entries are keyed by (chain index, space index, event tag).  The event tag is any number 1-255
+// you pick for your event, so two different events on the same space don't share an entry.
+// Lookups hash the key straight to a slot and step forward on a collision, so it's O(1) however
+// many doors the board has.  A new entry's state starts out zeroed.
+//
+// The table is allocated the first time it's needed each game, and its address is kept in three
+// board RAM bytes that every event using it shares.  Add these lines to your event's header and
+// paste the mplib bitfield accessors into your Declarations section:
+//
+//      // BOARD_RAM: MP3LIB_INSTANCE_TABLE_HI|8
+//      // BOARD_RAM: MP3LIB_INSTANCE_TABLE_MID|8
+//      // BOARD_RAM: MP3LIB_INSTANCE_TABLE_LO|8
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+//
+// An address in board RAM may be left over from another game, or from before the console was reset,
+// and the perm heap there can still hold an old table with its magic intact.  So the table needs the
+// board's Board State Header: it's stamped with the header's per-game seed, and only reused while the
+// header is current and the seeds match.  Otherwise it's rebuilt empty, so per-placement state goes
+// back to 0.  Without a current header there's no table at all (mp3_GetInstanceState returns NULL).
+#define MP3_INSTANCE_TABLE_MAGIC        0x494E5354                      // "INST"
+#define MP3_INSTANCE_TABLE_BITS         5
+#define MP3_INSTANCE_TABLE_CAPACITY     (1 << MP3_INSTANCE_TABLE_BITS)  // 32 placements per board
+#define MP3_INSTANCE_STATE_BYTES        4
+
+struct mp3_InstanceEntry {
+    u32 key;                                // Chain (bits 31-24), space (23-16), event tag (15-8), 1 = in use (bit 0).  0 is empty.
+    u8 state[MP3_INSTANCE_STATE_BYTES];     // Yours to use.  Starts zeroed.
+}; // sizeof == 8
+
+struct mp3_InstanceTable {
+    u32 magic;                              // MP3_INSTANCE_TABLE_MAGIC, so we can tell a live table from a stale address
+    u32 seed;                               // The board state header's seed for the game that built the table
+    u32 count;                              // Entries in use
+    struct mp3_InstanceEntry entries[MP3_INSTANCE_TABLE_CAPACITY];
+}; // sizeof == 268
+
+// Returns 1 if address could be a perm heap block: word aligned, and inside the 8MB of RDRAM.
+int mplib_IsRDRAMAddress(u32 address)
+{
+    return (address >= 0x80000000) && (address < 0x80800000) && ((address & 3) == 0);
+}
+
+// Returns this game's instance table, allocating it on first use.  NULL if the board state header
+// isn't current, since then there's no telling this game's table from another one's.
+struct mp3_InstanceTable* mp3_GetInstanceTable()
+{
+    int seed = mp3_GetCurrentBoardStateSeed();
+    if(seed == 0)
+    {
+        return NULL;
+    }
+
+    u32 address = (mplib_GetField(MP3LIB_INSTANCE_TABLE_HI) << 16)
+                | (mplib_GetField(MP3LIB_INSTANCE_TABLE_MID) << 8)
+                |  mplib_GetField(MP3LIB_INSTANCE_TABLE_LO);
+    struct mp3_InstanceTable *table = (struct mp3_InstanceTable*)(0x80000000 | address);
+
+    if((address != 0) && mplib_IsRDRAMAddress((u32)table) && (table->magic == MP3_INSTANCE_TABLE_MAGIC)
+        && (table->seed == seed))
+    {
+        return table;
+    }
+
+    table = MallocPerm(sizeof(struct mp3_InstanceTable));
+    bzero(table, sizeof(struct mp3_InstanceTable));
+    table->magic = MP3_INSTANCE_TABLE_MAGIC;
+    table->seed = seed;
+
+    address = ((u32)table) & 0xFFFFFF;
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_HI, address >> 16);
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_MID, address >> 8);
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_LO, address);
+    return table;
+}
+
+// Returns the state bytes for the event with this tag on the given space, creating a zeroed entry
+// the first time.  Returns NULL if all MP3_INSTANCE_TABLE_CAPACITY entries are taken, or there's no
+// table because the board state header isn't current.
+u8* mp3_GetInstanceState(int chainIndex, int spaceIndex, int eventTag)
+{
+    struct mp3_InstanceTable *table = mp3_GetInstanceTable();
+    if(table == NULL)
+    {
+        return NULL;
+    }
+
+    u32 key = ((chainIndex & 0xFF) << 24) | ((spaceIndex & 0xFF) << 16) | ((eventTag & 0xFF) << 8) | 1;
+
+    // Fibonacci hashing: multiply by 2^32 / golden ratio and keep the top bits as the slot.
+    u32 slot = (key * 0x9E3779B1) >> (32 - MP3_INSTANCE_TABLE_BITS);
+    int i;
+    for(i = 0; i < MP3_INSTANCE_TABLE_CAPACITY; i++)
+    {
+        struct mp3_InstanceEntry *entry = &table->entries[slot];
+        if(entry->key == key)
+        {
+            return entry->state;
+        }
+        if(entry->key == 0)
+        {
+            entry->key = key;
+            table->count++;
+            return entry->state;
+        }
+        slot = (slot + 1) & (MP3_INSTANCE_TABLE_CAPACITY - 1);
+    }
+    return NULL;
+}
+
+// As mp3_GetInstanceState, for the space the current player is standing on.  From a landing or
+// passing event, that's the space the event is placed on.
+u8* mp3_GetCurrentSpaceInstanceState(int eventTag)
+{
+    struct Player *p = GetPlayerStruct(GetCurrentPlayerIndex());
+    return mp3_GetInstanceState(p->cur_chain_index, p->cur_space_index, eventTag);
+}
+
+// Visited spaces.
+// One bit per space for every player, set the first time they land there, plus a lap counter.
+// Good for bonus conditions like "explored the most of the board" or "most times around the board".
+// Run mp3_MarkVisitedSpace() once per move from an After Player Turn event, and mp3_CountLap() from a
+// passing and a landing event on the space a lap starts at (see the Visited Spaces Tracker event),
+// and the counts below are a few popcounts away.
+//
+// The sets live on the perm heap, and their address is kept in the instance table under
+// (chain 0xFF, space 0xFF, MP3_VISITED_EVENT_TAG), so they cost no board RAM of their own beyond
+// the instance table's.  Like the instance table, they're stamped with the game's seed and only
+// reused while it matches, so every game starts with new, empty sets.
+#define MP3_VISITED_MAGIC           0x56495354      // "VIST"
+#define MP3_VISITED_EVENT_TAG       0xFF
+#define MP3_VISITED_SPACE_BYTES     13              // 104 spaces.  Game Night has 97.
+
+struct mp3_VisitedSpaces {
+    u32 magic;                                      // MP3_VISITED_MAGIC
+    u32 seed;                                       // The board state header's seed for this game
+    u8 spaces[4][MP3_VISITED_SPACE_BYTES];          // Absolute space N is bit (N & 7) of byte (N >> 3)
+    u8 laps[4];
+    u8 lapTurn[4];                                  // current_turn the player's last lap was counted on
+}; // sizeof == 68
+
+// Returns this game's visited sets, allocating them on first use.  NULL if there's no instance table
+// entry for them (see mp3_GetInstanceState).
+struct mp3_VisitedSpaces* mp3_GetVisitedSpaces()
+{
+    u32 *address = (u32*)mp3_GetInstanceState(0xFF, 0xFF, MP3_VISITED_EVENT_TAG);
+    if(address == NULL)
+    {
+        return NULL;
+    }
+
+    int seed = mp3_GetCurrentBoardStateSeed();
+    struct mp3_VisitedSpaces *visited = (struct mp3_VisitedSpaces*)(*address);
+    if(mplib_IsRDRAMAddress(*address) && (visited->magic == MP3_VISITED_MAGIC) && (visited->seed == seed))
+    {
+        return visited;
+    }
+
+    visited = MallocPerm(sizeof(struct mp3_VisitedSpaces));
+    bzero(visited, sizeof(struct mp3_VisitedSpaces));
+    visited->magic = MP3_VISITED_MAGIC;
+    visited->seed = seed;
+    *address = (u32)visited;
+    return visited;
+}
+
+// Marks the space the player is standing on.  O(1) per move: one bit set.  Only landings count, not
+// spaces passed over.
+void mp3_MarkVisitedSpace(int playerIndex)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if((visited == NULL) || (p == NULL))
+    {
+        return;
+    }
+
+    int space = GetAbsSpaceIndexFromChainSpaceIndex(p->cur_chain_index, p->cur_space_index);
+    if((space >= 0) && (space < (MP3_VISITED_SPACE_BYTES * 8)))
+    {
+        visited->spaces[playerIndex][space >> 3] |= (1 << (space & 7));
+    }
+}
+
+// Counts a lap for the player, from an event on the space a lap starts at: the start space, or on
+// boards where the start space isn't part of the loop, the first space of the loop after it.  Place
+// the event there as both a passing and a landing event, so a lap counts whether the player goes
+// past the space or stops on it.  If both run on the same move, only the first counts: a player gets
+// at most one lap a turn.  Every player passes the space on their first move, so laps start at 1.
+void mp3_CountLap(int playerIndex)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    if((visited == NULL) || (visited->lapTurn[playerIndex] == D_800CD05B) || (visited->laps[playerIndex] == 255))
+    {
+        return;
+    }
+
+    visited->laps[playerIndex]++;
+    visited->lapTurn[playerIndex] = D_800CD05B;
+}
+
+// Counts the set bits in a word without a loop (the classic SWAR popcount).
+int mplib_PopCount32(u32 x)
+{
+    x = x - ((x >> 1) & 0x55555555);                    // Count bits in each pair
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);     // ...each nibble
+    x = (x + (x >> 4)) & 0x0F0F0F0F;                    // ...each byte
+    return (x * 0x01010101) >> 24;                      // Add the four bytes up in the top byte
+}
+
+int mp3_HasVisitedSpace(int playerIndex, int space)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    if((visited == NULL) || (space < 0) || (space >= (MP3_VISITED_SPACE_BYTES * 8)))
+    {
+        return 0;
+    }
+    return (visited->spaces[playerIndex][space >> 3] >> (space & 7)) & 1;
+}
+
+int mp3_GetLapCount(int playerIndex)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    return (visited == NULL) ? 0 : visited->laps[playerIndex];
+}
+
+// Counts the spaces visited by the players in playerMask (bit N = player N, at least one of them).
+// With matchAll 0 that's anyone in the mask (union), with matchAll 1 everyone in it (intersection).
+// The bytes are combined four at a time into a word, so it's four popcounts for the 13 bytes.
+int mp3_CountVisitedSpaces(int playerMask, int matchAll)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    int count = 0;
+    u32 word = 0;
+    int byte, i;
+    if(visited == NULL)
+    {
+        return 0;
+    }
+
+    for(byte = 0; byte < MP3_VISITED_SPACE_BYTES; byte++)
+    {
+        u32 bits = matchAll ? 0xFF : 0;
+        for(i = 0; i < 4; i++)
+        {
+            if(playerMask & (1 << i))
+            {
+                bits = matchAll ? (bits & visited->spaces[i][byte]) : (bits | visited->spaces[i][byte]);
+            }
+        }
+        word = (word << 8) | bits;
+        if(((byte & 3) == 3) || (byte == MP3_VISITED_SPACE_BYTES - 1))
+        {
+            count += mplib_PopCount32(word);
+            word = 0;
+        }
+    }
+    return count;
+}
+
+// Profiling.
+// Named markers around the phases of an event, for timing them on a real console or an emulator:
+//
+//      int phase = mp3_ProfileBegin("message build");
+//      char* question_msg = GetQuestionByNumber(index, &correctAnswer);
+//      mp3_ProfileEnd(phase);
+//
+// Each Begin/End pair adds the ticks of the R4300 Count register between them (osGetCount()) to a slot
+// named after the phase, which keeps the number of calls, the total and the slowest single call.  Count
+// runs at half the 93.75 MHz CPU clock, so a tick is 2 CPU cycles and a frame at 30 fps is 1562500 ticks.
+// Tools/event_harness.py answers osGetCount() with its own cycles / 2, so a profiled event gives the same
+// kind of numbers on the PC as on the console.
+//
+// The table lives on the perm heap, found through the instance table (so it needs the instance table's
+// board RAM fields, and a current board state header), is stamped with the game's seed like the
+// instance table, and every event on the board adds to the same one.  Place the "Profile Report"
+// debug event to show it.  Begin finds the slot before it reads Count and End reads Count first, so the
+// lookups aren't timed; the calls themselves add a few dozen cycles.  Phases can nest if their names differ.
+// Names are cut to 15 characters, and totals wrap after 2^32 ticks (about 90 seconds).
+#define MP3_PROFILE_MAGIC           0x50524F46      // "PROF"
+#define MP3_PROFILE_EVENT_TAG       0xFE
+#define MP3_PROFILE_SLOTS           8
+#define MP3_PROFILE_NAME_BYTES      16
+#define MP3_PROFILE_TICKS_PER_MS    46875           // Count ticks a millisecond
+
+u32 osGetCount(void);
+
+struct mp3_ProfileSlot {
+    char name[MP3_PROFILE_NAME_BYTES];      // The phase, 0-terminated
+    u32 start;                              // Count at the last mp3_ProfileBegin
+    u32 total;                              // Ticks between Begin and End, every call added up
+    u32 longest;                            // Ticks of the slowest call
+    u32 calls;
+}; // sizeof == 32
+
+struct mp3_ProfileTable {
+    u32 magic;                              // MP3_PROFILE_MAGIC
+    u32 seed;                               // The board state header's seed for this game
+    u32 count;                              // Slots in use
+    struct mp3_ProfileSlot slots[MP3_PROFILE_SLOTS];
+}; // sizeof == 268
+
+// To keep the markers in your code but out of the released event, paste these macros into your
+// Declarations section and #define MP3_PROFILE only while you're measuring:
+//
+//      #ifdef MP3_PROFILE
+//      #define mp3_ProfilePhaseBegin(phase, name)  int phase = mp3_ProfileBegin(name)
+//      #define mp3_ProfilePhaseEnd(phase)          mp3_ProfileEnd(phase)
+//      #else
+//      #define mp3_ProfilePhaseBegin(phase, name)
+//      #define mp3_ProfilePhaseEnd(phase)
+//      #endif
+
+// Returns this game's profile table, allocating it on first use.  NULL if there's no instance table
+// entry for it (see mp3_GetInstanceState).
+struct mp3_ProfileTable* mp3_GetProfileTable()
+{
+    u32 *address = (u32*)mp3_GetInstanceState(0xFF, 0xFF, MP3_PROFILE_EVENT_TAG);
+    if(address == NULL)
+    {
+        return NULL;
+    }
+
+    int seed = mp3_GetCurrentBoardStateSeed();
+    struct mp3_ProfileTable *table = (struct mp3_ProfileTable*)(*address);
+    if(mplib_IsRDRAMAddress(*address) && (table->magic == MP3_PROFILE_MAGIC) && (table->seed == seed))
+    {
+        return table;
+    }
+
+    table = MallocPerm(sizeof(struct mp3_ProfileTable));
+    bzero(table, sizeof(struct mp3_ProfileTable));
+    table->magic = MP3_PROFILE_MAGIC;
+    table->seed = seed;
+    *address = (u32)table;
+    return table;
+}
+
+// Starts timing a phase.  Returns the slot to pass to mp3_ProfileEnd, or -1 if every slot is taken
+// by other phases (mp3_ProfileEnd ignores -1).
+int mp3_ProfileBegin(char* name)
+{
+    struct mp3_ProfileTable *table = mp3_GetProfileTable();
+    int slot, i;
+    if(table == NULL)
+    {
+        return -1;
+    }
+
+    for(slot = 0; slot < table->count; slot++)
+    {
+        char *slotName = table->slots[slot].name;
+        for(i = 0; (i < MP3_PROFILE_NAME_BYTES - 1) && (slotName[i] == name[i]) && (name[i] != '\0'); i++);
+        if((i == MP3_PROFILE_NAME_BYTES - 1) || (slotName[i] == name[i]))
+        {
+            break;
+        }
+    }
+
+    if(slot == table->count)
+    {
+        if(slot >= MP3_PROFILE_SLOTS)
+        {
+            return -1;
+        }
+        for(i = 0; (i < MP3_PROFILE_NAME_BYTES - 1) && (name[i] != '\0'); i++)
+        {
+            table->slots[slot].name[i] = name[i];
+        }
+        table->count++;
+    }
+
+    table->slots[slot].start = osGetCount();
+    return slot;
+}
+
+// Stops timing the phase mp3_ProfileBegin returned this slot for.
+void mp3_ProfileEnd(int slot)
+{
+    u32 now = osGetCount();                 // First, so the table lookup isn't timed
+    struct mp3_ProfileTable *table = mp3_GetProfileTable();
+    if((table == NULL) || (slot < 0) || (slot >= table->count))
+    {
+        return;
+    }
+
+    struct mp3_ProfileSlot *phase = &table->slots[slot];
+    u32 ticks = now - phase->start;         // Unsigned, so it comes out right when Count wraps around
+    phase->total += ticks;
+    if(ticks > phase->longest)
+    {
+        phase->longest = ticks;
+    }
+    phase->calls++;
+}
+
+// Empties the table, to start measuring again.
+void mp3_ProfileReset()
+{
+    struct mp3_ProfileTable *table = mp3_GetProfileTable();
+    if(table != NULL)
+    {
+        bzero(table->slots, sizeof(table->slots));
+        table->count = 0;
+    }
+}
+
+// Converts Count ticks to microseconds without overflowing 32 bits.
+u32 mp3_ProfileTicksToMicroseconds(u32 ticks)
+{
+    return (ticks / MP3_PROFILE_TICKS_PER_MS) * 1000 + ((ticks % MP3_PROFILE_TICKS_PER_MS) * 1000) / MP3_PROFILE_TICKS_PER_MS;
+}
+
+// Shows a message box per phase with mp3_DebugMessageWithConfirmation, like:
+//      message build
+//      12 calls 4210 us
+//      longest 933 us
+// Microseconds read against frames: a frame at 30 fps is 33333 us.
+void mp3_ProfileShow()
+{
+    struct mp3_ProfileTable *table = mp3_GetProfileTable();
+    char message[80];                       // 15 name + 10 + 10 + 10 digits + the words: 69 with the 0
+    int slot;
+    if((table == NULL) || (table->count == 0))
+    {
+        mp3_DebugMessageWithConfirmation("No profiled phases yet");
+        return;
+    }
+
+    for(slot = 0; slot < table->count; slot++)
+    {
+        struct mp3_ProfileSlot *phase = &table->slots[slot];
+        bzero(message, sizeof(message));
+        mplib_strcpy(message, phase->name);
+        mplib_strncat(message, "\x0A");                                         // Newline
+        mplib_AppendUnsigned(message, phase->calls);
+        mplib_strncat(message, " calls ");
+        mplib_AppendUnsigned(message, mp3_ProfileTicksToMicroseconds(phase->total));
+        mplib_strncat(message, " us");
+        mplib_strncat(message, "\x0A");                                         // Newline
+        mplib_strncat(message, "longest ");
+        mplib_AppendUnsigned(message, mp3_ProfileTicksToMicroseconds(phase->longest));
+        mplib_strncat(message, " us");
+        mp3_DebugMessageWithConfirmation(message);
+    }
+}
+
+// Space distances.
+// How many dice steps it takes to get from one space to another, read out of the DISTANCE_TABLE that
+// Tools/distance_table.py generates for your board.  Paste its DISTANCE TABLE markers into your event
+// (above these functions) and run the tool with --write.  Every lookup is one load, so CPU logic can
+// weigh "how far am I from the star" without walking the board.
+//
+// A distance is the smallest dice roll that gets a player onto or past a space going forwards, or
+// DISTANCE_UNREACHABLE if they can't get there.  Spaces are absolute indices, the same numbering as
+// the board file; GetAbsSpaceIndexFromChainSpaceIndex() turns a chain and space into one.
+int mp3_GetSpaceDistance(int fromSpace, int toSpace)
+{
+    if((fromSpace < 0) || (fromSpace >= DISTANCE_TABLE_SPACE_COUNT) || (toSpace < 0) || (toSpace >= DISTANCE_TABLE_SPACE_COUNT))
+    {
+        return DISTANCE_UNREACHABLE;
+    }
+
+    int entry = (fromSpace * DISTANCE_TABLE_SPACE_COUNT) + toSpace;
+#if DISTANCE_TABLE_BITS == 8
+    return DISTANCE_TABLE[entry];
+#else
+    return mplib_GetPackedField((u8*)DISTANCE_TABLE, entry, DISTANCE_TABLE_BITS);
+#endif
+}
+
+int mp3_GetChainSpaceDistance(int fromChain, int fromSpace, int toChain, int toSpace)
+{
+    return mp3_GetSpaceDistance(GetAbsSpaceIndexFromChainSpaceIndex(fromChain, fromSpace),
+                                GetAbsSpaceIndexFromChainSpaceIndex(toChain, toSpace));
+}
+
+int mp3_GetPlayerDistanceToSpace(int playerIndex, int space)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    return mp3_GetSpaceDistance(GetAbsSpaceIndexFromChainSpaceIndex(p->cur_chain_index, p->cur_space_index), space);
+}
+
+// Returns how far the player is from the closest space the star can appear on, and which one it is
+// (an index into STAR_CANDIDATES) through candidateIndex, if that isn't NULL.  Ties go to the
+// earlier candidate.  DISTANCE_UNREACHABLE (and candidate -1) if the board has none ahead.
+int mp3_GetPlayerDistanceToNearestStarCandidate(int playerIndex, int *candidateIndex)
+{
+    struct Player *p = GetPlayerStruct(playerIndex);
+    int from = GetAbsSpaceIndexFromChainSpaceIndex(p->cur_chain_index, p->cur_space_index);
+    int best = DISTANCE_UNREACHABLE;
+    int bestIndex = -1;
+    int i;
+
+    for(i = 0; i < STAR_CANDIDATE_COUNT; i++)
+    {
+        int distance = mp3_GetSpaceDistance(from, STAR_CANDIDATES[i]);
+        if(distance < best)
+        {
+            best = distance;
+            bestIndex = i;
+        }
+    }
+
+    if(candidateIndex != NULL)
+    {
+        *candidateIndex = bestIndex;
+    }
+    return best;
+}
+
+// Save/restore overlay for game globals an event patches for a while.
+// Some events change a game value for a few turns and then put it back (Reduce Hidden Blocks moves
+// the hidden blocks out of reach, for example).  Instead of hand-writing a Store/Restore pair for every
+// global, register each one with an overlay and let it remember the real values:
+//
+//      struct mp3_Overlay overlay;
+//      mp3_OverlayInit(&overlay, HIDDEN_BLOCK_OVERLAY);       // A BOARD_RAM_BYTES block, or perm heap memory
+//      int itemBlock = mp3_OverlayRegister(&overlay, &D_800CC4E5, 1);
+//      ...
+//      mp3_OverlayPatch(&overlay, itemBlock, 0);                // Saves the real value the first time
+//      ...
+//      mp3_OverlayRestore(&overlay);                            // Puts back everything that was patched
+//
+// The registrations are rebuilt every time the event runs (it's just a few stores), but the storage
+// has to survive between runs: its first byte is a dirty mask with bit N set while entry N is patched,
+// and the saved values follow, packed back to back.  So it needs 1 + (sum of the widths) bytes.
+// A fresh block of zeroes means nothing is patched.  The Board State Header event guarantees that at
+// the start of each game; on boards without it, bzero() the storage on the first run of a game yourself
+// (Reduce Hidden Blocks By Percent does it on the first roll).
+//
+// Patching an entry that's already patched to the same value writes nothing, and restoring checks
+// the dirty mask first, so an event that runs every roll does almost no work when nothing changed.
+#define MP3_OVERLAY_MAX_ENTRIES 8           // One bit each in the dirty mask byte
+
+struct mp3_OverlayEntry {
+    u8 *address;                            // The game global
+    u8 width;                               // 1, 2, or 4 bytes
+    u8 offset;                              // Where its saved value starts in the storage, after the mask byte
+};
+
+struct mp3_Overlay {
+    u8 *storage;                            // Dirty mask byte, then the saved values
+    int count;
+    int savedBytes;
+    struct mp3_OverlayEntry entries[MP3_OVERLAY_MAX_ENTRIES];
+};
+
+void mp3_OverlayInit(struct mp3_Overlay *overlay, u8 *storage)
+{
+    overlay->storage = storage;
+    overlay->count = 0;
+    overlay->savedBytes = 0;
+}
+
+// Registers a global and returns its entry index, or -1 if the overlay is full.
+// Register in the same order every time the event runs, so each entry finds its saved value again.
+int mp3_OverlayRegister(struct mp3_Overlay *overlay, void *address, int width)
+{
+    if(overlay->count >= MP3_OVERLAY_MAX_ENTRIES)
+    {
+        return -1;
+    }
+
+    struct mp3_OverlayEntry *entry = &overlay->entries[overlay->count];
+    entry->address = (u8*)address;
+    entry->width = width;
+    entry->offset = 1 + overlay->savedBytes;
+    overlay->savedBytes += width;
+    return overlay->count++;
+}
+
+int mp3_OverlayIsPatched(struct mp3_Overlay *overlay, int index)
+{
+    return (overlay->storage[0] >> index) & 1;
+}
+
+// Writes a value to the entry's global, saving the real value first if it isn't already patched.
+void mp3_OverlayPatch(struct mp3_Overlay *overlay, int index, u32 value)
+{
+    struct mp3_OverlayEntry *entry = &overlay->entries[index];
+    u8 *saved = &overlay->storage[entry->offset];
+    int i;
+
+    if(!mp3_OverlayIsPatched(overlay, index))
+    {
+        bcopy(entry->address, saved, entry->width);
+        overlay->storage[0] |= (1 << index);
+    }
+
+    // The N64 is big-endian, so the value's low bytes go at the end.
+    for(i = entry->width - 1; i >= 0; i--)
+    {
+        if(entry->address[i] != (u8)value)
+        {
+            entry->address[i] = (u8)value;
+        }
+        value >>= 8;
+    }
+}
+
+// Puts the entry's real value back, if it's patched.
+void mp3_OverlayRestoreEntry(struct mp3_Overlay *overlay, int index)
+{
+    if(!mp3_OverlayIsPatched(overlay, index))
+    {
+        return;
+    }
+
+    struct mp3_OverlayEntry *entry = &overlay->entries[index];
+    bcopy(&overlay->storage[entry->offset], entry->address, entry->width);
+    overlay->storage[0] &= ~(1 << index);
+}
+
+// Puts back every patched global.  Returns right away when nothing is patched.
+void mp3_OverlayRestore(struct mp3_Overlay *overlay)
+{
+    int dirtyMask = overlay->storage[0];
+    int index = 0;
+    while(dirtyMask != 0)
+    {
+        if(dirtyMask & 1)
+        {
+            mp3_OverlayRestoreEntry(overlay, index);
+        }
+        dirtyMask >>= 1;
+        index++;
+    }
+}
+
 // Long-form implementation from:
 // https://www.techiedelight.com/implement-strcpy-function-c/
 //
@@ -371,6 +1304,22 @@ char* mplib_strncat(char* destination, const char* source)
     return destination;
 }
 
+// Appends a number in decimal (up to 10 digits) to the end of destination, like mplib_strncat.
+char* mplib_AppendUnsigned(char* destination, u32 value)
+{
+    char digits[11];
+    int i = 10;
+    digits[i] = '\0';
+    do
+    {
+        i--;
+        digits[i] = '0' + (value % 10);
+        value /= 10;
+    } while(value != 0);
+
+    return mplib_strncat(destination, &digits[i]);
+}
+
 // Returns the smaller of two numbers.  Ties go to the first argument.
 int mplib_min(int a1, int a2)
 {
@@ -442,6 +1391,66 @@ void mp3_ReloadCurrentSceneWithTransition(int transitionType)
 	// 11 = Generic
 	// 12 = Boo
 
+// Board RAM bitfield accessors.
+// Board RAM is scarce, so small values (flags, player indices, counters) are packed into
+// shared bytes instead of taking a whole byte each.  A field is (byte, shift, width): the board
+// RAM byte it lives in, the lowest bit it uses, and how many bits it takes.  Tools/board_ram_alloc.py
+// hands these out as NAME_BYTE / NAME_SHIFT / NAME_WIDTH defines, so you can use the NAME-only forms.
+//
+// These are macros rather than functions so that, with constant shift and width, each read compiles
+// to one load/shift/mask and each write to one load/insert/store.  Unlike the functions in this
+// library, macros must be pasted ABOVE the code that uses them - put them in your Declarations section.
+//
+//      if(mplib_GetField(TURN_ORDER_SWAP_PENDING) == 1) { ... }
+//      mplib_SetField(TURN_ORDER_FIRST_PLAYER, firstTargetPlayerIndex);
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_SetBits(byte, shift, width, value)    ((byte) = ((byte) & ~(mplib_BitMask(width) << (shift))) \
+                                                        | (((value) & mplib_BitMask(width)) << (shift)))
+
+// Signed read, for fields that use -1 (or another negative number) as a sentinel.  The top bit of
+// the field is the sign bit, so a 4-bit field holds -8 to 7.  Write signed values with mplib_SetBits.
+#define mplib_GetSignedBits(byte, shift, width)     ((mplib_GetBits(byte, shift, width) ^ (1 << ((width) - 1))) \
+                                                        - (1 << ((width) - 1)))
+
+// NAME-only forms that pick up the defines generated by Tools/board_ram_alloc.py.
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_GetSignedField(NAME)                  mplib_GetSignedBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_SetField(NAME, value)                 mplib_SetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH, value)
+
+// Packed arrays: the same small field repeated back to back in a run of bytes, like one entry per
+// Character Door in a BOARD_RAM_BYTES block.  Entry N of a W-bit array starts at bit N*W, counting
+// from bit 0 of the first byte, so 8 doors of 6 bits fit in 6 bytes.  An entry can straddle two
+// bytes; W can be 1-8.
+int mplib_GetPackedField(u8 *block, int index, int width)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+
+    int window = bytes[0];
+    if(shift + width > 8)
+    {
+        window |= bytes[1] << 8;
+    }
+    return (window >> shift) & mplib_BitMask(width);
+}
+
+void mplib_SetPackedField(u8 *block, int index, int width, int value)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+    int mask = mplib_BitMask(width) << shift;
+    int bits = (value << shift) & mask;
+
+    bytes[0] = (bytes[0] & ~mask) | bits;
+    if(shift + width > 8)
+    {
+        bytes[1] = (bytes[1] & ~(mask >> 8)) | (bits >> 8);
+    }
+}
+
 // Takes an integer and two bit positions, and swaps the bits at those positions, returning the bit-swapped integer.
 // For mario party values, you you'll want to assign the return value to the value you pulled it from. For instance, if
 // you wanted to swap cursed mushroom bits in Mario Party 3, you'd do something like:
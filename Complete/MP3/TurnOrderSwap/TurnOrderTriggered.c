@@ -1,13 +1,17 @@
 // NAME: Turn Order Swap Triggered
 // GAMES: MP3_USA
 // EXECUTION: Direct
+// BOARD_RAM_GROUP: Turn Order Swap
+// BOARD_RAM: TURN_ORDER_SWAP_PENDING|1
+// BOARD_RAM: TURN_ORDER_FIRST_PLAYER|2
+// BOARD_RAM: TURN_ORDER_SECOND_PLAYER|2
 
 
 //***************************************************************************//
 //******************** Version Info! ****************************************//
 //***************************************************************************//
 //
-// This is version: 1.0
+// This is version: 1.1
 //
 // There may be an update available at:
 // https://github.com/c-kennelly/mario-party-custom-events
@@ -17,12 +21,14 @@
 //***************************************************************************//
 //******************** BOARD RAM WARNING ************************************//
 //***************************************************************************//
-// This board uses the following addresses (board RAM)
-//              D_800CD0A3;   //board_ram12
-//              D_800CD0A4;   //board_ram13
-//              D_800CD0A5;   //board_ram14
+// This event packs its board RAM into 5 bits, declared with the BOARD_RAM lines in the header:
+//              TURN_ORDER_SWAP_PENDING     1 bit   - a swap is waiting for the passive event
+//              TURN_ORDER_FIRST_PLAYER     2 bits  - player index 0-3
+//              TURN_ORDER_SECOND_PLAYER    2 bits  - player index 0-3
 //
-// If any other events on your board use these values, you will get unexpected behavior! 
+// Every Turn Order Swap event must use the same slots, so they share the "Turn Order Swap"
+// BOARD_RAM_GROUP.  Run "python3 Tools/board_ram_alloc.py your_board.json --write" to place the
+// slots around the other events on your board; it will tell you if anything clashes.
 //
 // This event uses board RAM to keep track of the players who will be swapping turn orders and
 // allows a passive after-turn event to actually make the swaps.  This neatly handles edge cases with
@@ -58,6 +64,7 @@
 //***************************************************************************//
 //***********************     Changelist      *******************************//
 //***************************************************************************//
+//   Version 1.1 - Board RAM packed into 5 bits and placed by Tools/board_ram_alloc.py.
 //   Version 1.0 - First version of the event!
 
 
@@ -71,10 +78,31 @@
 // For more exploration: http://n64devkit.square7.ch/header/
 #include "ultra64.h"
 
-// Event parameter can disable this:
-extern u8 D_800CD0A3;	//IsInitialized - 1 == yes.
-extern u8 D_800CD0A4;	//firstPlayerIndex
-extern u8 D_800CD0A5;	//secondPlayerIndex
+// Board RAM slots, filled in by Tools/board_ram_alloc.py --write:
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Game Night" board.
+// Re-run the tool instead of editing these by hand.  Event: Turn Order Swap Triggered
+#define BOARD_RAM_LAYOUT_VERSION                 3
+extern u8 D_800CD0A3;
+extern u8 D_800CD0A4;
+#define TURN_ORDER_SWAP_PENDING_BYTE             D_800CD0A4
+#define TURN_ORDER_SWAP_PENDING_SHIFT            2
+#define TURN_ORDER_SWAP_PENDING_WIDTH            1
+#define TURN_ORDER_FIRST_PLAYER_BYTE             D_800CD0A3
+#define TURN_ORDER_FIRST_PLAYER_SHIFT            6
+#define TURN_ORDER_FIRST_PLAYER_WIDTH            2
+#define TURN_ORDER_SECOND_PLAYER_BYTE            D_800CD0A4
+#define TURN_ORDER_SECOND_PLAYER_SHIFT           0
+#define TURN_ORDER_SECOND_PLAYER_WIDTH           2
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_SetBits(byte, shift, width, value)    ((byte) = ((byte) & ~(mplib_BitMask(width) << (shift))) \
+                                                        | (((value) & mplib_BitMask(width)) << (shift)))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_SetField(NAME, value)                 mplib_SetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH, value)
 
 // The Player struct for Mario Party 3, used for player manipulation.
 // Reference wiki article can be found here:
@@ -132,7 +160,7 @@ void main()
 	int currentPlayerIndex = GetCurrentPlayerIndex();
 
 	// Someone already used the event this turn, so return early.
-	if(D_800CD0A3 == 1)
+	if(mplib_GetField(TURN_ORDER_SWAP_PENDING) == 1)
 	{
 		PlayMessageForTargetAlreadyChosen(currentPlayerIndex);
 		return;
@@ -151,9 +179,9 @@ void main()
 	int secondTargetPlayerIndex = AskPlayerToSelectSecondTarget(firstTargetPlayerIndex, currentPlayerIndex);
 
 	// Setup boardRAM for the passive event to handle the swap, and confirm
-	D_800CD0A3 = 1;
-	D_800CD0A4 = firstTargetPlayerIndex;
-	D_800CD0A5 = secondTargetPlayerIndex;
+	mplib_SetField(TURN_ORDER_SWAP_PENDING, 1);
+	mplib_SetField(TURN_ORDER_FIRST_PLAYER, firstTargetPlayerIndex);
+	mplib_SetField(TURN_ORDER_SECOND_PLAYER, secondTargetPlayerIndex);
 	PlayMessageConfirmingTargetSelection(firstTargetPlayerIndex, secondTargetPlayerIndex);
 }
 
@@ -608,7 +636,7 @@ int mp3_PickARandomNumberBetween0AndN(int n)
     int result = GetRandomByte();                   //Get a random number by picking a random byte.
     
     int randMax = 255;                              // 255 is the maximum value of a byte.
-    int randExcess = (randMax % n) + 1;             // Caluclate the biased remainder.  1/256 edge case when (randMax == n) but the result is just some wasted cycles, so acceptable.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
     int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
     while (result > randLimit)                      // Reject any random bytes with values above randLimit...
     {
@@ -638,7 +666,7 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
     }
     else
     {
-        int randValue = mp3_PickARandomNumberBetween0AndN(99);
+        int randValue = mp3_PickARandomNumberBetween0AndN(100);
         if (randValue < percentChanceOfTrue)
         {
             return 1;
@@ -715,9 +743,9 @@ int mp3_IsPlayerCertainCharacter(int playerIndex, enum mp3_Character character)
 
 char* mp3_GetCharacterNameStringFromPlayerIndex(int playerIndex)
 {
-    char* characterName = func_80035934(8);         // malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
+    char* characterName = func_80035934(16);        // malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
                                                     // transition, such as a minigame.  Or, you can call free() with func_80035958(ptr)
-    bzero(characterName, 8);                        // Zero out the memory allocated above so we don't get unexpected behavior.
+    bzero(characterName, 16);                       // Zero out the memory allocated above so we don't get unexpected behavior.
     
     int characterInt = -1;     
 
@@ -0,0 +1,221 @@
+// NAME: Board State Header
+// GAMES: MP3_USA
+// EXECUTION: Direct
+// BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+// BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+
+
+//***************************************************************************//
+//******************** Version Info! ****************************************//
+//***************************************************************************//
+//
+// This is version: 1.2
+//
+// There may be an update available at:
+// https://github.com/c-kennelly/mario-party-custom-events
+// You can also report a bug as an issue (and maybe a PR that fixes it?)
+
+
+//***************************************************************************//
+//******************** BOARD RAM WARNING ************************************//
+//***************************************************************************//
+// This event declares 14 bits of board RAM with the BOARD_RAM lines in the header:
+//              MP3LIB_BOARD_STATE_STAMP    6 bits  - layout version, per-game seed
+//              MP3LIB_BOARD_STATE_CHECK    8 bits  - check byte for the turn it was stamped on
+//
+// They're mp3lib fields, so events that only trust their state while the header is current (like
+// mp3lib's instance table) declare them too, and share them with this event.
+//
+// This file is a template, and isn't placed on any board.  Every board gets its own copy, named
+// "<board name> Board State Header", with that board's slots filled in.  Another board's bytes may
+// belong to one of your events, and stamping the header there would corrupt it.  Write your board's
+// copy with:
+//
+//      python3 Tools/board_ram_alloc.py your_board.json --header-copy YourBoard-BoardStateHeader.c --write
+//
+// and place the copy on your board.  Re-run the tool (and re-paste the copy) whenever the board's
+// events change, so BOARD_RAM_LAYOUT_VERSION stays in step with the rest of the board.  With --check
+// instead of --write, the tool fails if the copy isn't the one it would write.
+//
+// IMPORTANT: when this event decides board RAM is stale, it clears ALL of board RAM
+// (board_ram1 - board_ram17), not just its own byte.  That's the point of the event.
+
+
+//***************************************************************************//
+//*********************** Description ***************************************//
+//***************************************************************************//
+// Board RAM isn't cleared when a new game starts, so events that keep state in it have had to
+// guess whether a byte was set this game or is left over from the last one.  Every event guessed
+// differently (the quiz checks if its step value is 0, Reduce Hidden Blocks checks the item block
+// space), and a wrong guess means acting on the previous game's values.
+//
+// This event answers the question once for the whole board.  Place your board's copy of it ONCE as
+// a "Before Turn" board event.  At the start of every turn it checks the header (see the "Board state header"
+// section of mp3lib for the layout):
+//
+//  - If the header was stamped by this game last turn (or already this turn, e.g. after a scene
+//    reload), board RAM is trusted and the header is re-stamped for this turn.
+//  - Otherwise - the first turn of a new game, a save from an older version of the board, or a
+//    byte that got stomped - every byte of board RAM is cleared and a fresh header is stamped.
+//
+// With this event on the board, every other event can assume its fields read 0 at the start
+// of a game, and skip its own "is this the first time I've run?" heuristics.
+//
+// Finally, this file is commented to make it as easy as possible for
+// non-programmers to edit and beginners to pull code samples, so I've
+// leaned on the verbose side for comments.  If you've a working knowledge
+// of C, feel free to just jump to main() and see what's going on.
+
+
+//***************************************************************************//
+//***********************     Changelist      *******************************//
+//***************************************************************************//
+//   Version 1.2 - This file is a template.  Tools/board_ram_alloc.py --header-copy writes each board's copy.
+//   Version 1.1 - The header is 14 bits, with a whole check byte and a seed that's never 0, so stray
+//                 bytes from another game (or all zeros) are no longer taken for this game's header.
+//   Version 1.0 - First version of the event!
+
+
+//***************************************************************************//
+//*************************** Declarations **********************************//
+//***************************************************************************//
+
+// Header file: http://n64devkit.square7.ch/header/ultra64.htm
+// Ultratypes: http://n64devkit.square7.ch/header/ultratypes.htm
+// For more exploration: http://n64devkit.square7.ch/header/
+#include "ultra64.h"
+
+extern s8 D_800CD05B;       // current_turn from the mp3 sym table.  Starts at 1.
+
+// Board RAM slots, filled in for each board's copy by Tools/board_ram_alloc.py --header-copy:
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Left empty in the template.
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_SetBits(byte, shift, width, value)    ((byte) = ((byte) & ~(mplib_BitMask(width) << (shift))) \
+                                                        | (((value) & mplib_BitMask(width)) << (shift)))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_SetField(NAME, value)                 mplib_SetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH, value)
+
+// Board state header layout, from mp3lib.
+#define MP3_BOARD_STATE_VERSION_SHIFT   4
+#define MP3_BOARD_STATE_SEED_MASK       0x0F
+
+
+//***************************************************************************//
+//*************************** Event Logic ************************************//
+//***************************************************************************//
+
+//This event is intended to run on Before Turn timing, once per turn.
+void main()
+{
+    int turn = D_800CD05B;
+    int stamp = mplib_GetField(MP3LIB_BOARD_STATE_STAMP);
+    int seed;
+
+    if(mp3_IsBoardStateHeaderCurrent(stamp, mplib_GetField(MP3LIB_BOARD_STATE_CHECK), BOARD_RAM_LAYOUT_VERSION, turn))
+    {
+        // Board RAM belongs to this game.  Keep the seed and move the check byte forward to this turn.
+        seed = mp3_GetBoardStateSeed(stamp);
+    }
+    else
+    {
+        // New game (or board RAM we can't trust).  Start everyone from 0, with a seed of 1-15.
+        mp3_ClearBoardRAM();
+        seed = 1 + mp3_PickARandomNumberBetween0AndN(15);
+    }
+
+    mplib_SetField(MP3LIB_BOARD_STATE_STAMP, mp3_MakeBoardStateStamp(BOARD_RAM_LAYOUT_VERSION, seed));
+    mplib_SetField(MP3LIB_BOARD_STATE_CHECK, mp3_BoardStateCheck(BOARD_RAM_LAYOUT_VERSION, seed, turn));
+}
+
+
+//***************************************************************************//
+//***************************************************************************//
+//****************************                  *****************************//
+//*************************      mp3lib v1.0       **************************//
+//****************************                  *****************************//
+//***************************************************************************//
+//***************************************************************************//
+//***      Some helper functions to make up for lack of stdlib.io; and    ***//
+//***     to hide the complexity of some Mario Party-specific functions   ***//
+//***************************************************************************//
+//***************************************************************************//
+// NOTE - this instance of mp3lib is pared down just to the functions used in this event
+//
+// Get the latest version or submit changes at:
+// https://github.com/C-Kennelly/mario-party-custom-events
+//***************************************************************************//
+
+// Picks a random number between 0 and N, using rejection sampling to avoid modulo bias.
+// Don't use this!!! -->  { return GetRandomByte() % n; } or you may bias your random generation!
+// https://zuttobenkyou.wordpress.com/2012/10/18/generating-random-numbers-without-modulo-bias/
+//
+// IMPORTANT.  Maximum random number we could generate here would be 255 (max value of a byte).
+int mp3_PickARandomNumberBetween0AndN(int n)
+{
+    int result = GetRandomByte();                   //Get a random number by picking a random byte.
+    
+    int randMax = 255;                              // 255 is the maximum value of a byte.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
+    int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
+    while (result > randLimit)                      // Reject any random bytes with values above randLimit...
+    {
+        result = GetRandomByte();                   // and roll again by selecting a new byte.
+    }    
+
+    return result % n;                              //Since we rejected the excess samples, we've guaranteed an unbiased result.
+}
+
+// Turn 1 always gets the base value for the version and seed, and every later turn gets one of the
+// other 255 values.  So a header stamped on any later turn of any game can never pass for a turn 1 header.
+int mp3_BoardStateCheck(int layoutVersion, int seed, int turn)
+{
+    int base = ((seed * 0x9D) + (layoutVersion * 0x3B)) & 0xFF;
+    if(turn <= 1)
+    {
+        return base;
+    }
+    return base ^ (1 + ((turn - 2) % 255));
+}
+
+u8 mp3_MakeBoardStateStamp(int layoutVersion, int seed)
+{
+    return ((layoutVersion & 3) << MP3_BOARD_STATE_VERSION_SHIFT) | (seed & MP3_BOARD_STATE_SEED_MASK);
+}
+
+int mp3_GetBoardStateSeed(u8 stamp)
+{
+    return stamp & MP3_BOARD_STATE_SEED_MASK;
+}
+
+// Returns 1 if the header was stamped by this game on this turn or the one before it.
+// On turn 1 only a turn 1 stamp counts, which is what catches a previous game's leftovers.
+int mp3_IsBoardStateHeaderCurrent(u8 stamp, u8 check, int layoutVersion, int turn)
+{
+    int seed = mp3_GetBoardStateSeed(stamp);
+    if((seed == 0) || (((stamp >> MP3_BOARD_STATE_VERSION_SHIFT) & 3) != (layoutVersion & 3)))
+    {
+        return 0;
+    }
+
+    if(check == mp3_BoardStateCheck(layoutVersion, seed, turn))
+    {
+        return 1;   // Already stamped this turn, e.g. the scene was reloaded.
+    }
+    return (turn > 1) && (check == mp3_BoardStateCheck(layoutVersion, seed, turn - 1));
+}
+
+// board_ram1.  Declared like the generated slot blocks declare it (a single u8) so the two don't
+// clash, and the rest of board RAM is reached through its address.  Not a claim on any one byte.
+extern u8 D_800CD098;
+#define MP3_BOARD_RAM_BYTES 17
+
+// Zeroes every byte of board RAM (board_ram1 - board_ram17).
+void mp3_ClearBoardRAM()
+{
+    bzero(&D_800CD098, MP3_BOARD_RAM_BYTES);
+}
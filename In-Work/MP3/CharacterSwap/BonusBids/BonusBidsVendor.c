@@ -0,0 +1,528 @@
+// NAME: Bonus Bids Vendor
+// GAMES: MP3_USA
+// EXECUTION: Direct
+// PARAM: Number|VENDOR|0|3|0
+// PARAM: Number|LEADER_BONUS|0|99|10
+// BOARD_RAM_GROUP: Bonus Bids
+// BOARD_RAM_BYTES: BONUS_BIDS_TALLIES|8
+// BOARD_RAM_BYTES: BONUS_BIDS_VENDORS|1
+
+// Development defines for VS Code
+#ifndef VENDOR
+    #define VENDOR 0  // 0=Fortune Guy, 1=Misfortune Guy, 2=Money Guy, 3=Board-Specific
+#endif
+
+#ifndef LEADER_BONUS
+    #define LEADER_BONUS 10
+#endif
+
+//***************************************************************************//
+//******************** Version Info! ****************************************//
+//***************************************************************************//
+// Version: 1.0 - Leader bonus and locking in a condition
+// Repository: https://github.com/c-kennelly/mario-party-custom-events
+//
+// Changelist:
+//   Version 1.0 - First version of the event!
+
+//***************************************************************************//
+//******************** BOARD RAM WARNING ************************************//
+//***************************************************************************//
+// Bonus Bids Passive and Bonus Bids Vendor share the "Bonus Bids" BOARD_RAM_GROUP:
+//              BONUS_BIDS_TALLIES          8 bytes - swaps, doors and right quiz answers for each player
+//              BONUS_BIDS_VENDORS          1 byte  - which condition each vendor is locked on
+//
+// Run "python3 Tools/board_ram_alloc.py your_board.json --write" to place them around the other events.
+// Everything needs to start at 0, so put the "Board State Header" event on the board too.
+
+//***************************************************************************//
+//*********************** Description ***************************************//
+//***************************************************************************//
+// A passing event that sells the condition for one end of game Bonus Star (see Spec.txt).
+// Place one of each VENDOR on the board, and Bonus Bids Passive to award the stars.
+//
+//  0 - Fortune Guy:    the most Blue Spaces, the fewest Blue Spaces, the most Item Spaces
+//  1 - Misfortune Guy: the most Red Spaces, the fewest Red Spaces, the most Bowser Spaces
+//  2 - Money Guy:      the most Game Guy Spaces, the most Bank Spaces, the most Battle Spaces
+//  3 - Board-Specific: the most character swaps, the most Character Doors, the most right quiz answers
+//
+// Until someone pays, a vendor gives its star for its first condition.  Passing players may pay to
+// pick the condition, and once paid it's locked for the rest of the game.  The fee goes up with every
+// vendor that's already locked (10, 15, 20, then 30 coins) so it pays to commit early.
+//
+// A player passing while they're the only one leading the vendor's condition gets LEADER_BONUS coins,
+// which also tells everyone who's winning that star.
+
+#include "ultra64.h"
+
+// Player struct definition for reference
+// Reference wiki article can be found here:
+// https://github.com/PartyPlanner64/PartyPlanner64/wiki/Player-Structs
+struct Player {
+    s8 unk0;
+    s8 cpu_difficulty;
+    s8 controller;
+    u8 character;
+    u8 flags;               // Miscellaneous flags. "1" is CPU player
+    s8 pad0[5];             // Skip undocumented offset 5-9
+    s16 coins;              // Offset 10: Current coin count.
+    s16 minigame_coins;     // Offset 12: Coins obtained during a Mini-Game.
+    s8 stars;               // Offset 14
+    
+    u8 cur_chain_index;     // Offset 15
+    u8 cur_space_index;     // Offset 16
+    u8 next_chain_index;    // Offset 17
+    u8 next_space_index;    // Offset 18
+    u8 unk1_chain_index;    // Offset 19
+    u8 unk1_space_index;    // Offset 20
+    u8 reverse_chain_index; // Offset 21
+    u8 reverse_space_index; // Offset 22
+
+    u8 flags2;              // Offset 23
+    u8 items[3];            // Offset 24
+    u8 bowser_suit_flag;    // Offset 27
+    u8 turn_color_status;   // Offset 28
+
+    s8 pad1[7];             // Offsets: 29 - 35
+
+    void *obj;              // Offset 36:  struct object pointer
+    s16 minigame_star;      // Offset 40
+    s16 coin_star;          // Offset 42
+    s8 happening_space_count; // Offset 44
+    s8 red_space_count;     
+    s8 blue_space_count;
+    s8 chance_space_count;
+    s8 bowser_space_count;  // Offset 48
+    s8 battle_space_count;
+    s8 item_space_count;
+    s8 bank_space_count;
+    s8 game_guy_space_count; //Offset  52
+
+    char unk_35[3]; 		//likely padding
+}; // sizeof == 56
+
+// BoardRAM for the tallies and vendor choices, packed by Tools/board_ram_alloc.py --write.
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Character Swap" board.
+// Re-run the tool instead of editing these by hand.  Event: Bonus Bids Vendor
+#define BOARD_RAM_LAYOUT_VERSION                 1
+extern u8 D_800CD098;
+extern u8 D_800CD0A6;
+#define BONUS_BIDS_TALLIES                       (&D_800CD098)
+#define BONUS_BIDS_TALLIES_SIZE                  8
+#define BONUS_BIDS_VENDORS                       (&D_800CD0A6)
+#define BONUS_BIDS_VENDORS_SIZE                  1
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+
+extern s8 D_800CD05A;   // total_turns from the mp3 sym table
+extern s8 D_800CD05B;   // current_turn from the mp3 sym table.  Starts at 1.
+
+// Bonus Bids engine - the same in Bonus Bids Passive and Bonus Bids Vendor, keep them in step.
+//
+// Conditions are numbered (vendor * 3) + choice, so each vendor's three choices sit side by side.
+#define VENDOR_FORTUNE          0   // Plumbers
+#define VENDOR_MISFORTUNE       1   // Villains
+#define VENDOR_MONEY            2   // Princesses
+#define VENDOR_BOARD            3   // Animals
+#define VENDOR_COUNT            4
+#define CHOICES_PER_VENDOR      3
+
+#define CONDITION_MOST_BLUE         0
+#define CONDITION_LEAST_BLUE        1
+#define CONDITION_MOST_ITEM         2
+#define CONDITION_MOST_RED          3
+#define CONDITION_LEAST_RED         4
+#define CONDITION_MOST_BOWSER       5
+#define CONDITION_MOST_GAME_GUY     6
+#define CONDITION_MOST_BANK         7
+#define CONDITION_MOST_BATTLE       8
+#define CONDITION_MOST_SWAPS        9
+#define CONDITION_MOST_DOORS        10
+#define CONDITION_MOST_QUIZ         11
+
+// Tallies the Player struct doesn't keep for us.  The events that count them add to them when they
+// succeed: Swap Character on a swap, Character Door on a pass and the quiz on a right answer.
+#define TALLY_SWAPS             0
+#define TALLY_DOORS             1
+#define TALLY_QUIZ              2
+#define TALLY_COUNT             3
+
+// BONUS_BIDS_TALLIES: 3 tallies x 4 players x 5 bits = 60 bits, entry (tally * 4) + player.
+// Counters stop at 31, which is more swaps or doors than anyone manages in a game.
+#define TALLY_BITS              5
+#define TALLY_MAX               31
+
+// BONUS_BIDS_VENDORS: 2 bits per vendor.  0 = nobody has paid yet (the vendor uses its first choice),
+// 1-3 = locked in on choice 0-2 for the rest of the game.
+#define VENDOR_STATE_BITS       2
+
+// Same portrait as the other CharacterSwap events
+#define CHARACTER_PORTRAIT      5
+
+#define CHOICE_NO_THANKS        CHOICES_PER_VENDOR
+
+void main() {
+    int currentPlayer = GetCurrentPlayerIndex();
+    int condition = GetVendorCondition(VENDOR);
+
+    if ((LEADER_BONUS > 0) && (GetConditionWinners(condition) == (1 << currentPlayer))) {
+        mp3_ShowMessageWithConfirmation(CHARACTER_PORTRAIT, GetLeaderMessage(condition));
+        AdjustPlayerCoinsGradual(currentPlayer, LEADER_BONUS);
+        ShowPlayerCoinChange(currentPlayer, LEADER_BONUS);
+        SleepProcess(30);       // Let the coin change play out
+    }
+
+    if (!IsVendorLocked(VENDOR)) {
+        OfferToLockCondition(currentPlayer);
+    }
+}
+
+// Offers the vendor's three conditions for the current fee.  Returns 1 if the player paid.
+int OfferToLockCondition(int currentPlayer) {
+    struct Player* player = GetPlayerStruct(currentPlayer);
+    int fee = GetVendorFee();
+    if (player->coins < fee) {
+        return 0;
+    }
+
+    ShowMessage(CHARACTER_PORTRAIT, GetOfferMessage(fee), 0, 0, 0, 0, 0);
+    int cpuChoice = CHOICE_NO_THANKS;
+    if (PlayerIsCPU(currentPlayer)) {
+        cpuChoice = GetChoiceForCPU(currentPlayer);
+        SleepProcess(15);       // Make the CPU wait so it doesn't go through the selection too fast
+    }
+    // MP3 built-in function: GetBasicPromptSelection(int strategy, int index)
+    // Strategy 2 -> If CPU, pick the option passed in the second argument.
+    int choice = GetBasicPromptSelection(2, cpuChoice);
+    mp3_TeardownMessageBox();
+
+    if (choice >= CHOICE_NO_THANKS) {
+        return 0;
+    }
+
+    LockVendorCondition(VENDOR, choice);
+    AdjustPlayerCoinsGradual(currentPlayer, -fee);
+    ShowPlayerCoinChange(currentPlayer, -fee);
+    SleepProcess(30);       // Let the coin change play out
+    return 1;
+}
+
+// CPUs lock in a condition they're leading outright, and otherwise keep their coins.
+int GetChoiceForCPU(int currentPlayer) {
+    int choice;
+
+    for (choice = 0; choice < CHOICES_PER_VENDOR; choice++) {
+        int condition = (VENDOR * CHOICES_PER_VENDOR) + choice;
+        if (GetConditionWinners(condition) == (1 << currentPlayer)) {
+            return choice;
+        }
+    }
+    return CHOICE_NO_THANKS;
+}
+
+char* GetLeaderMessage(int condition) {
+    char* message = func_80035934(256);      // First, malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
+                                            // transition, such as a minigame.  Or, you can call free() with func_80035958(ptr)
+    bzero(message, 256);                     // Second, zero out the memory allocated above so we don't get unexpected behavior.
+
+    mplib_strcpy(message, "\x0B");                               // Start the message
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");                  // Standard padding for portrait
+    mplib_strncat(message, "You have ");
+    mplib_strncat(message, GetConditionName(condition));
+    mplib_strncat(message, "\x81");                              // !
+    mplib_strncat(message, "\x0A");                              // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");                  // Standard padding for portrait
+    mplib_strncat(message, "Keep it up");
+    mplib_strncat(message, "\x82");                              // ,
+    mplib_strncat(message, " here");
+    mplib_strncat(message, "\x5C");                              // '
+    mplib_strncat(message, "s ");
+    mplib_strncat(message, "\x06");                              // Begin blue color
+    mplib_AppendNumber(message, LEADER_BONUS);
+    mplib_strncat(message, " coins");
+    mplib_strncat(message, "\x08");                              // Begin white (default) color
+    mplib_strncat(message, "\x81");                              // !
+    mplib_strncat(message, "\xFF");                              // Show prompt to continue arrow
+
+    return message;
+}
+
+// A question line and 4 options.  The widest line, "For 30 coins my Bonus Star goes to", is 38 characters
+// with the portrait padding: the Game Night quiz shows bigger boxes, with two or three question lines
+// of up to 42 characters above its 4 answers.
+char* GetOfferMessage(int fee) {
+    char* message = func_80035934(256);
+    bzero(message, 256);
+    int choice;
+
+    mplib_strcpy(message, "\x0B");                               // Start the message
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");                  // Standard padding for portrait
+    mplib_strncat(message, "For ");
+    mplib_strncat(message, "\x06");                              // Begin blue color
+    mplib_AppendNumber(message, fee);
+    mplib_strncat(message, " coins");
+    mplib_strncat(message, "\x08");                              // Begin white (default) color
+    mplib_strncat(message, " my Bonus Star goes to");
+    for (choice = 0; choice < CHOICES_PER_VENDOR; choice++) {
+        mplib_strncat(message, "\x0A");                          // Newline
+        mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");      // Little more padding for option indent
+        mplib_strncat(message, "\x0C");                          // Start option
+        mplib_strncat(message, GetConditionName((VENDOR * CHOICES_PER_VENDOR) + choice));
+        mplib_strncat(message, "\x0D");                          // End option
+    }
+    mplib_strncat(message, "\x0A");                              // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");          // Little more padding for option indent
+    mplib_strncat(message, "\x0C");                              // Start option
+    mplib_strncat(message, "No thanks");
+    mplib_strncat(message, "\x0D");                              // End option
+    mplib_strncat(message, "\xFF");                              // Show prompt to continue arrow
+
+    return message;
+}
+
+//***************************************************************************//
+//*********************** Bonus Bids engine *********************************//
+//***************************************************************************//
+// Same in Bonus Bids Passive and Bonus Bids Vendor, keep them in step.
+
+int GetTally(int tally, int playerIndex) {
+    return mplib_GetPackedField(BONUS_BIDS_TALLIES, (tally * 4) + playerIndex, TALLY_BITS);
+}
+
+// 1 if somebody paid this vendor to lock in a condition.
+int IsVendorLocked(int vendor) {
+    return mplib_GetPackedField(BONUS_BIDS_VENDORS, vendor, VENDOR_STATE_BITS) != 0;
+}
+
+// The condition a vendor gives its Bonus Star for right now.
+int GetVendorCondition(int vendor) {
+    int state = mplib_GetPackedField(BONUS_BIDS_VENDORS, vendor, VENDOR_STATE_BITS);
+    int choice = (state == 0) ? 0 : state - 1;
+    return (vendor * CHOICES_PER_VENDOR) + choice;
+}
+
+void LockVendorCondition(int vendor, int choice) {
+    mplib_SetPackedField(BONUS_BIDS_VENDORS, vendor, VENDOR_STATE_BITS, choice + 1);
+}
+
+// Fee to lock a vendor: the earlier you commit, the cheaper it is.
+int GetVendorFee() {
+    static const u8 FEE_TIERS[VENDOR_COUNT] = {10, 15, 20, 30};
+    int locked = 0;
+    int vendor;
+
+    for (vendor = 0; vendor < VENDOR_COUNT; vendor++) {
+        locked += IsVendorLocked(vendor);
+    }
+    return FEE_TIERS[(locked < VENDOR_COUNT) ? locked : VENDOR_COUNT - 1];
+}
+
+int IsLeastCondition(int condition) {
+    return (condition == CONDITION_LEAST_BLUE) || (condition == CONDITION_LEAST_RED);
+}
+
+// A player's score for a condition.  Space counts come from the Player struct, the rest from our tallies.
+int GetConditionValue(int condition, int playerIndex) {
+    struct Player* player = GetPlayerStruct(playerIndex);
+
+    switch (condition) {
+        case CONDITION_MOST_BLUE:
+        case CONDITION_LEAST_BLUE:      return player->blue_space_count;
+        case CONDITION_MOST_ITEM:       return player->item_space_count;
+        case CONDITION_MOST_RED:
+        case CONDITION_LEAST_RED:       return player->red_space_count;
+        case CONDITION_MOST_BOWSER:     return player->bowser_space_count;
+        case CONDITION_MOST_GAME_GUY:   return player->game_guy_space_count;
+        case CONDITION_MOST_BANK:       return player->bank_space_count;
+        case CONDITION_MOST_BATTLE:     return player->battle_space_count;
+        case CONDITION_MOST_SWAPS:      return GetTally(TALLY_SWAPS, playerIndex);
+        case CONDITION_MOST_DOORS:      return GetTally(TALLY_DOORS, playerIndex);
+        case CONDITION_MOST_QUIZ:       return GetTally(TALLY_QUIZ, playerIndex);
+    }
+    return 0;
+}
+
+// One pass over the 4 players.  Returns a mask of everyone tied for the lead (bit N = player N).
+int GetConditionWinners(int condition) {
+    int least = IsLeastCondition(condition);
+    int best = GetConditionValue(condition, 0);
+    int winners = 1;
+    int i;
+
+    for (i = 1; i < 4; i++) {
+        int value = GetConditionValue(condition, i);
+        if (value == best) {
+            winners |= (1 << i);
+        } else if (least ? (value < best) : (value > best)) {
+            best = value;
+            winners = (1 << i);
+        }
+    }
+    return winners;
+}
+
+// How a condition reads in a message, like "the most Blue Spaces".
+char* GetConditionName(int condition) {
+    static char* CONDITION_NAMES[VENDOR_COUNT * CHOICES_PER_VENDOR] = {
+        "the most Blue Spaces", "the fewest Blue Spaces", "the most Item Spaces",
+        "the most Red Spaces", "the fewest Red Spaces", "the most Bowser Spaces",
+        "the most Game Guy Spaces", "the most Bank Spaces", "the most Battle Spaces",
+        "the most character swaps", "the most Character Doors", "the most right quiz answers"
+    };
+    return CONDITION_NAMES[condition];
+}
+
+//***************************************************************************//
+//***************************************************************************//
+//****************************                  *****************************//
+//*************************      mplib v2.3        **************************//
+//****************************                  *****************************//
+//***************************************************************************//
+//***************************************************************************//
+//***      Some helper functions to make up for lack of stdlib.io; and    ***//
+//***     to hide the complexity of some Mario Party-specific functions   ***//
+//***************************************************************************//
+//***************************************************************************//
+// Paste this at the bottom of an event file to get access to helpful functions during development!
+// Then, when you are ready to ship, delete the functions you don't use to save space and remove clutter.
+//
+// Get the latest version or submit changes at: 
+// https://github.com/C-Kennelly/mario-party-custom-events
+//***************************************************************************//
+//
+// Looking for another function?  
+// Have you checked the PartyPlanner64 symbols table yet?
+// https://github.com/PartyPlanner64/symbols/blob/master/MarioParty3U.sym
+//***************************************************************************//
+
+
+// Helper function that shows a message and then tears the message box down
+// after the player confirms the last box.  Don't use for prompt selection.
+void mp3_ShowMessageWithConfirmation(int characterPortraitIndex, char* message)
+{
+    // This function assumes you aren't using the additional arguments
+    // of ShowMessage() and hardcodes them to 0.  If you want to use them,
+    // add them to the wrapper function and pass through.
+
+    ShowMessage(characterPortraitIndex, message, 0, 0, 0, 0, 0);
+    mp3_WaitForPlayerConfirmation();
+    mp3_TeardownMessageBox();
+
+}
+
+// A wrapper for the "wait for confimration" command in MP3
+void mp3_WaitForPlayerConfirmation()
+{
+    func_800EC9DC();    //Wait for confirmation
+}
+
+// Helper function that just does teardown of a message box.
+// Split out so it can be used after waiting for confirmation 
+// or getting a selection choice.
+void mp3_TeardownMessageBox()
+{
+    CloseMessage();     //Close the message
+    func_800EC6EC();    //Message box teardown
+}
+
+// Long-form implementation from:
+// https://www.techiedelight.com/implement-strcpy-function-c/
+//
+// Function to implement strcpy() function
+char* mplib_strcpy(char* destination, const char* source)
+{
+    // return if no memory is allocated to the destination
+    if (destination == NULL)
+        return NULL;
+ 
+    // take a pointer pointing to the beginning of destination string
+    char *ptr = destination;
+ 
+    // copy the C-string pointed by source into the array
+    // pointed to by destination
+    while (*source != '\0')
+    {
+        *destination = *source;
+        destination++;
+        source++;
+    }
+ 
+    // include the terminating null character
+    *destination = '\0';
+ 
+    // destination is returned by standard strcpy()
+    return ptr;
+}
+
+// Function to implement strncat() function in C
+char* mplib_strncat(char* destination, const char* source)
+{
+    int i, j;
+ 
+    // move to the end of destination string
+    for (i = 0; destination[i] != '\0'; i++);
+ 
+    // i now points to terminating null character in destination
+ 
+    // Appends num characters of source to the destination string
+    for (j = 0; source[j] != '\0'; j++)
+        destination[i + j] = source[j];
+ 
+    // null terminate destination string
+    destination[i + j] = '\0';
+ 
+    // destination is returned by standard strncat()
+    return destination;
+}
+
+// Appends a number from 0 to 999 to the end of a string, for messages like "Pay 10 coins".
+char* mplib_AppendNumber(char* destination, int number)
+{
+    char digits[4];
+    int i = 3;
+
+    digits[i] = '\0';
+    do
+    {
+        digits[--i] = '0' + (number % 10);
+        number /= 10;
+    } while ((number > 0) && (i > 0));
+
+    return mplib_strncat(destination, &digits[i]);
+}
+
+// Packed arrays: the same small field repeated back to back in a run of bytes, like one entry per
+// Character Door in a BOARD_RAM_BYTES block.  Entry N of a W-bit array starts at bit N*W, counting
+// from bit 0 of the first byte, so 8 doors of 6 bits fit in 6 bytes.  An entry can straddle two
+// bytes; W can be 1-8.
+int mplib_GetPackedField(u8 *block, int index, int width)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+
+    int window = bytes[0];
+    if(shift + width > 8)
+    {
+        window |= bytes[1] << 8;
+    }
+    return (window >> shift) & mplib_BitMask(width);
+}
+
+void mplib_SetPackedField(u8 *block, int index, int width, int value)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+    int mask = mplib_BitMask(width) << shift;
+    int bits = (value << shift) & mask;
+
+    bytes[0] = (bytes[0] & ~mask) | bits;
+    if(shift + width > 8)
+    {
+        bytes[1] = (bytes[1] & ~(mask >> 8)) | (bits >> 8);
+    }
+}
@@ -1,13 +1,23 @@
-// NAME: Character Door (Basic)
+// NAME: Character Door
 // GAMES: MP3_USA
 // EXECUTION: Direct
+// PARAM: Number|DOOR_INDEX|0|7|0
 // PARAM: Number|PREFERRED_CHARACTER_CATEGORY|0|3|0
 // PARAM: Number|OPEN_MODE|0|3|0
 // PARAM: Number|PASSING_FEE|0|99|10
 // PARAM: Number|CHANGE_MODE|0|3|0
 // PARAM: Number|CHANGE_MODE_TURNS|1|10|3
+// PARAM: Boolean|COUNTS_FOR_BONUS_BIDS
+// BOARD_RAM_GROUP: Character Door
+// BOARD_RAM_BYTES: CHARACTER_DOOR_STATE|6
+// BOARD_RAM: CHARACTER_DOOR_DYNAMIC_MODE|2
+// BOARD_RAM_BYTES: Bonus Bids.BONUS_BIDS_TALLIES|8|COUNTS_FOR_BONUS_BIDS
 
 // Development defines for VS Code
+#ifndef DOOR_INDEX
+    #define DOOR_INDEX 0  // 0-7, a different number for every door on the board
+#endif
+
 #ifndef PREFERRED_CHARACTER_CATEGORY
     #define PREFERRED_CHARACTER_CATEGORY 0  // 0=Plumber, 1=Princess, 2=Beast, 3=Villain
 #endif
@@ -28,15 +38,68 @@
     #define CHANGE_MODE_TURNS 3
 #endif
 
+#ifndef COUNTS_FOR_BONUS_BIDS
+    #define COUNTS_FOR_BONUS_BIDS 1  // Add each pass to the Bonus Bids "most Character Doors" tally
+#endif
+
 //***************************************************************************//
 //******************** Version Info! ****************************************//
 //***************************************************************************//
-// Version: 1.0 - Basic Implementation (Matching Only Mode)
+// Version: 2.1 - Turned-away players are sent back, and only passes count toward a change or a tally
 // Repository: https://github.com/c-kennelly/mario-party-custom-events
 //
-// This is a basic implementation of the Character Door system that only
-// supports "Matching Only" mode. It's structured to easily extend to the
-// full system described in Spec.txt.
+// Changelist:
+//   Version 2.1 - A player the door turns away is sent back the way they came, instead of only being
+//                 shown the door's message.  Randomly and Sequence doors only count players that pass.
+//                 Passes count toward the Bonus Bids "most Character Doors" tally (COUNTS_FOR_BONUS_BIDS).
+//   Version 2.0 - Matching with Fees, Dynamic mode, and the Randomly/Sequence/EveryUse change modes.
+//                 Each door keeps its own state, picked by the DOOR_INDEX parameter.
+//   Version 1.0 - Basic Implementation (Matching Only Mode)
+
+//***************************************************************************//
+//******************** BOARD RAM WARNING ************************************//
+//***************************************************************************//
+// Every Character Door on the board shares the "Character Door" BOARD_RAM_GROUP:
+//              CHARACTER_DOOR_STATE        6 bytes - 6 bits for each of up to 8 doors
+//              CHARACTER_DOOR_DYNAMIC_MODE 2 bits  - which mode Dynamic doors use right now
+//
+// Give every door on your board a different DOOR_INDEX (0-7), or two doors will share one state.
+// Each door's 6 bits are its preferred category (2 bits, stored as how far it has moved on from
+// PREFERRED_CHARACTER_CATEGORY) and its change counter (4 bits).  Run
+// "python3 Tools/board_ram_alloc.py your_board.json --write" to place them around the other events.
+//
+// All of this starts at 0 at the start of a game when the "Board State Header" event is on the board,
+// which means every door starts on its PREFERRED_CHARACTER_CATEGORY and Dynamic doors start open.
+//
+// With COUNTS_FOR_BONUS_BIDS on, the door also adds one to the passing player's "most Character Doors"
+// tally in the Bonus Bids events' BONUS_BIDS_TALLIES (8 bytes, shared with them).
+
+//***************************************************************************//
+//*********************** Description ***************************************//
+//***************************************************************************//
+// A passing event, like a skeleton key door, that cares about which character you are.
+// Characters are split into 4 categories, and the approaching character is judged against the
+// door's preferred category according to OPEN_MODE:
+//
+//  0 - Matching Only:      only the preferred category may pass.
+//  1 - Matching with Fees: the preferred category passes free, allied categories may pay PASSING_FEE,
+//                          and the enemy category is turned away.  Plumbers and Villains are enemies,
+//                          and so are Princesses and Beasts; everyone else is an ally.
+//  2 - All but Matching:   everyone EXCEPT the preferred category may pass.
+//  3 - Dynamic:            CHARACTER_DOOR_DYNAMIC_MODE picks the mode for every Dynamic door at once.
+//                          0 lets everyone through, 1-3 mean Matching Only, Matching with Fees and
+//                          All but Matching.  Set it from another event to change the whole board.
+//
+// CHANGE_MODE decides how the preferred category moves during the game:
+//
+//  0 - NoChange:   fixed for the whole game.
+//  1 - Randomly:   every CHANGE_MODE_TURNS passes, changes to any category but the current one.
+//  2 - Sequence:   every CHANGE_MODE_TURNS passes, moves on Plumbers -> Princesses -> Beasts -> Villains -> Plumbers.
+//  3 - EveryUse:   moves on in sequence every time someone goes through.
+//
+// The character -> category map and the ally/enemy relation are compile-time tables.  Categories are
+// numbered so the enemy pairs differ in both bits, so (a ^ b) is 0 for a match, 3 for enemies and
+// 1 or 2 for allies.
 
 #include "ultra64.h"
 
@@ -86,10 +149,27 @@ struct Player {
     char unk_35[3]; 		//likely padding
 }; // sizeof == 56
 
-// External declarations for future BoardRAM usage
-extern u8 D_800CD0A0;  // board_ram9 - Could store door state
-extern u8 D_800CD0A1;  // board_ram10 - Could store preferred category
-extern u8 D_800CD0A2;  // board_ram11 - Could store change counter
+// BoardRAM for the door states, declared in the header and packed by Tools/board_ram_alloc.py --write.
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Character Swap" board.
+// Re-run the tool instead of editing these by hand.  Event: Character Door
+#define BOARD_RAM_LAYOUT_VERSION                 1
+extern u8 D_800CD098;
+extern u8 D_800CD0A0;
+extern u8 D_800CD0A8;
+#define CHARACTER_DOOR_DYNAMIC_MODE_BYTE         D_800CD0A8
+#define CHARACTER_DOOR_DYNAMIC_MODE_SHIFT        6
+#define CHARACTER_DOOR_DYNAMIC_MODE_WIDTH        2
+#define CHARACTER_DOOR_STATE                     (&D_800CD0A0)
+#define CHARACTER_DOOR_STATE_SIZE                6
+#define BONUS_BIDS_TALLIES                       (&D_800CD098)
+#define BONUS_BIDS_TALLIES_SIZE                  8
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
 
 // Character category constants
 #define CATEGORY_PLUMBER   0
@@ -97,108 +177,200 @@ extern u8 D_800CD0A2;  // board_ram11 - Could store change counter
 #define CATEGORY_BEAST     2
 #define CATEGORY_VILLAIN   3
 
-// Open mode constants (for future expansion)
-#define MODE_MATCHING_ONLY     0
+// Open mode constants
+#define MODE_MATCHING_ONLY      0
 #define MODE_MATCHING_WITH_FEES 1
-#define MODE_ALL_BUT_MATCHING  2
-#define MODE_DYNAMIC           3
-
-// Function prototypes (for future expansion)
-int GetCharacterCategory(int characterId);
-int IsPassageAllowed(int currentCategory, int preferredCategory, int openMode);
-void ProcessPassageMode(int currentPlayer, int currentCategory, int preferredCategory, int openMode);
-void ProcessMatchingWithFeesMode(int currentPlayer, int currentCategory, int preferredCategory);
-void ShowFlavorText(int preferredCategory, int isAllowed);
+#define MODE_ALL_BUT_MATCHING   2
+#define MODE_DYNAMIC            3
+#define MODE_OPEN_TO_ALL        4   // Only reachable through Dynamic
+
+// Change mode constants
+#define CHANGE_NONE             0
+#define CHANGE_RANDOMLY         1
+#define CHANGE_SEQUENCE         2
+#define CHANGE_EVERY_USE        3
+
+// Category relations: (category ^ preferredCategory)
+#define RELATION_MATCHING       0
+#define RELATION_ENEMY          3   // Plumber (00) vs. Villain (11), Princess (01) vs. Beast (10)
+
+// Per-door state, 6 bits each in CHARACTER_DOOR_STATE: [5:4] category offset, [3:0] change counter.
+#define DOOR_STATE_BITS         6
+#define DOOR_OFFSET_SHIFT       4
+#define DOOR_COUNTER_MASK       0x0F
+
+// Bonus Bids tallies, numbered as in the Bonus Bids engine: entry (tally * 4) + player, 5 bits each.
+#define TALLY_DOORS             1
+#define TALLY_BITS              5
+#define TALLY_MAX               31
+
+// Indexed by Player.character: Mario, Luigi, Peach, Yoshi, Wario, DK, Waluigi, Daisy
+static const u8 CHARACTER_CATEGORY[8] = {
+    CATEGORY_PLUMBER, CATEGORY_PLUMBER, CATEGORY_PRINCESS, CATEGORY_BEAST,
+    CATEGORY_VILLAIN, CATEGORY_BEAST, CATEGORY_VILLAIN, CATEGORY_PRINCESS
+};
+
+// CHARACTER_DOOR_DYNAMIC_MODE -> open mode
+static const u8 DYNAMIC_OPEN_MODE[4] = {
+    MODE_OPEN_TO_ALL, MODE_MATCHING_ONLY, MODE_MATCHING_WITH_FEES, MODE_ALL_BUT_MATCHING
+};
 
 void main() {
     int currentPlayer = GetCurrentPlayerIndex();
     struct Player* player = GetPlayerStruct(currentPlayer);
-    int characterId = player->character;
-    
-    // Get the character's category
-    int currentCategory = GetCharacterCategory(characterId);
-    int preferredCategory = PREFERRED_CHARACTER_CATEGORY;
-    
-    // Dispatch to passage logic - modes 1 and 3 fall back to passage logic for now
-    if (OPEN_MODE == MODE_MATCHING_WITH_FEES) {
-        // TODO: Implement full Matching with Fees mode (ally/enemy/fee logic)
-        mp3_DebugMessage("Matching with Fees mode not yet implemented");
-        ProcessPassageMode(currentPlayer, currentCategory, preferredCategory, MODE_MATCHING_ONLY);
-    } else {
-        ProcessPassageMode(currentPlayer, currentCategory, preferredCategory, OPEN_MODE);
+    int currentCategory = CHARACTER_CATEGORY[player->character & 7];
+
+    int doorState = mplib_GetPackedField(CHARACTER_DOOR_STATE, DOOR_INDEX, DOOR_STATE_BITS);
+    int preferredCategory = GetPreferredCategory(doorState);
+
+    int openMode = OPEN_MODE;
+    if (openMode == MODE_DYNAMIC) {
+        openMode = DYNAMIC_OPEN_MODE[mplib_GetField(CHARACTER_DOOR_DYNAMIC_MODE)];
     }
-    
-    // TODO: Implement change mode logic here
-    // TODO: Update BoardRAM for dynamic modes
-}
 
-// Core character categorization logic
-int GetCharacterCategory(int characterId) {
-    switch (characterId) {
-        case 0: // Mario
-        case 1: // Luigi
-            return CATEGORY_PLUMBER;
-        case 2: // Peach
-        case 7: // Daisy
-            return CATEGORY_PRINCESS;
-        case 3: // Yoshi
-        case 5: // DK
-            return CATEGORY_BEAST;
-        case 4: // Wario
-        case 6: // Waluigi
-            return CATEGORY_VILLAIN;
-        default:
-            return CATEGORY_PLUMBER; // Fallback
+    if (!ProcessPassage(currentPlayer, currentCategory, preferredCategory, openMode)) {
+        BlockPlayerAtDoor(player);
+        return;
+    }
+
+    mplib_SetPackedField(CHARACTER_DOOR_STATE, DOOR_INDEX, DOOR_STATE_BITS, AdvanceDoorState(doorState));
+#ifdef BONUS_BIDS_TALLIES
+    if (COUNTS_FOR_BONUS_BIDS == 1) {
+        AddToTally(TALLY_DOORS, currentPlayer);
     }
+#endif
+}
+
+// The door stores how many categories it has moved on from its placed PREFERRED_CHARACTER_CATEGORY,
+// so a freshly cleared state of 0 means the category from PartyPlanner.
+int GetPreferredCategory(int doorState) {
+    return (PREFERRED_CHARACTER_CATEGORY + (doorState >> DOOR_OFFSET_SHIFT)) & 3;
 }
 
-// Core passage logic (extensible for other modes)
-int IsPassageAllowed(int currentCategory, int preferredCategory, int openMode) {
+// Shows the door's messages, takes the fee if one is paid, and returns 1 if the player may pass.
+int ProcessPassage(int currentPlayer, int currentCategory, int preferredCategory, int openMode) {
+    int relation = currentCategory ^ preferredCategory;
+    int isAllowed;
+
     switch (openMode) {
-        case MODE_MATCHING_ONLY:
-            return (currentCategory == preferredCategory);
+        case MODE_OPEN_TO_ALL:
+            ShowOpenToAllText();
+            return 1;
         case MODE_MATCHING_WITH_FEES:
-            // TODO: Implement ally logic
-            return 1; // Placeholder
+            if (relation == RELATION_MATCHING) {
+                isAllowed = 1;
+            } else if (relation == RELATION_ENEMY) {
+                isAllowed = 0;
+            } else {
+                return OfferPassingFee(currentPlayer, preferredCategory);
+            }
+            ShowFlavorText(preferredCategory, isAllowed, 0);
+            return isAllowed;
         case MODE_ALL_BUT_MATCHING:
-            return (currentCategory != preferredCategory);
-        case MODE_DYNAMIC:
-            // TODO: Check BoardRAM state
-            return 1; // Placeholder
+            isAllowed = (relation != RELATION_MATCHING);
+            ShowFlavorText(preferredCategory, isAllowed, 1);
+            return isAllowed;
+        case MODE_MATCHING_ONLY:
         default:
-            return (currentCategory == preferredCategory);
+            isAllowed = (relation == RELATION_MATCHING);
+            ShowFlavorText(preferredCategory, isAllowed, 0);
+            return isAllowed;
     }
 }
 
-// Handle passage logic for modes 0 (Matching Only), 2 (All but Matching), and 3 (Dynamic)
-void ProcessPassageMode(int currentPlayer, int currentCategory, int preferredCategory, int openMode) {
-    int isAllowed = IsPassageAllowed(currentCategory, preferredCategory, openMode);
-    
-    // Show appropriate flavor text
-    ShowFlavorText(preferredCategory, isAllowed);
-    
-    if (isAllowed) {
-        // Allow passage - player continues normally
-        mp3_DebugMessage("Character door: Access granted");
-    } else {
-        // Block passage - player cannot continue
-        mp3_DebugMessage("Character door: Access denied");
-        // TODO: Implement actual movement blocking
-        // For now, just show the message
+// Allied characters may pay PASSING_FEE to pass.  CPUs pay whenever they can afford it.
+int OfferPassingFee(int currentPlayer, int preferredCategory) {
+    struct Player* player = GetPlayerStruct(currentPlayer);
+    if (player->coins < PASSING_FEE) {
+        ShowFlavorText(preferredCategory, 0, 0);
+        return 0;
+    }
+
+    ShowMessage(5, GetFeeOfferMessage(preferredCategory), 0, 0, 0, 0, 0);
+    int choice = GetBasicPromptSelection(2, 0);     // CPUs pick option 0, pay the fee
+    mp3_TeardownMessageBox();
+    if (choice != 0) {
+        return 0;
+    }
+
+    AdjustPlayerCoinsGradual(currentPlayer, -PASSING_FEE);
+    ShowPlayerCoinChange(currentPlayer, -PASSING_FEE);
+    SleepProcess(30);       // Let the coin change play out
+    return 1;
+}
+
+// Counts a player passing through and moves the preferred category on when CHANGE_MODE says so.
+// Players the door turns away don't count.  Returns the new 6-bit door state.
+int AdvanceDoorState(int doorState) {
+    int offset = doorState >> DOOR_OFFSET_SHIFT;
+    int counter = doorState & DOOR_COUNTER_MASK;
+
+    switch (CHANGE_MODE) {
+        case CHANGE_EVERY_USE:
+            offset++;
+            counter = 0;
+            break;
+        case CHANGE_RANDOMLY:
+        case CHANGE_SEQUENCE:
+            counter++;
+            if (counter >= CHANGE_MODE_TURNS) {
+                counter = 0;
+                // Randomly moves on 1-3 categories, so it never lands back on the current one.
+                offset += (CHANGE_MODE == CHANGE_RANDOMLY) ? 1 + mp3_PickARandomNumberBetween0AndN(3) : 1;
+            }
+            break;
+        case CHANGE_NONE:
+        default:
+            return doorState;
+    }
+
+    return ((offset & 3) << DOOR_OFFSET_SHIFT) | (counter & DOOR_COUNTER_MASK);
+}
+
+#ifdef BONUS_BIDS_TALLIES
+// Adds one to a player's tally.  Same as in the Bonus Bids engine.
+void AddToTally(int tally, int playerIndex) {
+    int index = (tally * 4) + playerIndex;
+    int count = mplib_GetPackedField(BONUS_BIDS_TALLIES, index, TALLY_BITS);
+    if (count < TALLY_MAX) {
+        mplib_SetPackedField(BONUS_BIDS_TALLIES, index, TALLY_BITS, count + 1);
     }
 }
+#endif
 
-// Placeholder for Matching with Fees mode (future implementation)
-// Enemy pairs (per spec): Plumbers vs. Villains, Princesses vs. Beasts. Allies = everyone else.
-void ProcessMatchingWithFeesMode(int currentPlayer, int currentCategory, int preferredCategory) {
-    // TODO: Implement ally/enemy logic
-    // TODO: Implement fee payment system
-    // TODO: Handle different responses based on ally/enemy/matching status
-    mp3_DebugMessage("Matching with Fees mode not yet implemented");
+// Keeps the player from moving past the door: their next step goes back to the space they came
+// from instead of on through the door.
+void BlockPlayerAtDoor(struct Player* player) {
+    player->next_chain_index = player->reverse_chain_index;
+    player->next_space_index = player->reverse_space_index;
 }
 
-// Display flavor text based on category and access result
-void ShowFlavorText(int preferredCategory, int isAllowed) {
+// Appends the category's flavor text (from Spec.txt), in the category's color.
+void AppendCategoryTrait(char* message, int category) {
+    switch (category) {
+        case CATEGORY_PLUMBER:
+            mplib_strncat(message, "\x06");                 // Begin yellow color
+            mplib_strncat(message, "wear a hat");
+            break;
+        case CATEGORY_PRINCESS:
+            mplib_strncat(message, "\x05");                 // Begin pink color  
+            mplib_strncat(message, "are royalty");
+            break;
+        case CATEGORY_BEAST:
+            mplib_strncat(message, "\x04");                 // Begin green color
+            mplib_strncat(message, "love brightly colored fruit");
+            break;
+        case CATEGORY_VILLAIN:
+            mplib_strncat(message, "\x03");                 // Begin red color
+            mplib_strncat(message, "have names that start with W");
+            break;
+    }
+    mplib_strncat(message, "\x08");                         // Begin white (default) color
+}
+
+// Display flavor text based on category and access result.
+// keepOut is 1 for All but Matching doors, which turn the preferred category away instead.
+void ShowFlavorText(int preferredCategory, int isAllowed, int keepOut) {
     char* message = func_80035934(256);      // First, malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
                                             // transition, such as a minigame.  Or, you can call free() with func_80035958(ptr)
     bzero(message, 256);                     // Second, zero out the memory allocated above so we don't get unexpected behavior.
@@ -207,87 +379,100 @@ void ShowFlavorText(int preferredCategory, int isAllowed) {
     mplib_strcpy(message, "\x0B");                              // Start the message
     mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
     
-    if (isAllowed) {
+    if (keepOut) {
+        mplib_strncat(message, isAllowed ? "Ah" : "Hmm");
+        mplib_strncat(message, "\x82");                         // ,
+        mplib_strncat(message, " I keep out those who");
+        mplib_strncat(message, "\x0A");                         // Newline
+        mplib_strncat(message, "\x1A\x1A\x1A\x1A");           // Standard padding for portrait
+        AppendCategoryTrait(message, preferredCategory);
+        mplib_strncat(message, "\x85");                         // .
+    } else if (isAllowed) {
         mplib_strncat(message, "Ah");
         mplib_strncat(message, "\x82");                         // ,
         mplib_strncat(message, " I can tell you");
         mplib_strncat(message, "\x0A");                         // Newline
         mplib_strncat(message, "\x1A\x1A\x1A\x1A");           // Standard padding for portrait
-        
-        // Add category-specific flavor text from Spec.txt
-        switch (preferredCategory) {
-            case CATEGORY_PLUMBER:
-                mplib_strncat(message, "\x06");                 // Begin yellow color
-                mplib_strncat(message, "wear a hat");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-            case CATEGORY_PRINCESS:
-                mplib_strncat(message, "\x05");                 // Begin pink color  
-                mplib_strncat(message, "are royalty");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-            case CATEGORY_BEAST:
-                mplib_strncat(message, "\x04");                 // Begin green color
-                mplib_strncat(message, "love brightly colored fruit");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-            case CATEGORY_VILLAIN:
-                mplib_strncat(message, "\x03");                 // Begin red color
-                mplib_strncat(message, "have names that start with W");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-        }
-        
+        AppendCategoryTrait(message, preferredCategory);
         mplib_strncat(message, "\x85");                         // .
-        mplib_strncat(message, "\x0A");                         // Newline  
-        mplib_strncat(message, "\x1A\x1A\x1A\x1A");           // Standard padding for portrait
-        mplib_strncat(message, "You may pass");
-        mplib_strncat(message, "\x81");                         // !
-        
     } else {
         mplib_strncat(message, "Hmm");
         mplib_strncat(message, "\x82");                         // ,
         mplib_strncat(message, " I only let those who");
         mplib_strncat(message, "\x0A");                         // Newline
         mplib_strncat(message, "\x1A\x1A\x1A\x1A");           // Standard padding for portrait
-        
-        // Add category-specific requirement text
-        switch (preferredCategory) {
-            case CATEGORY_PLUMBER:
-                mplib_strncat(message, "\x06");                 // Begin yellow color
-                mplib_strncat(message, "wear a hat");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-            case CATEGORY_PRINCESS:
-                mplib_strncat(message, "\x05");                 // Begin pink color
-                mplib_strncat(message, "are royalty");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-            case CATEGORY_BEAST:
-                mplib_strncat(message, "\x04");                 // Begin green color
-                mplib_strncat(message, "love brightly colored fruit");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-            case CATEGORY_VILLAIN:
-                mplib_strncat(message, "\x03");                 // Begin red color
-                mplib_strncat(message, "have names that start with W");
-                mplib_strncat(message, "\x08");                 // Begin white (default) color
-                break;
-        }
-        
+        AppendCategoryTrait(message, preferredCategory);
         mplib_strncat(message, " pass through");
         mplib_strncat(message, "\x85");                         // .
-        mplib_strncat(message, "\x0A");                         // Newline
-        mplib_strncat(message, "\x1A\x1A\x1A\x1A");           // Standard padding for portrait
+    }
+
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    if (isAllowed) {
+        mplib_strncat(message, "You may pass");
+    } else {
         mplib_strncat(message, "You shall not pass");
-        mplib_strncat(message, "\x81");                         // !
     }
-    
+    mplib_strncat(message, "\x81");                             // !
     mplib_strncat(message, "\xFF");                             // Show prompt to continue arrow
 
     mp3_ShowMessageWithConfirmation(5, message);  // Use DK portrait (character 5)
 }
 
+// Dynamic doors with CHARACTER_DOOR_DYNAMIC_MODE at 0 let everyone through.
+void ShowOpenToAllText() {
+    char* message = func_80035934(256);
+    bzero(message, 256);
+
+    mplib_strcpy(message, "\x0B");                              // Start the message
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    mplib_strncat(message, "The door is open to everyone today");
+    mplib_strncat(message, "\x81");                             // !
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    mplib_strncat(message, "You may pass");
+    mplib_strncat(message, "\x81");                             // !
+    mplib_strncat(message, "\xFF");                             // Show prompt to continue arrow
+
+    mp3_ShowMessageWithConfirmation(5, message);
+}
+
+// The offer an allied character gets in Matching with Fees mode, with Pay / Don't pay options.
+char* GetFeeOfferMessage(int preferredCategory) {
+    char* message = func_80035934(256);
+    bzero(message, 256);
+
+    mplib_strcpy(message, "\x0B");                              // Start the message
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    mplib_strncat(message, "Hmm");
+    mplib_strncat(message, "\x82");                             // ,
+    mplib_strncat(message, " you don");
+    mplib_strncat(message, "\x5C");                             // '
+    mplib_strncat(message, "t seem to");
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    AppendCategoryTrait(message, preferredCategory);
+    mplib_strncat(message, "\x82");                             // ,
+    mplib_strncat(message, " but for a fee");
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");       // Little more padding for option indent
+    mplib_strncat(message, "\x0C");                             // Start option
+    mplib_strncat(message, "Pay ");
+    mplib_AppendNumber(message, PASSING_FEE);
+    mplib_strncat(message, " coins");
+    mplib_strncat(message, "\x0D");                             // End option
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");       // Little more padding for option indent
+    mplib_strncat(message, "\x0C");                             // Start option
+    mplib_strncat(message, "Don");
+    mplib_strncat(message, "\x5C");                             // '
+    mplib_strncat(message, "t pay");
+    mplib_strncat(message, "\x0D");                             // End option
+    mplib_strncat(message, "\xFF");                             // Show prompt to continue arrow
+
+    return message;
+}
+
 //***************************************************************************//
 //***************************************************************************//
 //****************************                  *****************************//
@@ -401,3 +586,73 @@ char* mplib_strncat(char* destination, const char* source)
     // destination is returned by standard strncat()
     return destination;
 }
+
+
+// Picks a random number between 0 and N, using rejection sampling to avoid modulo bias.
+// Don't use this!!! -->  { return GetRandomByte() % n; } or you may bias your random generation!
+// https://zuttobenkyou.wordpress.com/2012/10/18/generating-random-numbers-without-modulo-bias/
+//
+// IMPORTANT.  Maximum random number we could generate here would be 255 (max value of a byte).
+int mp3_PickARandomNumberBetween0AndN(int n)
+{
+    int result = GetRandomByte();                   //Get a random number by picking a random byte.
+    
+    int randMax = 255;                              // 255 is the maximum value of a byte.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
+    int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
+    while (result > randLimit)                      // Reject any random bytes with values above randLimit...
+    {
+        result = GetRandomByte();                   // and roll again by selecting a new byte.
+    }    
+
+    return result % n;                              //Since we rejected the excess samples, we've guaranteed an unbiased result.
+}
+
+// Appends a number from 0 to 999 to the end of a string, for messages like "Pay 10 coins".
+char* mplib_AppendNumber(char* destination, int number)
+{
+    char digits[4];
+    int i = 3;
+
+    digits[i] = '\0';
+    do
+    {
+        digits[--i] = '0' + (number % 10);
+        number /= 10;
+    } while ((number > 0) && (i > 0));
+
+    return mplib_strncat(destination, &digits[i]);
+}
+
+// Packed arrays: the same small field repeated back to back in a run of bytes, like one entry per
+// Character Door in a BOARD_RAM_BYTES block.  Entry N of a W-bit array starts at bit N*W, counting
+// from bit 0 of the first byte, so 8 doors of 6 bits fit in 6 bytes.  An entry can straddle two
+// bytes; W can be 1-8.
+int mplib_GetPackedField(u8 *block, int index, int width)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+
+    int window = bytes[0];
+    if(shift + width > 8)
+    {
+        window |= bytes[1] << 8;
+    }
+    return (window >> shift) & mplib_BitMask(width);
+}
+
+void mplib_SetPackedField(u8 *block, int index, int width, int value)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+    int mask = mplib_BitMask(width) << shift;
+    int bits = (value << shift) & mask;
+
+    bytes[0] = (bytes[0] & ~mask) | bits;
+    if(shift + width > 8)
+    {
+        bytes[1] = (bytes[1] & ~(mask >> 8)) | (bits >> 8);
+    }
+}
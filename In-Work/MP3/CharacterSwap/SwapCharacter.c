@@ -0,0 +1,509 @@
+// NAME: Swap Character
+// GAMES: MP3_USA
+// EXECUTION: Direct
+// PARAM: Boolean|COUNTS_FOR_BONUS_BIDS
+// BOARD_RAM_GROUP: Character Door
+// BOARD_RAM_BYTES: CHARACTER_DOOR_STATE|6
+// BOARD_RAM: CHARACTER_DOOR_DYNAMIC_MODE|2
+// BOARD_RAM_BYTES: Bonus Bids.BONUS_BIDS_TALLIES|8|COUNTS_FOR_BONUS_BIDS
+
+// Development defines for VS Code
+#ifndef COUNTS_FOR_BONUS_BIDS
+    #define COUNTS_FOR_BONUS_BIDS 1  // Add each swap to the Bonus Bids "most character swaps" tally
+#endif
+
+//***************************************************************************//
+//******************** Version Info! ****************************************//
+//***************************************************************************//
+// Version: 0.2 - Swap Only mode
+// Repository: https://github.com/c-kennelly/mario-party-custom-events
+//
+// Changelist:
+//   Version 0.2 - Swap Only mode: the player may swap to a character nobody is playing, and CPUs take
+//                 the one the door planner picks.  Steal, Shuffle and the fees are still to come.
+//                 Swaps count toward the Bonus Bids "most character swaps" tally (COUNTS_FOR_BONUS_BIDS).
+//   Version 0.1 - CPUs work out which character gets them through the next Character Door.
+//                 The swap modes and fees from Spec.txt are still to come.
+
+//***************************************************************************//
+//******************** BOARD RAM WARNING ************************************//
+//***************************************************************************//
+// Swap Character only READS the Character Door board RAM, to see what each door wants right now.
+// It's in the "Character Door" BOARD_RAM_GROUP so Tools/board_ram_alloc.py gives it the same slots.
+//
+// With COUNTS_FOR_BONUS_BIDS on, each swap also adds one to the player's "most character swaps" tally
+// in the Bonus Bids events' BONUS_BIDS_TALLIES (8 bytes, shared with them).
+
+//***************************************************************************//
+//*********************** Description ***************************************//
+//***************************************************************************//
+// Lets players change their active character out for another one (see Spec.txt).  So far only the
+// Swap Only mode is here: the player is offered a swap, and picks from the 4 characters nobody is
+// playing.  The board then reloads so it draws the new character.
+//
+// CPUs look at the next Character Door in front of them and pick a character that can get through it.
+// Walking the board to find that door would mean following links space by space on every swap, so
+// Tools/door_lookahead.py walks the board once on your PC and writes DOOR_LOOKAHEAD below: one byte
+// per space with the nearest door within DOOR_LOOKAHEAD_STEPS steps.  Re-run it whenever doors or
+// links on the board change:
+//
+//      python3 Tools/door_lookahead.py your_board.json --write
+//
+// Each entry holds the door's DOOR_INDEX, its placed category and its OPEN_MODE.  The DOOR_INDEX is
+// how we read the door's live state (has its category moved on since the start of the game?) out of
+// CHARACTER_DOOR_STATE.
+
+#include "ultra64.h"
+
+// Player struct definition for reference
+// Reference wiki article can be found here:
+// https://github.com/PartyPlanner64/PartyPlanner64/wiki/Player-Structs
+struct Player {
+    s8 unk0;
+    s8 cpu_difficulty;
+    s8 controller;
+    u8 character;
+    u8 flags;               // Miscellaneous flags. "1" is CPU player
+    s8 pad0[5];             // Skip undocumented offset 5-9
+    s16 coins;              // Offset 10: Current coin count.
+    s16 minigame_coins;     // Offset 12: Coins obtained during a Mini-Game.
+    s8 stars;               // Offset 14
+    
+    u8 cur_chain_index;     // Offset 15
+    u8 cur_space_index;     // Offset 16
+    u8 next_chain_index;    // Offset 17
+    u8 next_space_index;    // Offset 18
+    u8 unk1_chain_index;    // Offset 19
+    u8 unk1_space_index;    // Offset 20
+    u8 reverse_chain_index; // Offset 21
+    u8 reverse_space_index; // Offset 22
+
+    u8 flags2;              // Offset 23
+    u8 items[3];            // Offset 24
+    u8 bowser_suit_flag;    // Offset 27
+    u8 turn_color_status;   // Offset 28
+
+    s8 pad1[7];             // Offsets: 29 - 35
+
+    void *obj;              // Offset 36:  struct object pointer
+    s16 minigame_star;      // Offset 40
+    s16 coin_star;          // Offset 42
+    s8 happening_space_count; // Offset 44
+    s8 red_space_count;     
+    s8 blue_space_count;
+    s8 chance_space_count;
+    s8 bowser_space_count;  // Offset 48
+    s8 battle_space_count;
+    s8 item_space_count;
+    s8 bank_space_count;
+    s8 game_guy_space_count; //Offset  52
+
+    char unk_35[3]; 		//likely padding
+}; // sizeof == 56
+
+// BoardRAM shared with the Character Doors, packed by Tools/board_ram_alloc.py --write.
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Character Swap" board.
+// Re-run the tool instead of editing these by hand.  Event: Swap Character
+#define BOARD_RAM_LAYOUT_VERSION                 1
+extern u8 D_800CD098;
+extern u8 D_800CD0A0;
+extern u8 D_800CD0A8;
+#define CHARACTER_DOOR_DYNAMIC_MODE_BYTE         D_800CD0A8
+#define CHARACTER_DOOR_DYNAMIC_MODE_SHIFT        6
+#define CHARACTER_DOOR_DYNAMIC_MODE_WIDTH        2
+#define CHARACTER_DOOR_STATE                     (&D_800CD0A0)
+#define CHARACTER_DOOR_STATE_SIZE                6
+#define BONUS_BIDS_TALLIES                       (&D_800CD098)
+#define BONUS_BIDS_TALLIES_SIZE                  8
+//******************** /BOARD RAM SLOTS ***************************************
+
+// The next door ahead of every space, packed by Tools/door_lookahead.py --write.  The Character Swap
+// board has no art yet, so this comes from its layout draft, character_swap_layout.json next to this file.
+//******************** DOOR LOOKAHEAD (generated) *****************************
+// Generated by Tools/door_lookahead.py for the "Character Swap" board, looking 10 steps ahead.
+// Re-run the tool instead of editing these by hand.
+#define DOOR_LOOKAHEAD_SPACE_COUNT               48
+#define DOOR_LOOKAHEAD_STEPS                     10
+static const u8 DOOR_LOOKAHEAD[48] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x29,
+    0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x29, 0x52, 0x52, 0x52,
+    0x52, 0x52, 0x52, 0x52, 0x7B, 0x7B, 0x7B, 0x7B, 0x7B, 0x7B, 0x7B, 0x7B,
+    0x00, 0x29, 0x29, 0x29, 0x29, 0x29, 0x52, 0x7B, 0x7B, 0x7B, 0x7B, 0xFF
+};
+//******************** /DOOR LOOKAHEAD ****************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+
+// DOOR_LOOKAHEAD entries: [2:0] DOOR_INDEX, [4:3] placed category, [6:5] OPEN_MODE
+#define DOOR_LOOKAHEAD_NONE     0xFF
+#define LOOKAHEAD_DOOR_INDEX(entry)     ((entry) & 7)
+#define LOOKAHEAD_CATEGORY(entry)       (((entry) >> 3) & 3)
+#define LOOKAHEAD_OPEN_MODE(entry)      (((entry) >> 5) & 3)
+
+// Same numbering as Character Door
+#define CATEGORY_PLUMBER   0
+#define CATEGORY_PRINCESS  1
+#define CATEGORY_BEAST     2
+#define CATEGORY_VILLAIN   3
+
+#define MODE_MATCHING_ONLY      0
+#define MODE_MATCHING_WITH_FEES 1
+#define MODE_ALL_BUT_MATCHING   2
+#define MODE_DYNAMIC            3
+#define MODE_OPEN_TO_ALL        4
+
+#define RELATION_MATCHING       0
+#define RELATION_ENEMY          3
+
+#define DOOR_STATE_BITS         6
+#define DOOR_OFFSET_SHIFT       4
+
+// Bonus Bids tallies, numbered as in the Bonus Bids engine: entry (tally * 4) + player, 5 bits each.
+#define TALLY_SWAPS             0
+#define TALLY_BITS              5
+#define TALLY_MAX               31
+
+// How a character fares at a door
+#define DOOR_SCORE_BLOCKED      0
+#define DOOR_SCORE_PAYS_FEE     1
+#define DOOR_SCORE_FREE         2
+
+#define CHARACTER_COUNT         8
+
+// Indexed by Player.character: Mario, Luigi, Peach, Yoshi, Wario, DK, Waluigi, Daisy
+static const u8 CHARACTER_CATEGORY[CHARACTER_COUNT] = {
+    CATEGORY_PLUMBER, CATEGORY_PLUMBER, CATEGORY_PRINCESS, CATEGORY_BEAST,
+    CATEGORY_VILLAIN, CATEGORY_BEAST, CATEGORY_VILLAIN, CATEGORY_PRINCESS
+};
+
+static const u8 DYNAMIC_OPEN_MODE[4] = {
+    MODE_OPEN_TO_ALL, MODE_MATCHING_ONLY, MODE_MATCHING_WITH_FEES, MODE_ALL_BUT_MATCHING
+};
+
+// Indexed by Player.character, for the character prompt
+static const char* CHARACTER_NAMES[CHARACTER_COUNT] = {
+    "Mario", "Luigi", "Peach", "Yoshi", "Wario", "Donkey Kong", "Waluigi", "Daisy"
+};
+
+// Prompt answers
+#define OFFER_SWAP              0
+#define OFFER_KEEP              1
+
+void main() {
+    int currentPlayer = GetCurrentPlayerIndex();
+    struct Player* player = GetPlayerStruct(currentPlayer);
+    int unusedMask = GetUnusedCharacterMask();
+
+    // CPUs swap to whatever the planner picks, or keep their character when nothing does better.
+    int cpuCharacter = PickCPUCharacter(currentPlayer, unusedMask);
+
+    ShowMessage(5, GetSwapOfferMessage(), 0, 0, 0, 0, 0);
+    int choice = GetBasicPromptSelection(2, (cpuCharacter == player->character) ? OFFER_KEEP : OFFER_SWAP);
+    mp3_TeardownMessageBox();
+    if (choice != OFFER_SWAP) {
+        return;
+    }
+
+    u8 characters[4];
+    int cpuChoice = 0;
+    int count = 0;
+    int character;
+    for (character = 0; character < CHARACTER_COUNT && count < 4; character++) {
+        if (unusedMask & (1 << character)) {
+            if (character == cpuCharacter) {
+                cpuChoice = count;
+            }
+            characters[count++] = character;
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+
+    ShowMessage(5, GetCharacterChoiceMessage(characters, count), 0, 0, 0, 0, 0);
+    choice = GetBasicPromptSelection(2, cpuChoice);
+    mp3_TeardownMessageBox();
+
+    player->character = characters[choice];
+#ifdef BONUS_BIDS_TALLIES
+    if (COUNTS_FOR_BONUS_BIDS == 1) {
+        AddToTally(TALLY_SWAPS, currentPlayer);
+    }
+#endif
+    mp3_ReloadCurrentSceneWithTransition(2);    // Reload the board so it draws the new character
+}
+
+// Returns the DOOR_LOOKAHEAD entry for the space the player is standing on: one table lookup.
+int GetNextDoorEntry(struct Player* player) {
+    int space = GetAbsSpaceIndexFromChainSpaceIndex(player->cur_chain_index, player->cur_space_index);
+    if (space < 0 || space >= DOOR_LOOKAHEAD_SPACE_COUNT) {
+        return DOOR_LOOKAHEAD_NONE;
+    }
+    return DOOR_LOOKAHEAD[space];
+}
+
+// Works out which mode and category a door is using right now, then how this character fares there.
+int ScoreCharacterForDoor(int character, int doorEntry) {
+    if (doorEntry == DOOR_LOOKAHEAD_NONE) {
+        return DOOR_SCORE_FREE;
+    }
+
+    int doorState = mplib_GetPackedField(CHARACTER_DOOR_STATE, LOOKAHEAD_DOOR_INDEX(doorEntry), DOOR_STATE_BITS);
+    int preferredCategory = (LOOKAHEAD_CATEGORY(doorEntry) + (doorState >> DOOR_OFFSET_SHIFT)) & 3;
+    int openMode = LOOKAHEAD_OPEN_MODE(doorEntry);
+    if (openMode == MODE_DYNAMIC) {
+        openMode = DYNAMIC_OPEN_MODE[mplib_GetField(CHARACTER_DOOR_DYNAMIC_MODE)];
+    }
+
+    int relation = CHARACTER_CATEGORY[character & 7] ^ preferredCategory;
+    switch (openMode) {
+        case MODE_OPEN_TO_ALL:
+            return DOOR_SCORE_FREE;
+        case MODE_MATCHING_WITH_FEES:
+            if (relation == RELATION_MATCHING) {
+                return DOOR_SCORE_FREE;
+            }
+            return (relation == RELATION_ENEMY) ? DOOR_SCORE_BLOCKED : DOOR_SCORE_PAYS_FEE;
+        case MODE_ALL_BUT_MATCHING:
+            return (relation != RELATION_MATCHING) ? DOOR_SCORE_FREE : DOOR_SCORE_BLOCKED;
+        case MODE_MATCHING_ONLY:
+        default:
+            return (relation == RELATION_MATCHING) ? DOOR_SCORE_FREE : DOOR_SCORE_BLOCKED;
+    }
+}
+
+// Picks the character a CPU should swap to, out of candidateMask (bit N set = character N allowed).
+// Keeps its current character unless a candidate does better at the next door.
+int PickCPUCharacter(int playerIndex, int candidateMask) {
+    struct Player* player = GetPlayerStruct(playerIndex);
+    int doorEntry = GetNextDoorEntry(player);
+    int bestCharacter = player->character;
+    int bestScore = ScoreCharacterForDoor(bestCharacter, doorEntry);
+    int character;
+
+    for (character = 0; character < CHARACTER_COUNT; character++) {
+        if (!(candidateMask & (1 << character))) {
+            continue;
+        }
+        int score = ScoreCharacterForDoor(character, doorEntry);
+        if (score > bestScore) {
+            bestScore = score;
+            bestCharacter = character;
+        }
+    }
+    return bestCharacter;
+}
+
+#ifdef BONUS_BIDS_TALLIES
+// Adds one to a player's tally.  Same as in the Bonus Bids engine.
+void AddToTally(int tally, int playerIndex) {
+    int index = (tally * 4) + playerIndex;
+    int count = mplib_GetPackedField(BONUS_BIDS_TALLIES, index, TALLY_BITS);
+    if (count < TALLY_MAX) {
+        mplib_SetPackedField(BONUS_BIDS_TALLIES, index, TALLY_BITS, count + 1);
+    }
+}
+#endif
+
+// Bit N set = character N isn't being played by anyone.  These are the choices in Swap Only mode.
+int GetUnusedCharacterMask() {
+    int unused = mplib_BitMask(CHARACTER_COUNT);
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        struct Player* player = GetPlayerStruct(i);
+        unused &= ~(1 << player->character);
+    }
+    return unused;
+}
+
+// Asks the player whether they want to swap, with Swap / Keep options in OFFER_ order.
+char* GetSwapOfferMessage() {
+    char* message = func_80035934(256);
+    bzero(message, 256);
+
+    mplib_strcpy(message, "\x0B");                              // Start the message
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    mplib_strncat(message, "Want to be somebody else for a while");
+    mplib_strncat(message, "\xC3");                             // ?
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");       // Little more padding for option indent
+    mplib_strncat(message, "\x0C");                             // Start option
+    mplib_strncat(message, "Swap characters");
+    mplib_strncat(message, "\x0D");                             // End option
+    mplib_strncat(message, "\x0A");                             // Newline
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");       // Little more padding for option indent
+    mplib_strncat(message, "\x0C");                             // Start option
+    mplib_strncat(message, "Stay as I am");
+    mplib_strncat(message, "\x0D");                             // End option
+    mplib_strncat(message, "\xFF");                             // Show prompt to continue arrow
+
+    return message;
+}
+
+// Lists the characters to pick from, one option per line.  At most 4, so it fits the message box
+// with its question line, like the trivia quiz's questions.
+char* GetCharacterChoiceMessage(u8* characters, int count) {
+    char* message = func_80035934(256);
+    bzero(message, 256);
+    int i;
+
+    mplib_strcpy(message, "\x0B");                              // Start the message
+    mplib_strncat(message, "\x1A\x1A\x1A\x1A");               // Standard padding for portrait
+    mplib_strncat(message, "Who do you want to be");
+    mplib_strncat(message, "\xC3");                             // ?
+    for (i = 0; i < count; i++) {
+        mplib_strncat(message, "\x0A");                         // Newline
+        mplib_strncat(message, "\x1A\x1A\x1A\x1A\x1A\x1A");   // Little more padding for option indent
+        mplib_strncat(message, "\x0C");                         // Start option
+        mplib_strncat(message, CHARACTER_NAMES[characters[i]]);
+        mplib_strncat(message, "\x0D");                         // End option
+    }
+    mplib_strncat(message, "\xFF");                             // Show prompt to continue arrow
+
+    return message;
+}
+
+//***************************************************************************//
+//***************************************************************************//
+//****************************                  *****************************//
+//*************************      mplib v2.3        **************************//
+//****************************                  *****************************//
+//***************************************************************************//
+//***************************************************************************//
+//***      Some helper functions to make up for lack of stdlib.io; and    ***//
+//***     to hide the complexity of some Mario Party-specific functions   ***//
+//***************************************************************************//
+//***************************************************************************//
+// Paste this at the bottom of an event file to get access to helpful functions during development!
+// Then, when you are ready to ship, delete the functions you don't use to save space and remove clutter.
+//
+// Get the latest version or submit changes at: 
+// https://github.com/C-Kennelly/mario-party-custom-events
+//***************************************************************************//
+//
+// Looking for another function?  
+// Have you checked the PartyPlanner64 symbols table yet?
+// https://github.com/PartyPlanner64/symbols/blob/master/MarioParty3U.sym
+//***************************************************************************//
+
+
+// Packed arrays: the same small field repeated back to back in a run of bytes, like one entry per
+// Character Door in a BOARD_RAM_BYTES block.  Entry N of a W-bit array starts at bit N*W, counting
+// from bit 0 of the first byte, so 8 doors of 6 bits fit in 6 bytes.  An entry can straddle two
+// bytes; W can be 1-8.
+int mplib_GetPackedField(u8 *block, int index, int width)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+
+    int window = bytes[0];
+    if(shift + width > 8)
+    {
+        window |= bytes[1] << 8;
+    }
+    return (window >> shift) & mplib_BitMask(width);
+}
+
+void mplib_SetPackedField(u8 *block, int index, int width, int value)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+    int mask = mplib_BitMask(width) << shift;
+    int bits = (value << shift) & mask;
+
+    bytes[0] = (bytes[0] & ~mask) | bits;
+    if(shift + width > 8)
+    {
+        bytes[1] = (bytes[1] & ~(mask >> 8)) | (bits >> 8);
+    }
+}
+
+// Helper function that just does teardown of a message box.
+// Split out so it can be used after waiting for confirmation 
+// or getting a selection choice.
+void mp3_TeardownMessageBox()
+{
+    CloseMessage();     //Close the message
+    func_800EC6EC();    //Message box teardown
+}
+
+// Long-form implementation from:
+// https://www.techiedelight.com/implement-strcpy-function-c/
+//
+// Function to implement strcpy() function
+char* mplib_strcpy(char* destination, const char* source)
+{
+    // return if no memory is allocated to the destination
+    if (destination == NULL)
+        return NULL;
+ 
+    // take a pointer pointing to the beginning of destination string
+    char *ptr = destination;
+ 
+    // copy the C-string pointed by source into the array
+    // pointed to by destination
+    while (*source != '\0')
+    {
+        *destination = *source;
+        destination++;
+        source++;
+    }
+ 
+    // include the terminating null character
+    *destination = '\0';
+ 
+    // destination is returned by standard strcpy()
+    return ptr;
+}
+
+// Second implementation from this site:
+// https://www.techiedelight.com/implement-strncat-function-c/#:~:text=The%20strncat()%20function%20appends,pointer%20to%20the%20destination%20string
+// Stripped out the "num" prototype so that strncat always appends the full string passed, instead of a defined subset.
+
+// Function to implement strncat() function in C
+char* mplib_strncat(char* destination, const char* source)
+{
+    int i, j;
+ 
+    // move to the end of destination string
+    for (i = 0; destination[i] != '\0'; i++);
+ 
+    // i now points to terminating null character in destination
+ 
+    // Appends num characters of source to the destination string
+    for (j = 0; source[j] != '\0'; j++)
+        destination[i + j] = source[j];
+ 
+    // null terminate destination string
+    destination[i + j] = '\0';
+ 
+    // destination is returned by standard strncat()
+    return destination;
+}
+
+// Reloads the scene with the given transition type. Big credit to Rain for figuring out how this works.
+// These are required to define the functions we use in ReloadScene below().
+extern s32 D_800A12D4;
+void func_8004F010(s32);
+void func_800F8C74(void);
+void func_8004819C(s32);
+void func_8004849C(void);
+void func_8004F074(void);
+
+void mp3_ReloadCurrentSceneWithTransition(int transitionType)
+{
+	InitFadeOut(transitionType, 0x10);
+	SleepProcess(0x11);
+	D_800A12D4 = 1;
+	func_800F8C74();
+	func_8004819C(1);
+	func_8004849C();
+	func_8004F074();
+}
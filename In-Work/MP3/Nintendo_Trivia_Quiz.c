@@ -6,6 +6,8 @@
 // PARAM: +Number|EASY_CPU_ACCURACY_PERCENT
 // PARAM: +Number|NORMAL_CPU_ACCURACY_PERCENT
 // PARAM: +Number|HARD_CPU_ACCURACY_PERCENT
+// PARAM: Boolean|COUNTS_FOR_BONUS_BIDS
+// BOARD_RAM_BYTES: Bonus Bids.BONUS_BIDS_TALLIES|8|COUNTS_FOR_BONUS_BIDS
 
 #ifndef USES_BOARD_RAM
 #define USES_BOARD_RAM 1
@@ -27,6 +29,10 @@
 #define HARD_CPU_ACCURACY_PERCENT 75
 #endif
 
+#ifndef COUNTS_FOR_BONUS_BIDS
+#define COUNTS_FOR_BONUS_BIDS 1
+#endif
+
 //***************************************************************************//
 //******************** BOARD RAM WARNING ************************************//
 //***************************************************************************//
@@ -44,13 +50,18 @@
 // the use of board RAM, the questions will still be randomly selected, but they may repeat.
 //
 // If you're not sure what this parameter does, just set the "USES BOARD RAM" to true. =)
+//
+// On a board with the Bonus Bids events, the quiz also adds each right answer to the
+// "most right quiz answers" tally in BONUS_BIDS_TALLIES.  Tools/board_ram_alloc.py places those
+// bytes and fills in the BOARD RAM SLOTS block below; they're shared with Bonus Bids, so they're
+// kept even with "USES_BOARD_RAM" set to "False".  Set "COUNTS_FOR_BONUS_BIDS" to "False" to skip it.
 
 //***************************************************************************//
 //******************** Version Info! ****************************************//
 //***************************************************************************//
 
 
-// This is version: 1.2
+// This is version: 1.3
 //
 // There may be an update available at:
 // https://github.com/c-kennelly/mario-party-custom-events
@@ -106,6 +117,9 @@
 //***************************************************************************//
 //***********************     Changelist      *******************************//
 //***************************************************************************//
+//   Version 1.3    - Right answers count toward the Bonus Bids "most right quiz answers" tally.
+//                    The question message is malloc()'d at the size it needs instead of returned
+//                    from a 1024-byte stack array, and the unused 1024-byte block is gone.
 //   Version 1.2    - Brought number of questions up to 64 for release.
 //   Version 1.15   - Added ability to disable the event's use of Board RAM. 
 //                    Reorganized comments a bit.
@@ -136,6 +150,11 @@
 // How many questions should the quiz use?
 #define ACTIVE_QUESTIONS 64
 
+// Bytes malloc()'d for a question with its four options.  The longest in the bank (index 36) takes
+// 229; this is that rounded up to 8, as "Tools/event_harness.py buffers" reports it.  Adding a longer
+// question?  Re-run the harness and raise this to match.
+#define QUESTION_MESSAGE_SIZE 232
+
 // The character portrait of the character who is giving the quiz.
 #define QUIZ_GIVER_PORTRAIT 3
 // Want to change the picture?  Find options on the PartyPlanner64 wiki:
@@ -157,6 +176,17 @@ extern u8 D_800CD0A0;
 extern u8 D_800CD0A1;
 extern u8 D_800CD098;
 
+//******************** BOARD RAM SLOTS (generated) ****************************
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+
+// Bonus Bids tallies, numbered as in the Bonus Bids engine: entry (tally * 4) + player, 5 bits each.
+#define TALLY_QUIZ              2
+#define TALLY_BITS              5
+#define TALLY_MAX               31
+
 // Reference wiki article can be found here:
 // https://github.com/PartyPlanner64/PartyPlanner64/wiki/Player-Structs
 struct Player {
@@ -274,6 +304,9 @@ int PickQuestionIndex()
 
         // If we haven't set a StepValue, it's the first time the event is called.
         // So we need to initialize the quiz data.
+        // StepValue is never 0 once it's set, so with a Board State Header on the board (which zeroes
+        // board RAM when a game starts) this is exact.  Without one, the last game's StepValue is still
+        // here and the quiz carries on with its question order, which never repeats a question either.
         if(D_800CD098 == 0)
         {
             InitializeQuizData();
@@ -475,10 +508,29 @@ void RewardPlayerForCorrectAnswer()
         char *right_msg = GetMessageForRightAnswer();
         mp3_ShowMessageWithConfirmation(QUIZ_GIVER_PORTRAIT, right_msg);
         GraduallyAdjustPlayerCoins(COIN_REWARD);
+#ifdef BONUS_BIDS_TALLIES
+        if(COUNTS_FOR_BONUS_BIDS == 1)
+        {
+            AddToTally(TALLY_QUIZ, GetCurrentPlayerIndex());
+        }
+#endif
 
         return;
 }
 
+#ifdef BONUS_BIDS_TALLIES
+// Adds one to a player's tally.  Same as in the Bonus Bids engine.
+void AddToTally(int tally, int playerIndex)
+{
+    int index = (tally * 4) + playerIndex;
+    int count = mplib_GetPackedField(BONUS_BIDS_TALLIES, index, TALLY_BITS);
+    if(count < TALLY_MAX)
+    {
+        mplib_SetPackedField(BONUS_BIDS_TALLIES, index, TALLY_BITS, count + 1);
+    }
+}
+#endif
+
 // When the player gets an answer wrong, run this logic.
 void PunishPlayerForIncorrectAnswer()
 {
@@ -643,9 +695,7 @@ char* GetMessageforWrongAnswer()
 // to the first question.
 char* GetQuestionByNumber(int question, int* correctAnswerPtr)
 {
-    char* result = func_80035934(1024);         // malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
-                                                // transition, such as a minigame.  Or, you can call free() with func_80035958(ptr)
-    bzero(result, 1024);                        // Zero out the memory allocated above so we don't get unexpected behavior.
+    char* result;                               // Every question builds its own message, so there's nothing to malloc() here.
 
     switch (question)
     {
@@ -2226,8 +2276,8 @@ char* CreateSimpleThreeLineQuestionMessage(char* questionLineOne, char* question
 // Answer order will be randomized and the index of the correct answer will be returned via the correctAnswerIndexPtr parameter.
 char* GenerateMessageForQuestionWithFourOptions(char* question, char* correctAnswer, char* wrongAnswer1, char* wrongAnswer2, char* wrongAnswer3, int* correctAnswerIndexPtr)
 {
-    char result[1024];
-    bzero(result, 1024);                                     //Zero out result for safety.
+    char* result = func_80035934(QUESTION_MESSAGE_SIZE);     // malloc() to reserve memory from the heap, since the message outlives this function.
+    bzero(result, QUESTION_MESSAGE_SIZE);                    // Zero out the memory allocated above so we don't get unexpected behavior.
 
     char* randomizedOptions[4];
     *correctAnswerIndexPtr = RandomizeOptionOrder(&randomizedOptions, correctAnswer, wrongAnswer1, wrongAnswer2, wrongAnswer3);
@@ -2437,7 +2487,7 @@ int mp3_PickARandomNumberBetween0AndN(int n)
     int result = GetRandomByte();                   //Get a random number by picking a random byte.
     
     int randMax = 255;                              // 255 is the maximum value of a byte.
-    int randExcess = (randMax % n) + 1;             // Caluclate the biased remainder.  1/256 edge case when (randMax == n) but the result is just some wasted cycles, so acceptable.
+    int randExcess = (randMax + 1) % n;             // Calculate the biased remainder: how many of the 256 byte values don't fill a whole set of n.
     int randLimit = randMax - randExcess;           // Anything above randLimit would create modulo bias, so...
     while (result > randLimit)                      // Reject any random bytes with values above randLimit...
     {
@@ -2467,7 +2517,7 @@ int mp3_ReturnTruePercentOfTime(int percentChanceOfTrue)
     }
     else
     {
-        int randValue = mp3_PickARandomNumberBetween0AndN(99);
+        int randValue = mp3_PickARandomNumberBetween0AndN(100);
         if (randValue < percentChanceOfTrue)
         {
             return 1;
@@ -2627,6 +2677,39 @@ int my_max4(int a1, int a2, int a3, int a4)
     return result;
 }
 
+// Packed arrays: the same small field repeated back to back in a run of bytes, like one entry per
+// Character Door in a BOARD_RAM_BYTES block.  Entry N of a W-bit array starts at bit N*W, counting
+// from bit 0 of the first byte, so 8 doors of 6 bits fit in 6 bytes.  An entry can straddle two
+// bytes; W can be 1-8.
+int mplib_GetPackedField(u8 *block, int index, int width)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+
+    int window = bytes[0];
+    if(shift + width > 8)
+    {
+        window |= bytes[1] << 8;
+    }
+    return (window >> shift) & mplib_BitMask(width);
+}
+
+void mplib_SetPackedField(u8 *block, int index, int width, int value)
+{
+    int bitOffset = index * width;
+    u8 *bytes = block + (bitOffset >> 3);
+    int shift = bitOffset & 7;
+    int mask = mplib_BitMask(width) << shift;
+    int bits = (value << shift) & mask;
+
+    bytes[0] = (bytes[0] & ~mask) | bits;
+    if(shift + width > 8)
+    {
+        bytes[1] = (bytes[1] & ~(mask >> 8)) | (bits >> 8);
+    }
+}
+
 //***************************************************************************//
 //***************************************************************************//
 //*************************                  ********************************//
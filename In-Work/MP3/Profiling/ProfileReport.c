@@ -0,0 +1,494 @@
+// NAME: Profile Report
+// GAMES: MP3_USA
+// EXECUTION: Direct
+// PARAM: Boolean|RESET_AFTER_REPORT
+// BOARD_RAM: MP3LIB_INSTANCE_TABLE_HI|8
+// BOARD_RAM: MP3LIB_INSTANCE_TABLE_MID|8
+// BOARD_RAM: MP3LIB_INSTANCE_TABLE_LO|8
+// BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+// BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+
+// Redefining params here for vs code highlighting, not actually used in partyplanner.
+#ifndef RESET_AFTER_REPORT
+    #define RESET_AFTER_REPORT 1
+#endif
+
+//***************************************************************************//
+//******************** Version Info! ****************************************//
+//***************************************************************************//
+//
+// This is version: 1.1
+//
+// There may be an update available at:
+// https://github.com/c-kennelly/mario-party-custom-events
+// You can also report a bug as an issue (and maybe a PR that fixes it?)
+
+
+//***************************************************************************//
+//******************** BOARD RAM WARNING ************************************//
+//***************************************************************************//
+// This event uses the mp3lib instance table, which keeps its address in three board RAM bytes
+// shared by every event that uses it, and reads the board state header:
+//              MP3LIB_INSTANCE_TABLE_HI/MID/LO     3 bytes - address of the table on the perm heap
+//              MP3LIB_BOARD_STATE_STAMP/CHECK      14 bits - the board's Board State Header
+//
+// Run "python3 Tools/board_ram_alloc.py your_board.json --write" to place them around the other
+// events on your board.  Place your board's copy of the "Board State Header" event too: without a
+// current header there's no profile table, and this event has nothing to show.
+
+
+//***************************************************************************//
+//*********************** Description ***************************************//
+//***************************************************************************//
+// A DEBUG event: don't ship a board with it.
+//
+// Shows the mp3lib profile table, one message box per phase: how many times each phase ran, the
+// microseconds it took in all, and its slowest single run.  The phases are whatever the other events
+// on the board wrapped in mp3_ProfileBegin()/mp3_ProfileEnd() (see the "Profiling" section of mp3lib),
+// so this is how you get real console or emulator timings to check against the numbers
+// Tools/event_harness.py gives on the PC.
+//
+// Place it wherever you want to read the numbers out: on a space you can walk onto, or as a
+// "Before Turn" board event to see them every turn.
+//
+// RESET_AFTER_REPORT - True empties the table after showing it, so each report covers what happened
+//                      since the last one.  False keeps adding up for the whole game.
+
+
+//***************************************************************************//
+//***********************     Changelist      *******************************//
+//***************************************************************************//
+//   Version 1.1 - The profile table is stamped with the board state header's per-game seed, so a table
+//                 left on the perm heap by another game is never reused.
+//   Version 1.0 - First version of the event!
+
+
+//***************************************************************************//
+//*************************** Declarations **********************************//
+//***************************************************************************//
+
+// Header file: http://n64devkit.square7.ch/header/ultra64.htm
+// Ultratypes: http://n64devkit.square7.ch/header/ultratypes.htm
+// For more exploration: http://n64devkit.square7.ch/header/
+#include "ultra64.h"
+
+extern s8 D_800CD05B;       // current_turn from the mp3 sym table.  Starts at 1.
+
+// Board RAM slots, filled in by Tools/board_ram_alloc.py --write:
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Game Night" board.
+// Re-run the tool instead of editing these by hand.  Event: Profile Report
+#define BOARD_RAM_LAYOUT_VERSION                 1
+extern u8 D_800CD099;
+extern u8 D_800CD09A;
+extern u8 D_800CD09B;
+extern u8 D_800CD09C;
+extern u8 D_800CD09D;
+#define MP3LIB_BOARD_STATE_STAMP_BYTE            D_800CD09D
+#define MP3LIB_BOARD_STATE_STAMP_SHIFT           0
+#define MP3LIB_BOARD_STATE_STAMP_WIDTH           6
+#define MP3LIB_BOARD_STATE_CHECK_BYTE            D_800CD099
+#define MP3LIB_BOARD_STATE_CHECK_SHIFT           0
+#define MP3LIB_BOARD_STATE_CHECK_WIDTH           8
+#define MP3LIB_INSTANCE_TABLE_HI_BYTE            D_800CD09A
+#define MP3LIB_INSTANCE_TABLE_HI_SHIFT           0
+#define MP3LIB_INSTANCE_TABLE_HI_WIDTH           8
+#define MP3LIB_INSTANCE_TABLE_MID_BYTE           D_800CD09B
+#define MP3LIB_INSTANCE_TABLE_MID_SHIFT          0
+#define MP3LIB_INSTANCE_TABLE_MID_WIDTH          8
+#define MP3LIB_INSTANCE_TABLE_LO_BYTE            D_800CD09C
+#define MP3LIB_INSTANCE_TABLE_LO_SHIFT           0
+#define MP3LIB_INSTANCE_TABLE_LO_WIDTH           8
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_SetBits(byte, shift, width, value)    ((byte) = ((byte) & ~(mplib_BitMask(width) << (shift))) \
+                                                        | (((value) & mplib_BitMask(width)) << (shift)))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_SetField(NAME, value)                 mplib_SetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH, value)
+
+// Board state header, instance table and profile table, from mp3lib.
+#define MP3_BOARD_STATE_VERSION_SHIFT   4
+#define MP3_BOARD_STATE_SEED_MASK       0x0F
+
+#define MP3_INSTANCE_TABLE_MAGIC        0x494E5354                      // "INST"
+#define MP3_INSTANCE_TABLE_BITS         5
+#define MP3_INSTANCE_TABLE_CAPACITY     (1 << MP3_INSTANCE_TABLE_BITS)  // 32 placements per board
+#define MP3_INSTANCE_STATE_BYTES        4
+
+struct mp3_InstanceEntry {
+    u32 key;                                // Chain (bits 31-24), space (23-16), event tag (15-8), 1 = in use (bit 0).  0 is empty.
+    u8 state[MP3_INSTANCE_STATE_BYTES];     // Yours to use.  Starts zeroed.
+}; // sizeof == 8
+
+struct mp3_InstanceTable {
+    u32 magic;                              // MP3_INSTANCE_TABLE_MAGIC, so we can tell a live table from a stale address
+    u32 seed;                               // The board state header's seed for the game that built the table
+    u32 count;                              // Entries in use
+    struct mp3_InstanceEntry entries[MP3_INSTANCE_TABLE_CAPACITY];
+}; // sizeof == 268
+
+#define MP3_PROFILE_MAGIC           0x50524F46      // "PROF"
+#define MP3_PROFILE_EVENT_TAG       0xFE
+#define MP3_PROFILE_SLOTS           8
+#define MP3_PROFILE_NAME_BYTES      16
+#define MP3_PROFILE_TICKS_PER_MS    46875           // Count ticks a millisecond
+
+struct mp3_ProfileSlot {
+    char name[MP3_PROFILE_NAME_BYTES];      // The phase, 0-terminated
+    u32 start;                              // Count at the last mp3_ProfileBegin
+    u32 total;                              // Ticks between Begin and End, every call added up
+    u32 longest;                            // Ticks of the slowest call
+    u32 calls;
+}; // sizeof == 32
+
+struct mp3_ProfileTable {
+    u32 magic;                              // MP3_PROFILE_MAGIC
+    u32 seed;                               // The board state header's seed for this game
+    u32 count;                              // Slots in use
+    struct mp3_ProfileSlot slots[MP3_PROFILE_SLOTS];
+}; // sizeof == 268
+
+
+//***************************************************************************//
+//*************************** Event Logic ************************************//
+//***************************************************************************//
+
+void main()
+{
+    mp3_ProfileShow();
+
+    if(RESET_AFTER_REPORT)
+    {
+        mp3_ProfileReset();
+    }
+}
+
+
+//***************************************************************************//
+//***************************************************************************//
+//****************************                  *****************************//
+//*************************      mp3lib v1.0       **************************//
+//****************************                  *****************************//
+//***************************************************************************//
+//***************************************************************************//
+//***      Some helper functions to make up for lack of stdlib.io; and    ***//
+//***     to hide the complexity of some Mario Party-specific functions   ***//
+//***************************************************************************//
+//***************************************************************************//
+// NOTE - this instance of mp3lib is pared down just to the functions used in this event
+//
+// Get the latest version or submit changes at:
+// https://github.com/C-Kennelly/mario-party-custom-events
+//***************************************************************************//
+
+// As mp3_DebugMessage, but appends the prompt arrow to the end of the message so the message doesn't flash by.
+void mp3_DebugMessageWithConfirmation(char* message)
+{
+	char* result = func_80035934(256);      // First, malloc() to reserve memory from the heap.  Heap is cleared during any MP3 scene 
+                                            // transition, such as a minigame.  Or, you can call free() with func_80035958(ptr)
+    bzero(result, 256);                     // Second, zero out the memory allocated above so we don't get unexpected behavior.
+
+	mplib_strncat(result, message);                                 //Store the passed message in the buffer
+	mplib_strncat(result, "\xFF");                                  //Append the prompt to continue arrow so the message doesn't flash by
+	mp3_ShowMessageWithConfirmation(-1, result);
+}
+
+// Helper function that shows a message and then tears the message box down
+// after the player confirms the last box.  Don't use for prompt selection.
+void mp3_ShowMessageWithConfirmation(int characterPortraitIndex, char* message)
+{
+    // This function assumes you aren't using the additional arguments
+    // of ShowMessage() and hardcodes them to 0.  If you want to use them,
+    // add them to the wrapper function and pass through.
+
+    ShowMessage(characterPortraitIndex, message, 0, 0, 0, 0, 0);
+    mp3_WaitForPlayerConfirmation();
+    mp3_TeardownMessageBox();
+
+}
+
+// A wrapper for the "wait for confimration" command in MP3
+void mp3_WaitForPlayerConfirmation()
+{
+    func_800EC9DC();    //Wait for confirmation
+}
+
+// Helper function that just does teardown of a message box.
+// Split out so it can be used after waiting for confirmation 
+// or getting a selection choice.
+void mp3_TeardownMessageBox()
+{
+    CloseMessage();     //Close the message
+    func_800EC6EC();    //Message box teardown
+}
+
+// Turn 1 always gets the base value for the version and seed, and every later turn gets one of the
+// other 255 values.  So a header stamped on any later turn of any game can never pass for a turn 1 header.
+int mp3_BoardStateCheck(int layoutVersion, int seed, int turn)
+{
+    int base = ((seed * 0x9D) + (layoutVersion * 0x3B)) & 0xFF;
+    if(turn <= 1)
+    {
+        return base;
+    }
+    return base ^ (1 + ((turn - 2) % 255));
+}
+
+int mp3_GetBoardStateSeed(u8 stamp)
+{
+    return stamp & MP3_BOARD_STATE_SEED_MASK;
+}
+
+// Returns 1 if the header was stamped by this game on this turn or the one before it.
+// On turn 1 only a turn 1 stamp counts, which is what catches a previous game's leftovers.
+int mp3_IsBoardStateHeaderCurrent(u8 stamp, u8 check, int layoutVersion, int turn)
+{
+    int seed = mp3_GetBoardStateSeed(stamp);
+    if((seed == 0) || (((stamp >> MP3_BOARD_STATE_VERSION_SHIFT) & 3) != (layoutVersion & 3)))
+    {
+        return 0;
+    }
+
+    if(check == mp3_BoardStateCheck(layoutVersion, seed, turn))
+    {
+        return 1;   // Already stamped this turn, e.g. the scene was reloaded.
+    }
+    return (turn > 1) && (check == mp3_BoardStateCheck(layoutVersion, seed, turn - 1));
+}
+
+// Returns this game's seed (1-15) if the header is current, or 0 if it isn't, i.e. board RAM can't be
+// trusted to belong to this game.  Declare the header's fields in your event to call this:
+//
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+int mp3_GetCurrentBoardStateSeed()
+{
+    u8 stamp = mplib_GetField(MP3LIB_BOARD_STATE_STAMP);
+    if(!mp3_IsBoardStateHeaderCurrent(stamp, mplib_GetField(MP3LIB_BOARD_STATE_CHECK), BOARD_RAM_LAYOUT_VERSION, D_800CD05B))
+    {
+        return 0;
+    }
+    return mp3_GetBoardStateSeed(stamp);
+}
+
+// Returns 1 if address could be a perm heap block: word aligned, and inside the 8MB of RDRAM.
+int mplib_IsRDRAMAddress(u32 address)
+{
+    return (address >= 0x80000000) && (address < 0x80800000) && ((address & 3) == 0);
+}
+
+// Returns this game's instance table, allocating it on first use.  NULL if the board state header
+// isn't current, since then there's no telling this game's table from another one's.
+struct mp3_InstanceTable* mp3_GetInstanceTable()
+{
+    int seed = mp3_GetCurrentBoardStateSeed();
+    if(seed == 0)
+    {
+        return NULL;
+    }
+
+    u32 address = (mplib_GetField(MP3LIB_INSTANCE_TABLE_HI) << 16)
+                | (mplib_GetField(MP3LIB_INSTANCE_TABLE_MID) << 8)
+                |  mplib_GetField(MP3LIB_INSTANCE_TABLE_LO);
+    struct mp3_InstanceTable *table = (struct mp3_InstanceTable*)(0x80000000 | address);
+
+    if((address != 0) && mplib_IsRDRAMAddress((u32)table) && (table->magic == MP3_INSTANCE_TABLE_MAGIC)
+        && (table->seed == seed))
+    {
+        return table;
+    }
+
+    table = MallocPerm(sizeof(struct mp3_InstanceTable));
+    bzero(table, sizeof(struct mp3_InstanceTable));
+    table->magic = MP3_INSTANCE_TABLE_MAGIC;
+    table->seed = seed;
+
+    address = ((u32)table) & 0xFFFFFF;
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_HI, address >> 16);
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_MID, address >> 8);
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_LO, address);
+    return table;
+}
+
+// Returns the state bytes for the event with this tag on the given space, creating a zeroed entry
+// the first time.  Returns NULL if all MP3_INSTANCE_TABLE_CAPACITY entries are taken, or there's no
+// table because the board state header isn't current.
+u8* mp3_GetInstanceState(int chainIndex, int spaceIndex, int eventTag)
+{
+    struct mp3_InstanceTable *table = mp3_GetInstanceTable();
+    if(table == NULL)
+    {
+        return NULL;
+    }
+
+    u32 key = ((chainIndex & 0xFF) << 24) | ((spaceIndex & 0xFF) << 16) | ((eventTag & 0xFF) << 8) | 1;
+
+    // Fibonacci hashing: multiply by 2^32 / golden ratio and keep the top bits as the slot.
+    u32 slot = (key * 0x9E3779B1) >> (32 - MP3_INSTANCE_TABLE_BITS);
+    int i;
+    for(i = 0; i < MP3_INSTANCE_TABLE_CAPACITY; i++)
+    {
+        struct mp3_InstanceEntry *entry = &table->entries[slot];
+        if(entry->key == key)
+        {
+            return entry->state;
+        }
+        if(entry->key == 0)
+        {
+            entry->key = key;
+            table->count++;
+            return entry->state;
+        }
+        slot = (slot + 1) & (MP3_INSTANCE_TABLE_CAPACITY - 1);
+    }
+    return NULL;
+}
+
+// Returns this game's profile table, allocating it on first use.  NULL if there's no instance table
+// entry for it (see mp3_GetInstanceState).
+struct mp3_ProfileTable* mp3_GetProfileTable()
+{
+    u32 *address = (u32*)mp3_GetInstanceState(0xFF, 0xFF, MP3_PROFILE_EVENT_TAG);
+    if(address == NULL)
+    {
+        return NULL;
+    }
+
+    int seed = mp3_GetCurrentBoardStateSeed();
+    struct mp3_ProfileTable *table = (struct mp3_ProfileTable*)(*address);
+    if(mplib_IsRDRAMAddress(*address) && (table->magic == MP3_PROFILE_MAGIC) && (table->seed == seed))
+    {
+        return table;
+    }
+
+    table = MallocPerm(sizeof(struct mp3_ProfileTable));
+    bzero(table, sizeof(struct mp3_ProfileTable));
+    table->magic = MP3_PROFILE_MAGIC;
+    table->seed = seed;
+    *address = (u32)table;
+    return table;
+}
+
+// Empties the table, to start measuring again.
+void mp3_ProfileReset()
+{
+    struct mp3_ProfileTable *table = mp3_GetProfileTable();
+    if(table != NULL)
+    {
+        bzero(table->slots, sizeof(table->slots));
+        table->count = 0;
+    }
+}
+
+// Converts Count ticks to microseconds without overflowing 32 bits.
+u32 mp3_ProfileTicksToMicroseconds(u32 ticks)
+{
+    return (ticks / MP3_PROFILE_TICKS_PER_MS) * 1000 + ((ticks % MP3_PROFILE_TICKS_PER_MS) * 1000) / MP3_PROFILE_TICKS_PER_MS;
+}
+
+// Shows a message box per phase with mp3_DebugMessageWithConfirmation, like:
+//      message build
+//      12 calls 4210 us
+//      longest 933 us
+// Microseconds read against frames: a frame at 30 fps is 33333 us.
+void mp3_ProfileShow()
+{
+    struct mp3_ProfileTable *table = mp3_GetProfileTable();
+    char message[80];                       // 15 name + 10 + 10 + 10 digits + the words: 69 with the 0
+    int slot;
+    if((table == NULL) || (table->count == 0))
+    {
+        mp3_DebugMessageWithConfirmation("No profiled phases yet");
+        return;
+    }
+
+    for(slot = 0; slot < table->count; slot++)
+    {
+        struct mp3_ProfileSlot *phase = &table->slots[slot];
+        bzero(message, sizeof(message));
+        mplib_strcpy(message, phase->name);
+        mplib_strncat(message, "\x0A");                                         // Newline
+        mplib_AppendUnsigned(message, phase->calls);
+        mplib_strncat(message, " calls ");
+        mplib_AppendUnsigned(message, mp3_ProfileTicksToMicroseconds(phase->total));
+        mplib_strncat(message, " us");
+        mplib_strncat(message, "\x0A");                                         // Newline
+        mplib_strncat(message, "longest ");
+        mplib_AppendUnsigned(message, mp3_ProfileTicksToMicroseconds(phase->longest));
+        mplib_strncat(message, " us");
+        mp3_DebugMessageWithConfirmation(message);
+    }
+}
+
+// Long-form implementation from:
+// https://www.techiedelight.com/implement-strcpy-function-c/
+//
+// Function to implement strcpy() function
+char* mplib_strcpy(char* destination, const char* source)
+{
+    // return if no memory is allocated to the destination
+    if (destination == NULL)
+        return NULL;
+ 
+    // take a pointer pointing to the beginning of destination string
+    char *ptr = destination;
+ 
+    // copy the C-string pointed by source into the array
+    // pointed to by destination
+    while (*source != '\0')
+    {
+        *destination = *source;
+        destination++;
+        source++;
+    }
+ 
+    // include the terminating null character
+    *destination = '\0';
+ 
+    // destination is returned by standard strcpy()
+    return ptr;
+}
+
+// Second implementation from this site:
+// https://www.techiedelight.com/implement-strncat-function-c/#:~:text=The%20strncat()%20function%20appends,pointer%20to%20the%20destination%20string
+// Stripped out the "num" prototype so that strncat always appends the full string passed, instead of a defined subset.
+
+// Function to implement strncat() function in C
+char* mplib_strncat(char* destination, const char* source)
+{
+    int i, j;
+ 
+    // move to the end of destination string
+    for (i = 0; destination[i] != '\0'; i++);
+ 
+    // i now points to terminating null character in destination
+ 
+    // Appends num characters of source to the destination string
+    for (j = 0; source[j] != '\0'; j++)
+        destination[i + j] = source[j];
+ 
+    // null terminate destination string
+    destination[i + j] = '\0';
+ 
+    // destination is returned by standard strncat()
+    return destination;
+}
+
+// Appends a number in decimal (up to 10 digits) to the end of destination, like mplib_strncat.
+char* mplib_AppendUnsigned(char* destination, u32 value)
+{
+    char digits[11];
+    int i = 10;
+    digits[i] = '\0';
+    do
+    {
+        i--;
+        digits[i] = '0' + (value % 10);
+        value /= 10;
+    } while(value != 0);
+
+    return mplib_strncat(destination, &digits[i]);
+}
@@ -0,0 +1,423 @@
+// NAME: Visited Spaces Tracker
+// GAMES: MP3_USA
+// EXECUTION: Direct
+// PARAM: Boolean|COUNTS_LAPS
+// BOARD_RAM: MP3LIB_INSTANCE_TABLE_HI|8
+// BOARD_RAM: MP3LIB_INSTANCE_TABLE_MID|8
+// BOARD_RAM: MP3LIB_INSTANCE_TABLE_LO|8
+// BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+// BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+
+// Redefining params here for vs code highlighting, not actually used in partyplanner.
+#ifndef COUNTS_LAPS
+    #define COUNTS_LAPS 0
+#endif
+
+//***************************************************************************//
+//******************** Version Info! ****************************************//
+//***************************************************************************//
+//
+// This is version: 1.2
+//
+// There may be an update available at:
+// https://github.com/c-kennelly/mario-party-custom-events
+// You can also report a bug as an issue (and maybe a PR that fixes it?)
+
+
+//***************************************************************************//
+//******************** BOARD RAM WARNING ************************************//
+//***************************************************************************//
+// This event uses the mp3lib instance table, which keeps its address in three board RAM bytes
+// shared by every event that uses it, and reads the board state header:
+//              MP3LIB_INSTANCE_TABLE_HI/MID/LO     3 bytes - address of the table on the perm heap
+//              MP3LIB_BOARD_STATE_STAMP/CHECK      14 bits - the board's Board State Header
+//
+// Run "python3 Tools/board_ram_alloc.py your_board.json --write" to place them around the other
+// events on your board.  Place your board's copy of the "Board State Header" event too: without a
+// current header there's no instance table, and this event does nothing.  Each game gets a new table
+// (and so new, empty visited sets).
+
+
+//***************************************************************************//
+//*********************** Description ***************************************//
+//***************************************************************************//
+// Keeps track of which spaces each player has landed on this game, and how many laps they've made,
+// for bonus conditions the game doesn't count itself ("explored the most of the board", "most times
+// around the board").  Spec.txt for the Character Swap board has a few.
+//
+// Place it three times:
+//
+//  - Once as an "After Player Turn" board event, with COUNTS_LAPS False.  After every move it sets
+//    one bit for the space the player ended on: 13 bytes a player, so boards of up to 104 spaces.
+//  - Twice on the space a lap starts at, with COUNTS_LAPS True: once as a passing event and once as
+//    a landing event, so a lap counts whether the player goes past the space or stops on it.  That's
+//    the start space, or on boards where the start space isn't part of the loop (like Game Night),
+//    the first space of the loop after it.  A player gets at most one lap a turn, so the two never
+//    count the same lap twice.
+//
+// See the "Visited spaces" section of mp3lib for the layout and for the queries other events paste in:
+//
+//      mp3_CountVisitedSpaces(playerMask, matchAll)    // union or intersection, a popcount per 4 bytes
+//      mp3_HasVisitedSpace(playerIndex, space)
+//      mp3_GetLapCount(playerIndex)
+//
+// Finally, this file is commented to make it as easy as possible for
+// non-programmers to edit and beginners to pull code samples, so I've
+// leaned on the verbose side for comments.  If you've a working knowledge
+// of C, feel free to just jump to main() and see what's going on.
+
+
+//***************************************************************************//
+//***********************     Changelist      *******************************//
+//***************************************************************************//
+//   Version 1.2 - The visited sets are 13 bytes a player instead of 16.  Laps are counted by the
+//                 COUNTS_LAPS placements on the space a lap starts at, instead of on any move back
+//                 onto chain 0.
+//   Version 1.1 - The visited sets are stamped with the board state header's per-game seed, so a set
+//                 left on the perm heap by another game is never reused.
+//   Version 1.0 - First version of the event!
+
+
+//***************************************************************************//
+//*************************** Declarations **********************************//
+//***************************************************************************//
+
+// Header file: http://n64devkit.square7.ch/header/ultra64.htm
+// Ultratypes: http://n64devkit.square7.ch/header/ultratypes.htm
+// For more exploration: http://n64devkit.square7.ch/header/
+#include "ultra64.h"
+
+extern s8 D_800CD05B;       // current_turn from the mp3 sym table.  Starts at 1.
+
+// Board RAM slots, filled in by Tools/board_ram_alloc.py --write:
+//******************** BOARD RAM SLOTS (generated) ****************************
+// Generated by Tools/board_ram_alloc.py for the "Game Night" board.
+// Re-run the tool instead of editing these by hand.  Event: Visited Spaces Tracker
+#define BOARD_RAM_LAYOUT_VERSION                 1
+extern u8 D_800CD099;
+extern u8 D_800CD09A;
+extern u8 D_800CD09B;
+extern u8 D_800CD09C;
+extern u8 D_800CD09D;
+#define MP3LIB_BOARD_STATE_STAMP_BYTE            D_800CD09D
+#define MP3LIB_BOARD_STATE_STAMP_SHIFT           0
+#define MP3LIB_BOARD_STATE_STAMP_WIDTH           6
+#define MP3LIB_BOARD_STATE_CHECK_BYTE            D_800CD099
+#define MP3LIB_BOARD_STATE_CHECK_SHIFT           0
+#define MP3LIB_BOARD_STATE_CHECK_WIDTH           8
+#define MP3LIB_INSTANCE_TABLE_HI_BYTE            D_800CD09A
+#define MP3LIB_INSTANCE_TABLE_HI_SHIFT           0
+#define MP3LIB_INSTANCE_TABLE_HI_WIDTH           8
+#define MP3LIB_INSTANCE_TABLE_MID_BYTE           D_800CD09B
+#define MP3LIB_INSTANCE_TABLE_MID_SHIFT          0
+#define MP3LIB_INSTANCE_TABLE_MID_WIDTH          8
+#define MP3LIB_INSTANCE_TABLE_LO_BYTE            D_800CD09C
+#define MP3LIB_INSTANCE_TABLE_LO_SHIFT           0
+#define MP3LIB_INSTANCE_TABLE_LO_WIDTH           8
+//******************** /BOARD RAM SLOTS ***************************************
+
+// mplib bitfield accessors.  These are macros, so they live up here above the code that uses them.
+#define mplib_BitMask(width)                        ((1 << (width)) - 1)
+#define mplib_GetBits(byte, shift, width)           (((byte) >> (shift)) & mplib_BitMask(width))
+#define mplib_SetBits(byte, shift, width, value)    ((byte) = ((byte) & ~(mplib_BitMask(width) << (shift))) \
+                                                        | (((value) & mplib_BitMask(width)) << (shift)))
+#define mplib_GetField(NAME)                        mplib_GetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH)
+#define mplib_SetField(NAME, value)                 mplib_SetBits(NAME##_BYTE, NAME##_SHIFT, NAME##_WIDTH, value)
+
+// The Player struct for Mario Party 3, used for player manipulation.
+// Reference wiki article can be found here:
+// https://github.com/PartyPlanner64/PartyPlanner64/wiki/Player-Structs
+struct Player {
+	s8 unk0;
+	s8 cpu_difficulty;
+	s8 controller;
+	u8 character;
+	u8 flags;               // Miscellaneous flags. "1" is CPU player
+	s8 pad0[5];             // Skip undocumented offset 5-9
+	s16 coins;              // Offset 10: Current coin count.
+	s16 minigame_coins;     // Offset 12: Coins obtained during a Mini-Game.
+	s8 stars;               // Offset 14
+	
+	u8 cur_chain_index;     // Offset 15
+	u8 cur_space_index;     // Offset 16
+	u8 next_chain_index;    // Offset 17
+	u8 next_space_index;    // Offset 18
+	u8 unk1_chain_index;    // Offset 19
+	u8 unk1_space_index;    // Offset 20
+	u8 reverse_chain_index; // Offset 21
+	u8 reverse_space_index; // Offset 22
+
+	u8 flags2;              // Offset 23
+	u8 items[3];            // Offset 24
+	u8 bowser_suit_flag;    // Offset 27
+	u8 turn_color_status;   // Offset 28
+
+	s8 pad1[7];             // Offsets: 29 - 35
+
+	void *obj;              // Offset 36:  struct object *
+	s16 minigame_star;      // Offset 40
+	s16 coin_star;          // Offset 42
+	s8 happening_space_count; // Offset 44
+	s8 red_space_count;     
+	s8 blue_space_count;
+	s8 chance_space_count;
+	s8 bowser_space_count;  // Offset 48
+	s8 battle_space_count;
+	s8 item_space_count;
+	s8 bank_space_count;
+	s8 game_guy_space_count; //Offset  52
+
+	char unk_35[3]; 		//likely padding
+}; // sizeof == 56
+
+// Board state header, instance table and visited sets, from mp3lib.
+#define MP3_BOARD_STATE_VERSION_SHIFT   4
+#define MP3_BOARD_STATE_SEED_MASK       0x0F
+
+#define MP3_INSTANCE_TABLE_MAGIC        0x494E5354                      // "INST"
+#define MP3_INSTANCE_TABLE_BITS         5
+#define MP3_INSTANCE_TABLE_CAPACITY     (1 << MP3_INSTANCE_TABLE_BITS)  // 32 placements per board
+#define MP3_INSTANCE_STATE_BYTES        4
+
+struct mp3_InstanceEntry {
+    u32 key;                                // Chain (bits 31-24), space (23-16), event tag (15-8), 1 = in use (bit 0).  0 is empty.
+    u8 state[MP3_INSTANCE_STATE_BYTES];     // Yours to use.  Starts zeroed.
+}; // sizeof == 8
+
+struct mp3_InstanceTable {
+    u32 magic;                              // MP3_INSTANCE_TABLE_MAGIC, so we can tell a live table from a stale address
+    u32 seed;                               // The board state header's seed for the game that built the table
+    u32 count;                              // Entries in use
+    struct mp3_InstanceEntry entries[MP3_INSTANCE_TABLE_CAPACITY];
+}; // sizeof == 268
+
+#define MP3_VISITED_MAGIC           0x56495354      // "VIST"
+#define MP3_VISITED_EVENT_TAG       0xFF
+#define MP3_VISITED_SPACE_BYTES     13              // 104 spaces.  Game Night has 97.
+
+struct mp3_VisitedSpaces {
+    u32 magic;                                      // MP3_VISITED_MAGIC
+    u32 seed;                                       // The board state header's seed for this game
+    u8 spaces[4][MP3_VISITED_SPACE_BYTES];          // Absolute space N is bit (N & 7) of byte (N >> 3)
+    u8 laps[4];
+    u8 lapTurn[4];                                  // current_turn the player's last lap was counted on
+}; // sizeof == 68
+
+
+//***************************************************************************//
+//*************************** Event Logic ************************************//
+//***************************************************************************//
+
+//This event is intended to run on After Player Turn timing with COUNTS_LAPS False, and as a passing and
+//a landing event on the space a lap starts at with COUNTS_LAPS True.
+void main()
+{
+    if(COUNTS_LAPS == 1)
+    {
+        mp3_CountLap(GetCurrentPlayerIndex());
+    }
+    else
+    {
+        mp3_MarkVisitedSpace(GetCurrentPlayerIndex());
+    }
+}
+
+
+//***************************************************************************//
+//***************************************************************************//
+//****************************                  *****************************//
+//*************************      mp3lib v1.0       **************************//
+//****************************                  *****************************//
+//***************************************************************************//
+//***************************************************************************//
+//***      Some helper functions to make up for lack of stdlib.io; and    ***//
+//***     to hide the complexity of some Mario Party-specific functions   ***//
+//***************************************************************************//
+//***************************************************************************//
+// NOTE - this instance of mp3lib is pared down just to the functions used in this event
+//
+// Get the latest version or submit changes at:
+// https://github.com/C-Kennelly/mario-party-custom-events
+//***************************************************************************//
+
+// Turn 1 always gets the base value for the version and seed, and every later turn gets one of the
+// other 255 values.  So a header stamped on any later turn of any game can never pass for a turn 1 header.
+int mp3_BoardStateCheck(int layoutVersion, int seed, int turn)
+{
+    int base = ((seed * 0x9D) + (layoutVersion * 0x3B)) & 0xFF;
+    if(turn <= 1)
+    {
+        return base;
+    }
+    return base ^ (1 + ((turn - 2) % 255));
+}
+
+int mp3_GetBoardStateSeed(u8 stamp)
+{
+    return stamp & MP3_BOARD_STATE_SEED_MASK;
+}
+
+// Returns 1 if the header was stamped by this game on this turn or the one before it.
+// On turn 1 only a turn 1 stamp counts, which is what catches a previous game's leftovers.
+int mp3_IsBoardStateHeaderCurrent(u8 stamp, u8 check, int layoutVersion, int turn)
+{
+    int seed = mp3_GetBoardStateSeed(stamp);
+    if((seed == 0) || (((stamp >> MP3_BOARD_STATE_VERSION_SHIFT) & 3) != (layoutVersion & 3)))
+    {
+        return 0;
+    }
+
+    if(check == mp3_BoardStateCheck(layoutVersion, seed, turn))
+    {
+        return 1;   // Already stamped this turn, e.g. the scene was reloaded.
+    }
+    return (turn > 1) && (check == mp3_BoardStateCheck(layoutVersion, seed, turn - 1));
+}
+
+// Returns this game's seed (1-15) if the header is current, or 0 if it isn't, i.e. board RAM can't be
+// trusted to belong to this game.  Declare the header's fields in your event to call this:
+//
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_STAMP|6
+//      // BOARD_RAM: MP3LIB_BOARD_STATE_CHECK|8
+int mp3_GetCurrentBoardStateSeed()
+{
+    u8 stamp = mplib_GetField(MP3LIB_BOARD_STATE_STAMP);
+    if(!mp3_IsBoardStateHeaderCurrent(stamp, mplib_GetField(MP3LIB_BOARD_STATE_CHECK), BOARD_RAM_LAYOUT_VERSION, D_800CD05B))
+    {
+        return 0;
+    }
+    return mp3_GetBoardStateSeed(stamp);
+}
+
+// Returns 1 if address could be a perm heap block: word aligned, and inside the 8MB of RDRAM.
+int mplib_IsRDRAMAddress(u32 address)
+{
+    return (address >= 0x80000000) && (address < 0x80800000) && ((address & 3) == 0);
+}
+
+// Returns this game's instance table, allocating it on first use.  NULL if the board state header
+// isn't current, since then there's no telling this game's table from another one's.
+struct mp3_InstanceTable* mp3_GetInstanceTable()
+{
+    int seed = mp3_GetCurrentBoardStateSeed();
+    if(seed == 0)
+    {
+        return NULL;
+    }
+
+    u32 address = (mplib_GetField(MP3LIB_INSTANCE_TABLE_HI) << 16)
+                | (mplib_GetField(MP3LIB_INSTANCE_TABLE_MID) << 8)
+                |  mplib_GetField(MP3LIB_INSTANCE_TABLE_LO);
+    struct mp3_InstanceTable *table = (struct mp3_InstanceTable*)(0x80000000 | address);
+
+    if((address != 0) && mplib_IsRDRAMAddress((u32)table) && (table->magic == MP3_INSTANCE_TABLE_MAGIC)
+        && (table->seed == seed))
+    {
+        return table;
+    }
+
+    table = MallocPerm(sizeof(struct mp3_InstanceTable));
+    bzero(table, sizeof(struct mp3_InstanceTable));
+    table->magic = MP3_INSTANCE_TABLE_MAGIC;
+    table->seed = seed;
+
+    address = ((u32)table) & 0xFFFFFF;
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_HI, address >> 16);
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_MID, address >> 8);
+    mplib_SetField(MP3LIB_INSTANCE_TABLE_LO, address);
+    return table;
+}
+
+// Returns the state bytes for the event with this tag on the given space, creating a zeroed entry
+// the first time.  Returns NULL if all MP3_INSTANCE_TABLE_CAPACITY entries are taken, or there's no
+// table because the board state header isn't current.
+u8* mp3_GetInstanceState(int chainIndex, int spaceIndex, int eventTag)
+{
+    struct mp3_InstanceTable *table = mp3_GetInstanceTable();
+    if(table == NULL)
+    {
+        return NULL;
+    }
+
+    u32 key = ((chainIndex & 0xFF) << 24) | ((spaceIndex & 0xFF) << 16) | ((eventTag & 0xFF) << 8) | 1;
+
+    // Fibonacci hashing: multiply by 2^32 / golden ratio and keep the top bits as the slot.
+    u32 slot = (key * 0x9E3779B1) >> (32 - MP3_INSTANCE_TABLE_BITS);
+    int i;
+    for(i = 0; i < MP3_INSTANCE_TABLE_CAPACITY; i++)
+    {
+        struct mp3_InstanceEntry *entry = &table->entries[slot];
+        if(entry->key == key)
+        {
+            return entry->state;
+        }
+        if(entry->key == 0)
+        {
+            entry->key = key;
+            table->count++;
+            return entry->state;
+        }
+        slot = (slot + 1) & (MP3_INSTANCE_TABLE_CAPACITY - 1);
+    }
+    return NULL;
+}
+
+// Returns this game's visited sets, allocating them on first use.  NULL if there's no instance table
+// entry for them (see mp3_GetInstanceState).
+struct mp3_VisitedSpaces* mp3_GetVisitedSpaces()
+{
+    u32 *address = (u32*)mp3_GetInstanceState(0xFF, 0xFF, MP3_VISITED_EVENT_TAG);
+    if(address == NULL)
+    {
+        return NULL;
+    }
+
+    int seed = mp3_GetCurrentBoardStateSeed();
+    struct mp3_VisitedSpaces *visited = (struct mp3_VisitedSpaces*)(*address);
+    if(mplib_IsRDRAMAddress(*address) && (visited->magic == MP3_VISITED_MAGIC) && (visited->seed == seed))
+    {
+        return visited;
+    }
+
+    visited = MallocPerm(sizeof(struct mp3_VisitedSpaces));
+    bzero(visited, sizeof(struct mp3_VisitedSpaces));
+    visited->magic = MP3_VISITED_MAGIC;
+    visited->seed = seed;
+    *address = (u32)visited;
+    return visited;
+}
+
+// Marks the space the player is standing on.  O(1) per move: one bit set.  Only landings count, not
+// spaces passed over.
+void mp3_MarkVisitedSpace(int playerIndex)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    struct Player *p = GetPlayerStruct(playerIndex);
+    if((visited == NULL) || (p == NULL))
+    {
+        return;
+    }
+
+    int space = GetAbsSpaceIndexFromChainSpaceIndex(p->cur_chain_index, p->cur_space_index);
+    if((space >= 0) && (space < (MP3_VISITED_SPACE_BYTES * 8)))
+    {
+        visited->spaces[playerIndex][space >> 3] |= (1 << (space & 7));
+    }
+}
+
+// Counts a lap for the player, from an event on the space a lap starts at: the start space, or on
+// boards where the start space isn't part of the loop, the first space of the loop after it.  Place
+// the event there as both a passing and a landing event, so a lap counts whether the player goes
+// past the space or stops on it.  If both run on the same move, only the first counts: a player gets
+// at most one lap a turn.  Every player passes the space on their first move, so laps start at 1.
+void mp3_CountLap(int playerIndex)
+{
+    struct mp3_VisitedSpaces *visited = mp3_GetVisitedSpaces();
+    if((visited == NULL) || (visited->lapTurn[playerIndex] == D_800CD05B) || (visited->laps[playerIndex] == 255))
+    {
+        return;
+    }
+
+    visited->laps[playerIndex]++;
+    visited->lapTurn[playerIndex] = D_800CD05B;
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Keeps a board's images and music in sidecar files next to the board.
+
+PartyPlanner64 saves the board background, the board select / logo images and
+any custom music inside the board file as base64 data URLs.  For Game Night
+that's 2.3 MB of the file, and every tool that opens the board has to parse
+all of it, even the ones that only want the spaces and links.
+
+This tool moves each of them into a raw binary file under assets/ beside the
+board, named by its sha256, and leaves a reference in its place:
+
+    "src": {
+        "asset": "assets/0c1d....png",
+        "type": "image/png",
+        "sha256": "0c1d..."
+    }
+
+    split   board.json -> board with asset references, plus the sidecar files.
+            A data URL that wouldn't come back byte for byte (non-standard
+            base64) is left embedded.
+    join    board with asset references -> a board PartyPlanner64 can open.
+            Fails if a sidecar is missing or has changed since the split.
+    verify  checks every sidecar against the hash its reference records, and
+            exits with status 1 if any is missing or different.
+
+Tools that load a board with boardlib.load_board() never read the sidecars;
+boardlib.open_asset() memory-maps one when a tool actually needs the bytes.
+To open the board in PartyPlanner64, run board_sources.py rehydrate (which
+puts back both the event code and the assets) or join.
+
+Usage:
+    python3 Tools/board_assets.py split Complete/MP3/Boards/GameNight/game_night.json --in-place
+    python3 Tools/board_assets.py join Complete/MP3/Boards/GameNight/game_night.json -o game_night_full.json
+    python3 Tools/board_assets.py verify Complete/MP3/Boards/GameNight/game_night.json
+"""
+
+import argparse
+import base64
+import binascii
+import hashlib
+import os
+import sys
+
+import boardlib
+
+# File extensions for the media types PartyPlanner64 writes.  Anything else is .bin.
+EXTENSIONS = {
+    "image/png": ".png",
+    "image/jpeg": ".jpg",
+    "image/gif": ".gif",
+    "audio/mid": ".mid",
+    "audio/midi": ".mid",
+}
+
+
+def slot_name(container, key):
+    """A readable name for a report line: the key, or the list entry's "name" if it has one."""
+    if isinstance(key, int):
+        return "%s[%d]" % (container[key].get("name", "") if isinstance(container[key], dict) else "", key)
+    return key
+
+
+def split(board, board_dir, out):
+    """Moves every data URL in the board into a sidecar, in place."""
+    asset_dir = os.path.join(board_dir, boardlib.ASSET_DIR_NAME)
+    for container, key, value in list(boardlib.iter_asset_slots(board)):
+        parsed = boardlib.parse_data_url(value)
+        if parsed is None:
+            continue    # Already a reference
+        media_type, payload = parsed
+        try:
+            data = base64.b64decode(payload, validate=True)
+        except (binascii.Error, ValueError):
+            out.write("  embedded  %s (not valid base64)\n" % slot_name(container, key))
+            continue
+        if base64.b64encode(data).decode("ascii") != payload:
+            out.write("  embedded  %s (base64 wouldn't round-trip)\n" % slot_name(container, key))
+            continue
+
+        digest = hashlib.sha256(data).hexdigest()
+        relpath = boardlib.ASSET_DIR_NAME + "/" + digest + EXTENSIONS.get(media_type, ".bin")
+        path = os.path.join(board_dir, relpath)
+        if not os.path.isfile(path):
+            os.makedirs(asset_dir, exist_ok=True)
+            with open(path, "wb") as f:
+                f.write(data)
+        out.write("  sidecar   %s -> %s (%d bytes)\n" % (slot_name(container, key), relpath, len(data)))
+
+        container[key] = {"asset": relpath, "type": media_type, "sha256": digest}
+
+
+def verify(board, board_dir, out):
+    """Returns a list of problems with the board's sidecars."""
+    problems = []
+    for container, key, value in boardlib.iter_asset_slots(board):
+        if not boardlib.is_asset_reference(value):
+            out.write("  embedded  %s\n" % slot_name(container, key))
+            continue
+        try:
+            data = boardlib.open_asset(board_dir, value)
+        except OSError as e:
+            problems.append("%s: %s" % (value["asset"], e.strerror))
+            continue
+        if hashlib.sha256(data).hexdigest() != value["sha256"]:
+            problems.append("%s doesn't match its sha256" % value["asset"])
+        else:
+            out.write("  ok        %s\n" % value["asset"])
+    return problems
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_split = sub.add_parser("split", help="move images and music into sidecar files")
+    p_split.add_argument("board")
+    p_split.add_argument("-o", "--output", help="where to write the board with references (sidecars go beside it)")
+    p_split.add_argument("--in-place", action="store_true", help="overwrite the board file")
+
+    p_join = sub.add_parser("join", help="put the images and music back for PartyPlanner64")
+    p_join.add_argument("board")
+    p_join.add_argument("-o", "--output", required=True)
+
+    p_verify = sub.add_parser("verify", help="check the sidecars against their hashes")
+    p_verify.add_argument("board")
+
+    args = parser.parse_args(argv)
+    board = boardlib.load_raw_board(args.board)
+    board_dir = os.path.dirname(os.path.abspath(args.board))
+
+    if args.command == "split":
+        if not args.output and not args.in_place:
+            parser.error("give -o/--output or --in-place")
+        output = args.board if args.in_place else args.output
+        before = os.path.getsize(args.board)
+        split(board, os.path.dirname(os.path.abspath(output)), sys.stdout)
+        boardlib.save_board(board, output, compact=False)
+        sys.stdout.write("Wrote %s: %d -> %d bytes\n" % (output, before, os.path.getsize(output)))
+        return 0
+
+    if args.command == "join":
+        errors = []
+        boardlib.inline_assets(board, board_dir, errors=errors)
+        if errors:
+            sys.stderr.write("Join failed:\n")
+            for error in errors:
+                sys.stderr.write("  " + error + "\n")
+            return 1
+        boardlib.save_board(board, args.output, compact=True)
+        sys.stdout.write("Wrote %s (%d bytes)\n" % (args.output, os.path.getsize(args.output)))
+        return 0
+
+    problems = verify(board, board_dir, sys.stdout)
+    if problems:
+        sys.stderr.write("\nBoard assets don't match their sidecars:\n")
+        for problem in problems:
+            sys.stderr.write("  " + problem + "\n")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
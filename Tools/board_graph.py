@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+"""Compact binary board graph, for simulators and analyzers.
+
+Tools that play out games on a board only need its spaces, links and event
+placements, not the JSON document around them.  This tool packs those into a
+small versioned binary file that loads with one mmap and a handful of slices:
+
+    header          64 bytes, see HEADER below
+    spaces          struct-of-arrays, one entry per space, each array padded to 4 bytes:
+                        s16 x[], s16 y[], s16 z[], s16 rotation[],
+                        u8 type[], u8 subtype[] (0xFF = none), u8 flags[] (bit 0: star)
+    links           CSR: u32 link_first[space_count + 1], u16 link_target[link_count]
+    event_first     u32[space_count + 1]; placements on space N are
+                    [event_first[N], event_first[N + 1]), board events follow
+                    from event_first[space_count] to placement_count
+    placements      12 bytes each, see PLACEMENT below
+    params          8 bytes each, see PARAM below
+    strings         u32 string_first[string_count + 1], then the UTF-8 bytes
+
+Event IDs and parameter names are interned into the string table, so
+comparing an event ID is comparing two integers.  Parameters that a
+placement leaves at their default get the PARAM default from the event's
+header baked in (flagged PARAM_FROM_DEFAULT), so nothing has to read event
+code at run time.  Everything is little-endian.
+
+The file also records the crc32 of the board JSON it was built from;
+load_graph() rebuilds it whenever that no longer matches, so callers never
+see a stale graph.
+
+Usage:
+    python3 Tools/board_graph.py build Complete/MP3/Boards/GameNight/game_night.json
+    python3 Tools/board_graph.py dump Complete/MP3/Boards/GameNight/game_night.graph
+
+From Python:
+    graph = board_graph.load_graph("Complete/MP3/Boards/GameNight/game_night.json")
+    for target in graph.links(space): ...
+"""
+
+import argparse
+import mmap
+import os
+import struct
+import sys
+import zlib
+
+import boardlib
+
+MAGIC = b"MPBG"
+VERSION = 1
+
+# magic, version, header size, space/link/placement/param/string counts, first board event,
+# section offsets (spaces, links, event_first, placements, params, strings), file size, source crc32
+HEADER = struct.Struct("<4sHH6I6III")
+assert HEADER.size == 64
+
+# event (string id), activationType, executionType, flags, pad, space (NO_SPACE for board events),
+# first param, param count
+PLACEMENT = struct.Struct("<HbBBxHHH")
+# name (string id), kind, flags, value
+PARAM = struct.Struct("<HBBi")
+
+NO_SPACE = 0xFFFF
+NO_SUBTYPE = 0xFF
+SPACE_FLAG_STAR = 0x01
+PLACEMENT_FLAG_CUSTOM = 0x01
+PARAM_KIND_NUMBER = 0
+PARAM_KIND_BOOLEAN = 1
+PARAM_KIND_STRING = 2       # value is a string id
+PARAM_FROM_DEFAULT = 0x01
+
+
+def graph_path_for(board_path):
+    return os.path.splitext(board_path)[0] + ".graph"
+
+
+def board_crc(board_path):
+    with open(board_path, "rb") as f:
+        return zlib.crc32(f.read()) & 0xFFFFFFFF
+
+
+#***************************************************************************#
+#********************************* Writing *********************************#
+#***************************************************************************#
+
+class _Strings:
+    def __init__(self):
+        self.ids = {}
+        self.values = []
+
+    def intern(self, value):
+        if value not in self.ids:
+            self.ids[value] = len(self.values)
+            self.values.append(value)
+        return self.ids[value]
+
+
+def _pad4(blob):
+    return blob + b"\0" * (-len(blob) % 4)
+
+
+def _param_records(placement, header, strings):
+    """Explicit parameterValues first, in board order, then header defaults for the rest."""
+    values = placement.get("parameterValues") or {}
+    records = []
+    for name, value in values.items():
+        records.append((name, value, 0))
+    for param in header.get("PARAM", []):
+        parts = param.split("|")
+        if len(parts) >= 5 and parts[1] not in values:
+            value = parts[4] == "true" if parts[0] == "Boolean" else int(parts[4])
+            records.append((parts[1], value, PARAM_FROM_DEFAULT))
+
+    packed = []
+    for name, value, flags in records:
+        if isinstance(value, bool):
+            kind, value = PARAM_KIND_BOOLEAN, int(value)
+        elif isinstance(value, (int, float)):
+            kind, value = PARAM_KIND_NUMBER, int(value)
+        else:
+            kind, value = PARAM_KIND_STRING, strings.intern(str(value))
+        packed.append(PARAM.pack(strings.intern(name), kind, flags, value))
+    return packed
+
+
+def build_graph(board, crc=0):
+    """Returns the binary graph for a loaded board (see boardlib.load_board)."""
+    spaces = board.get("spaces", [])
+    count = len(spaces)
+    if count >= NO_SPACE:
+        raise ValueError("%d spaces won't fit in a u16 space index" % count)
+
+    x, y, z, rotation, types, subtypes, flags = [], [], [], [], [], [], []
+    for space in spaces:
+        x.append(int(round(space.get("x", 0))))
+        y.append(int(round(space.get("y", 0))))
+        z.append(int(round(space.get("z", 0))))
+        rotation.append(int(round(space.get("rotation", 0))))
+        types.append(space.get("type", 0))
+        subtype = space.get("subtype")
+        subtypes.append(NO_SUBTYPE if subtype is None else subtype)
+        flags.append(SPACE_FLAG_STAR if space.get("star") else 0)
+    space_blob = b"".join(_pad4(struct.pack("<%dh" % count, *column)) for column in (x, y, z, rotation))
+    space_blob += b"".join(_pad4(struct.pack("<%dB" % count, *column)) for column in (types, subtypes, flags))
+
+    link_first, link_target = [0], []
+    for index in range(count):
+        link_target.extend(boardlib.space_links(board, index))
+        link_first.append(len(link_target))
+    link_blob = _pad4(struct.pack("<%dI" % (count + 1), *link_first)
+                      + struct.pack("<%dH" % len(link_target), *link_target))
+
+    strings = _Strings()
+    headers = {}
+    events = board.get("events") or {}
+    placements, params, event_first = [], [], [0]
+    by_space = [[] for _ in range(count)]
+    board_events = []
+    for space, placement in boardlib.iter_event_placements(board):
+        (board_events if space is None else by_space[space]).append(placement)
+    ordered = [(index, p) for index in range(count) for p in by_space[index]]
+    board_event_first = len(ordered)
+    ordered += [(None, p) for p in board_events]
+
+    for space, placement in ordered:
+        name = placement.get("id", "")
+        if name not in headers:
+            headers[name] = boardlib.parse_event_header((events.get(name) or {}).get("code", ""))
+        records = _param_records(placement, headers[name], strings)
+        placements.append(PLACEMENT.pack(strings.intern(name), placement.get("activationType", 0),
+                                         placement.get("executionType", 0),
+                                         PLACEMENT_FLAG_CUSTOM if placement.get("custom") else 0,
+                                         NO_SPACE if space is None else space, len(params), len(records)))
+        params.extend(records)
+    for index in range(count):
+        event_first.append(event_first[-1] + len(by_space[index]))
+
+    encoded = [s.encode("utf-8") for s in strings.values]
+    string_first = [0]
+    for value in encoded:
+        string_first.append(string_first[-1] + len(value))
+    string_blob = struct.pack("<%dI" % len(string_first), *string_first) + b"".join(encoded)
+
+    sections = [space_blob, link_blob, _pad4(struct.pack("<%dI" % (count + 1), *event_first)),
+                _pad4(b"".join(placements)), _pad4(b"".join(params)), _pad4(string_blob)]
+    offsets = []
+    position = HEADER.size
+    for section in sections:
+        offsets.append(position)
+        position += len(section)
+
+    header = HEADER.pack(MAGIC, VERSION, HEADER.size, count, len(link_target), len(placements), len(params),
+                         len(strings.values), board_event_first, *offsets, position, crc)
+    return header + b"".join(sections)
+
+
+def write_graph(board_path, graph_path=None):
+    graph_path = graph_path or graph_path_for(board_path)
+    blob = build_graph(boardlib.load_board(board_path), board_crc(board_path))
+    with open(graph_path, "wb") as f:
+        f.write(blob)
+    return graph_path
+
+
+#***************************************************************************#
+#********************************* Reading *********************************#
+#***************************************************************************#
+
+class BoardGraph:
+    """A binary board graph, read straight out of an mmap.
+
+    The space columns and link arrays are memoryviews into the mapping, so
+    graph.type[space] or graph.links(space) never copies anything.
+    """
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if len(self._map) < HEADER.size:
+            raise ValueError("%s: too small to be a board graph" % path)
+        (magic, version, header_size, self.space_count, self.link_count, self.placement_count,
+         self.param_count, self.string_count, self.board_event_first, spaces, links, event_first,
+         placements, params, strings, file_size, self.source_crc) = HEADER.unpack_from(self._map)
+        if magic != MAGIC or header_size != HEADER.size:
+            raise ValueError("%s: not a board graph" % path)
+        if version != VERSION:
+            raise ValueError("%s: board graph version %d, this tool reads version %d" % (path, version, VERSION))
+        if file_size != len(self._map):
+            raise ValueError("%s: truncated (%d of %d bytes)" % (path, len(self._map), file_size))
+
+        view = memoryview(self._map)
+        n = self.space_count
+        column = spaces
+        self.x, column = self._column(view, column, "h", n)
+        self.y, column = self._column(view, column, "h", n)
+        self.z, column = self._column(view, column, "h", n)
+        self.rotation, column = self._column(view, column, "h", n)
+        self.type, column = self._column(view, column, "B", n)
+        self.subtype, column = self._column(view, column, "B", n)
+        self.flags, column = self._column(view, column, "B", n)
+        self.link_first, column = self._column(view, links, "I", n + 1)
+        self.link_target, _ = self._column(view, column, "H", self.link_count)
+        self.event_first, _ = self._column(view, event_first, "I", n + 1)
+        self._placements = placements
+        self._params = params
+        self.string_first, column = self._column(view, strings, "I", self.string_count + 1)
+        self._string_data = column
+        self._string_ids = None
+
+    @staticmethod
+    def _column(view, offset, fmt, count):
+        """Returns (the array at offset, the 4-byte aligned offset just past it)."""
+        size = struct.calcsize(fmt) * count
+        raw = view[offset:offset + size]
+        if sys.byteorder == "little":
+            array = raw.cast(fmt)
+        else:
+            array = struct.unpack("<%d%s" % (count, fmt), raw)
+        return array, offset + size + (-size % 4)
+
+    def links(self, space):
+        return self.link_target[self.link_first[space]:self.link_first[space + 1]]
+
+    def is_star(self, space):
+        return bool(self.flags[space] & SPACE_FLAG_STAR)
+
+    def string(self, string_id):
+        start = self._string_data + self.string_first[string_id]
+        end = self._string_data + self.string_first[string_id + 1]
+        return self._map[start:end].decode("utf-8")
+
+    def string_id(self, value):
+        """The interned id of an event ID or parameter name, or None if the board never uses it."""
+        if self._string_ids is None:
+            self._string_ids = {self.string(i): i for i in range(self.string_count)}
+        return self._string_ids.get(value)
+
+    def placement(self, index):
+        """Returns (event string id, activationType, executionType, flags, space or None, first param, param count)."""
+        event, activation, execution, flags, space, first, count = \
+            PLACEMENT.unpack_from(self._map, self._placements + index * PLACEMENT.size)
+        return event, activation, execution, flags, (None if space == NO_SPACE else space), first, count
+
+    def placements_on(self, space):
+        return range(self.event_first[space], self.event_first[space + 1])
+
+    def board_events(self):
+        return range(self.board_event_first, self.placement_count)
+
+    def param(self, placement_index, name):
+        """A placement's parameter value (defaults included), or None."""
+        name_id = self.string_id(name)
+        _, _, _, _, _, first, count = self.placement(placement_index)
+        for index in range(first, first + count):
+            param_name, kind, _, value = PARAM.unpack_from(self._map, self._params + index * PARAM.size)
+            if param_name == name_id:
+                if kind == PARAM_KIND_BOOLEAN:
+                    return bool(value)
+                if kind == PARAM_KIND_STRING:
+                    return self.string(value)
+                return value
+        return None
+
+
+def load_graph(board_path):
+    """Opens the graph built from a board JSON, rebuilding it first if it's missing or stale."""
+    graph_path = graph_path_for(board_path)
+    if os.path.isfile(graph_path):
+        try:
+            graph = BoardGraph(graph_path)
+            if graph.source_crc == board_crc(board_path):
+                return graph
+        except ValueError:
+            pass
+    return BoardGraph(write_graph(board_path, graph_path))
+
+
+def dump(graph, out):
+    out.write("%d spaces, %d links, %d placements (%d board events), %d params, %d strings\n"
+              % (graph.space_count, graph.link_count, graph.placement_count,
+                 graph.placement_count - graph.board_event_first, graph.param_count, graph.string_count))
+    for space in range(graph.space_count):
+        out.write("  space %2d: type %2d at (%4d, %4d)%s -> %s\n"
+                  % (space, graph.type[space], graph.x[space], graph.y[space],
+                     " star" if graph.is_star(space) else "", list(graph.links(space))))
+        for index in graph.placements_on(space):
+            out.write("      %s\n" % graph.string(graph.placement(index)[0]))
+    for index in graph.board_events():
+        event, activation = graph.placement(index)[:2]
+        out.write("  board event (activation %d): %s\n" % (activation, graph.string(event)))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_build = sub.add_parser("build", help="pack a board JSON into a binary graph")
+    p_build.add_argument("board")
+    p_build.add_argument("-o", "--output", help="default: the board's path with .graph")
+    p_dump = sub.add_parser("dump", help="print a binary graph")
+    p_dump.add_argument("graph")
+    args = parser.parse_args(argv)
+
+    if args.command == "build":
+        path = write_graph(args.board, args.output)
+        sys.stdout.write("Wrote %s (%d bytes)\n" % (path, os.path.getsize(path)))
+        return 0
+    dump(BoardGraph(args.graph), sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,559 @@
+#!/usr/bin/env python3
+"""Board RAM slot allocator and conflict checker.
+
+Board RAM is the handful of bytes (D_800CD098 - D_800CD0A8) that survive between
+turns, so it's where events keep state across a game.  Every event used to pick
+its bytes by hand, and two events picking the same byte is a silent bug.
+
+This tool reads a board file, finds every custom event placed on it, and
+collects two kinds of board RAM use from each event's source:
+
+  * Declared slots - a header line like PARAM, giving a field name and how many
+    bits it needs (1-8):
+
+        // BOARD_RAM: FIRST_QUESTION_INDEX|6
+
+    Declared slots are packed together at bit granularity, so several events
+    can share one byte.
+
+  * Fixed slots - older events that still declare "extern u8 D_800CD0A3;".
+    These reserve the whole byte for that event.
+
+Events that are meant to share state (like the Triggered and Passive halves of
+Turn Order Swap) name the same group, and then share their slots instead of
+clashing.  A field declared with the same name in two events of one group gets
+one slot:
+
+        // BOARD_RAM_GROUP: Turn Order Swap
+
+An event that needs several bytes side by side (like an mp3lib overlay's
+snapshot block) asks for a run of whole bytes instead, and gets its address and
+size:
+
+        // BOARD_RAM_BYTES: HIDDEN_BLOCK_OVERLAY|4
+
+    #define HIDDEN_BLOCK_OVERLAY        (&D_800CD099)
+    #define HIDDEN_BLOCK_OVERLAY_SIZE   4
+
+A slot that's only used when a Boolean parameter is on names the parameter
+after its size, and is only reserved when a placement of the event on the
+board turns that parameter on.  Events given with --extra-event aren't placed,
+so they always get it:
+
+        // BOARD_RAM: HIDDEN_BLOCK_SCHEDULE_0|8|USE_TURN_SCHEDULE
+
+    The generated block leaves its defines out when it isn't reserved, so the
+    event can check with #ifdef HIDDEN_BLOCK_SCHEDULE_0_BYTE.
+
+Fields whose names start with MP3LIB_ belong to mp3lib itself (like the address
+of the per-placement instance table), so every event that declares one shares
+the same slot whatever its group.
+
+An event can also use a field of another group by putting the group's name in
+front of the field's, like Character Door adding to the Bonus Bids tallies:
+
+        // BOARD_RAM_BYTES: Bonus Bids.BONUS_BIDS_TALLIES|8|COUNTS_FOR_BONUS_BIDS
+
+If two events claim the same fixed byte, or the declared slots don't fit in
+what's left, the tool prints the problem and exits with status 1, so it can
+gate a board build.
+
+For each event with declared slots, it prints a block of defines to paste into
+the event (or writes it for you with --write, between the BOARD RAM SLOTS
+markers you'll find in mp3_Event_Template.c):
+
+    extern u8 D_800CD099;
+    #define FIRST_QUESTION_INDEX_BYTE   D_800CD099
+    #define FIRST_QUESTION_INDEX_SHIFT  0
+    #define FIRST_QUESTION_INDEX_WIDTH  6
+
+Every block also carries BOARD_RAM_LAYOUT_VERSION, a 2-bit hash of the whole
+board's layout.  The "Board State Header" event stamps it into board RAM, so a
+save made with an older layout gets its board RAM cleared instead of misread.
+Every board gets its own copy of that event: --header-copy PATH lays out the
+In-Work/MP3/BoardState template as "<board name> Board State Header" (the
+board's placement of it, if it has one) and writes the copy, this board's slots
+filled in, to PATH.  Place the copy on the board, never the template.
+
+Nothing is written unless the whole board fits, so a failed run never leaves
+half the events moved.  Events passed with --extra-event are laid out after the
+events placed on the board, in the bytes they leave free, so they never move
+the board's own events or change its BOARD_RAM_LAYOUT_VERSION.  Events for a
+board that doesn't have a board file yet can be laid out on their own by
+leaving the board out and passing them all with --extra-event.
+
+Placed events are laid out as the board deploys them.  An event the board
+pins to an older copy (see board_sources.py) is laid out from that copy, keeps
+its repository file's BOARD_RAM_GROUP, and never has a block written into its
+repository file, which the board doesn't run.  --repository-versions lays the
+board out as it will be once those events are updated to their repository
+versions, and writes or checks only them (and extra events in their groups), so
+the update is ready to review.
+
+With --check nothing is written, and the tool fails if any event's block in
+the repository differs from the one it would write, e.g. after another board's
+run rewrote an event the two boards share.
+
+Usage:
+    python3 Tools/board_ram_alloc.py Complete/MP3/Boards/GameNight/game_night.json
+    python3 Tools/board_ram_alloc.py Complete/MP3/Boards/GameNight/game_night.json --check
+    python3 Tools/board_ram_alloc.py Complete/MP3/Boards/GameNight/game_night.json --repository-versions --check
+    python3 Tools/board_ram_alloc.py game_night.json --extra-event Complete/MP3/TurnOrderSwap/TurnOrderImprovement.c
+    python3 Tools/board_ram_alloc.py --extra-event In-Work/MP3/CharacterSwap/CharacterDoor.c --board-name "Character Swap"
+    python3 Tools/board_ram_alloc.py game_night.json --header-copy In-Work/MP3/Board_Specific/GameNight/GameNight-BoardStateHeader.c --write
+"""
+
+import argparse
+import os
+import re
+import sys
+import zlib
+
+import boardlib
+
+# board_ram1 through board_ram17.
+BOARD_RAM_FIRST = 0x800CD098
+BOARD_RAM_LAST = 0x800CD0A8
+
+BEGIN_MARKER = "//******************** BOARD RAM SLOTS (generated) "
+END_MARKER = "//******************** /BOARD RAM SLOTS "
+
+# Starts the pared-down copy of mp3lib at the bottom of an event.
+MP3LIB_COPY_MARKER = "// NOTE - this instance of mp3lib is pared down"
+
+_EXTERN_RE = re.compile(r"^\s*extern\s+[us]8\s+D_([0-9A-Fa-f]{8})\s*;", re.MULTILINE)
+_FIELD_NAME_RE = re.compile(r"^[A-Z][A-Z0-9_]*$")
+
+# Fields with this prefix are shared by every event on the board.
+SHARED_FIELD_PREFIX = "MP3LIB_"
+SHARED_GROUP = "mp3lib"
+
+# The Board State Header every board places its own copy of (see --header-copy).
+HEADER_TEMPLATE = os.path.join(boardlib.REPO_ROOT, "In-Work", "MP3", "BoardState", "BoardStateHeader.c")
+HEADER_TEMPLATE_NAME = "Board State Header"
+
+
+class Field:
+    def __init__(self, group, name, width, order, byte_count=None):
+        self.group = group
+        self.name = name
+        self.width = width
+        self.order = order
+        self.byte_count = byte_count    # Set for BOARD_RAM_BYTES runs, None for bit fields.
+        self.address = None
+        self.shift = None
+        self.placed = True              # False for fields only --extra-event files declare
+
+
+def symbol(address):
+    return "D_%08X" % address
+
+
+def strip_generated_block(code):
+    """Removes a previously generated slot block so its externs don't count as fixed slots."""
+    begin = code.find(BEGIN_MARKER)
+    end = code.find(END_MARKER)
+    if begin < 0 or end < begin:
+        return code
+    return code[:begin] + code[end:]
+
+
+def strip_mp3lib_copy(code):
+    """mp3lib owns no whole bytes (its fields are the MP3LIB_ ones), so the externs in an event's copy
+    of it, like the one mp3_ClearBoardRAM() uses, aren't fixed slots."""
+    begin = code.find(MP3LIB_COPY_MARKER)
+    return code if begin < 0 else code[:begin]
+
+
+def event_group(name, code):
+    """Events without a BOARD_RAM_GROUP are in a group of their own."""
+    return boardlib.parse_event_header(code).get("BOARD_RAM_GROUP", name)
+
+
+def split_field_name(name, group):
+    """Returns (group, field name) for a declared name: "Other Group.NAME" is in Other Group, MP3LIB_
+    names are mp3lib's, and anything else is in the declaring event's group."""
+    if "." in name:
+        return tuple(name.rsplit(".", 1))
+    return (SHARED_GROUP if name.startswith(SHARED_FIELD_PREFIX) else group), name
+
+
+def split_declaration(decl, switched_on):
+    """Returns the NAME|size|PARAM parts of a declaration, or None when the parts don't read.
+
+    The optional PARAM is dropped from the result; the whole declaration comes back as [] when
+    switched_on (the parameters the event's placements turn on, or None for an extra event)
+    doesn't include it.
+    """
+    parts = decl.split("|")
+    group, _, name = parts[0].rpartition(".")
+    if "." in parts[0] and not group.strip():
+        return None
+    if len(parts) not in (2, 3) or not _FIELD_NAME_RE.match(name) or not parts[1].isdigit():
+        return None
+    if len(parts) == 3:
+        if not _FIELD_NAME_RE.match(parts[2]):
+            return None
+        if switched_on is not None and parts[2] not in switched_on:
+            return []
+    return parts[:2]
+
+
+def collect_event_needs(name, code, errors, switched_on=None):
+    """Returns (declared fields, fixed byte addresses) for one event."""
+    header = boardlib.parse_event_header(code)
+    group = header.get("BOARD_RAM_GROUP", name)
+    fields = []
+    for order, decl in enumerate(header.get("BOARD_RAM", [])):
+        parts = split_declaration(decl, switched_on)
+        if parts is None:
+            errors.append("%s: can't read 'BOARD_RAM: %s' (expected NAME|bits or NAME|bits|PARAM)" % (name, decl))
+            continue
+        if not parts:
+            continue
+        width = int(parts[1])
+        field_group, field_name = split_field_name(parts[0], group)
+        if width < 1 or width > 8:
+            errors.append("%s: %s needs %d bits; slots must be 1-8 bits so they never straddle a byte"
+                          % (name, field_name, width))
+            continue
+        fields.append(Field(field_group, field_name, width, order))
+
+    board_ram_size = BOARD_RAM_LAST - BOARD_RAM_FIRST + 1
+    for order, decl in enumerate(header.get("BOARD_RAM_BYTES", []), start=len(header.get("BOARD_RAM", []))):
+        parts = split_declaration(decl, switched_on)
+        if parts is None:
+            errors.append("%s: can't read 'BOARD_RAM_BYTES: %s' (expected NAME|bytes or NAME|bytes|PARAM)"
+                          % (name, decl))
+            continue
+        if not parts:
+            continue
+        count = int(parts[1])
+        field_group, field_name = split_field_name(parts[0], group)
+        if count < 1 or count > board_ram_size:
+            errors.append("%s: %s needs %d bytes; board RAM only has %d" % (name, field_name, count, board_ram_size))
+            continue
+        fields.append(Field(field_group, field_name, count * 8, order, byte_count=count))
+
+    fixed = set()
+    for match in _EXTERN_RE.finditer(strip_mp3lib_copy(strip_generated_block(code))):
+        address = int(match.group(1), 16)
+        if BOARD_RAM_FIRST <= address <= BOARD_RAM_LAST:
+            fixed.add(address)
+    return fields, fixed
+
+
+def board_ram_disabled(placements):
+    """An event whose every placement sets USES_BOARD_RAM to False doesn't claim its fixed slots.
+
+    Its declared slots still count, since they're switched by parameters of their own."""
+    values = [p.get("parameterValues", {}).get("USES_BOARD_RAM") for p in placements]
+    return bool(values) and all(v is False for v in values)
+
+
+def switched_on_params(placements):
+    """The Boolean parameters at least one placement turns on.  PartyPlanner64 leaves an unset one False."""
+    return {key for p in placements for key, value in (p.get("parameterValues") or {}).items() if value is True}
+
+
+def gather_events(board, use_embedded, repository_versions, extra_paths, errors):
+    """Returns (events, placed count, switched on, pending): an ordered list of (event name, source
+    code) for every custom event to check, the ones placed on the board first, switched_on_params()
+    for each placed event, and the names of the placed events whose repository file isn't what the
+    board deploys (pinned or drifted, see board_sources.py).
+
+    Placed events are laid out as the board deploys them, or with repository_versions as their
+    repository files are.
+    """
+    placements = {}
+    for _, placement in boardlib.iter_event_placements(board):
+        if placement.get("custom"):
+            placements.setdefault(placement["id"], []).append(placement)
+
+    repo_sources = {} if use_embedded else boardlib.find_repo_event_sources()
+    events = []
+    pending = set()
+    for name in sorted(placements):
+        deployed = board.get("events", {}).get(name, {}).get("code")
+        code = boardlib.read_text(repo_sources[name]) if name in repo_sources else deployed
+        if code is None:
+            errors.append("%s: placed on the board but no source was found" % name)
+            continue
+        if board_ram_disabled(placements[name]):
+            deployed = _EXTERN_RE.sub("", deployed) if deployed is not None else None
+            code = _EXTERN_RE.sub("", code)
+        if deployed is not None and deployed.replace("\r\n", "\n") != code.replace("\r\n", "\n"):
+            pending.add(name)
+            group = boardlib.parse_event_header(code).get("BOARD_RAM_GROUP")
+            if not repository_versions:
+                code = deployed
+                if group and "BOARD_RAM_GROUP" not in boardlib.parse_event_header(code):
+                    # An older copy from before its event named a group is still in that group.
+                    code = "// BOARD_RAM_GROUP: %s\n%s" % (group, code)
+        events.append((name, code))
+    placed_count = len(events)
+    switched_on = {name: switched_on_params(placements[name]) for name, _ in events}
+
+    for path in extra_paths:
+        code = boardlib.read_text(path)
+        name = boardlib.parse_event_header(code).get("NAME", path)
+        if name not in placements:
+            events.append((name, code))
+    return events, placed_count, switched_on, pending
+
+
+def allocate(events, errors, placed_count=None, switched_on=None):
+    """Assigns every declared field a (byte, shift) and returns (fields, fixed owners).
+
+    The first placed_count events are the ones placed on the board, and are laid out on their own
+    first; the rest (--extra-event files) then go into whatever is left.  So checking an extra event
+    against a board never moves the board's own events.  switched_on maps a placed event's name to
+    the parameters its placements turn on, for slots that depend on one.
+    """
+    if placed_count is None:
+        placed_count = len(events)
+    fixed_owner = {}
+    group_fields = {}
+    # Each byte fills from bit 0 upwards, so its free bits are always one run at the top.
+    used_bits = {a: 0 for a in range(BOARD_RAM_FIRST, BOARD_RAM_LAST + 1)}
+
+    for phase in (range(placed_count), range(placed_count, len(events))):
+        new_fields = []
+        for event_order in phase:
+            name, code = events[event_order]
+            fields, fixed = collect_event_needs(name, code, errors, (switched_on or {}).get(name))
+            group = event_group(name, code)
+            for address in sorted(fixed):
+                if address in fixed_owner and fixed_owner[address] != group:
+                    errors.append("%s is used by both '%s' and '%s'"
+                                  % (symbol(address), fixed_owner[address], group))
+                elif address not in fixed_owner and used_bits[address] != 0:
+                    errors.append("%s is used by '%s' and by slots already placed for the board"
+                                  % (symbol(address), group))
+                else:
+                    fixed_owner[address] = group
+                    used_bits.pop(address, None)
+            for field in fields:
+                key = (field.group, field.name)
+                if key in group_fields:
+                    if (group_fields[key].width, group_fields[key].byte_count) != (field.width, field.byte_count):
+                        errors.append("%s: %s is declared as %d bits in one event and %d in another"
+                                      % (field.group, field.name, group_fields[key].width, field.width))
+                    continue
+                field.event_order = event_order
+                field.placed = event_order < placed_count
+                group_fields[key] = field
+                new_fields.append(field)
+        place_fields(new_fields, used_bits, errors)
+    return list(group_fields.values()), fixed_owner
+
+
+def place_fields(fields, used_bits, errors):
+    """Packs fields into the free bits of used_bits, updating it as they go in."""
+    # Byte runs go first, while board RAM still has long stretches of untouched bytes.
+    for field in sorted((f for f in fields if f.byte_count),
+                        key=lambda f: (-f.byte_count, f.event_order, f.order)):
+        free = [a for a in sorted(used_bits) if used_bits[a] == 0]
+        for start in free:
+            run = [start + i for i in range(field.byte_count)]
+            if all(a in used_bits and used_bits[a] == 0 for a in run):
+                field.address = start
+                field.shift = 0
+                for a in run:
+                    used_bits[a] = 8
+                break
+        else:
+            errors.append("%s: no run of %d free bytes left in board RAM for %s"
+                          % (field.group, field.byte_count, field.name))
+
+    # First-fit decreasing: the widest fields go first so narrow ones fill the gaps they leave.
+    for field in sorted((f for f in fields if not f.byte_count),
+                        key=lambda f: (-f.width, f.event_order, f.order)):
+        for address in sorted(used_bits):
+            if used_bits[address] + field.width <= 8:
+                field.address = address
+                field.shift = used_bits[address]
+                used_bits[address] += field.width
+                break
+        else:
+            errors.append("%s: no room left in board RAM for %s (%d bits)"
+                          % (field.group, field.name, field.width))
+
+
+def layout_version(fields, fixed_owner, placed_groups):
+    """Hashes where the board's own events landed down to the 2 bits the board state header has room for.
+
+    Extra events aren't on the board, so they don't change its version.
+    """
+    layout = sorted("%s.%s@%s:%d:%d" % (f.group, f.name, symbol(f.address), f.shift, f.width)
+                    for f in fields if f.address is not None and f.placed)
+    layout += sorted("%s@%s" % (owner, symbol(address)) for address, owner in fixed_owner.items()
+                     if owner in placed_groups)
+    return zlib.crc32("\n".join(layout).encode("utf-8")) & 3
+
+
+def render_block(board_name, event_name, fields, version):
+    lines = [BEGIN_MARKER + "*" * max(0, 79 - len(BEGIN_MARKER)),
+             "// Generated by Tools/board_ram_alloc.py for the \"%s\" board." % board_name,
+             "// Re-run the tool instead of editing these by hand.  Event: %s" % event_name,
+             "#define %-40s %d" % ("BOARD_RAM_LAYOUT_VERSION", version)]
+    for address in sorted({f.address for f in fields}):
+        lines.append("extern u8 %s;" % symbol(address))
+    for field in fields:
+        if field.byte_count:
+            lines.append("#define %-40s (&%s)" % (field.name, symbol(field.address)))
+            lines.append("#define %-40s %d" % (field.name + "_SIZE", field.byte_count))
+            continue
+        lines.append("#define %-40s %s" % (field.name + "_BYTE", symbol(field.address)))
+        lines.append("#define %-40s %d" % (field.name + "_SHIFT", field.shift))
+        lines.append("#define %-40s %d" % (field.name + "_WIDTH", field.width))
+    lines.append(END_MARKER + "*" * max(0, 79 - len(END_MARKER)))
+    return "\n".join(lines) + "\n"
+
+
+def header_copy_name(board_name):
+    return "%s %s" % (board_name, HEADER_TEMPLATE_NAME)
+
+
+def render_header_copy(template, name, block):
+    """The Board State Header template, renamed for one board and with that board's slot block."""
+    code = template.replace("// NAME: %s\n" % HEADER_TEMPLATE_NAME, "// NAME: %s\n" % name, 1)
+    return boardlib.replace_generated_block(code, block, BEGIN_MARKER, END_MARKER)
+
+
+def write_block_into_source(path, block):
+    """Replaces the generated block between the markers.  Returns False if the markers are missing."""
+    return boardlib.write_generated_block(path, block, BEGIN_MARKER, END_MARKER)
+
+
+def print_report(fields, fixed_owner, out):
+    out.write("Board RAM map (bit 0 is the lowest bit of each byte):\n")
+    for address in range(BOARD_RAM_FIRST, BOARD_RAM_LAST + 1):
+        if address in fixed_owner:
+            owner = "whole byte - %s" % fixed_owner[address]
+        else:
+            slots = sorted((f for f in fields if f.address == address), key=lambda f: f.shift)
+            runs = [f for f in fields if f.byte_count and f.address is not None
+                    and f.address < address < f.address + f.byte_count]
+            if runs:
+                owner = "%s.%s (continued)" % (runs[0].group, runs[0].name)
+            elif slots and slots[0].byte_count:
+                owner = "%s.%s [%d bytes]" % (slots[0].group, slots[0].name, slots[0].byte_count)
+            elif slots:
+                owner = ", ".join("%s.%s [%d:%d]" % (f.group, f.name, f.shift + f.width - 1, f.shift)
+                                  for f in slots)
+            else:
+                owner = "free"
+        out.write("  %s  %s\n" % (symbol(address), owner))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("board", nargs="?", help="PartyPlanner64 board JSON (leave out to lay out just the --extra-event files)")
+    parser.add_argument("--board-name", help="board name for the generated blocks when there's no board file")
+    parser.add_argument("--embedded", action="store_true",
+                        help="read event sources from the board file instead of the repository")
+    parser.add_argument("--repository-versions", action="store_true",
+                        help="lay out the repository version of every event the board pins, and write or check "
+                             "only those")
+    parser.add_argument("--extra-event", action="append", default=[], metavar="PATH",
+                        help="also check an event that isn't placed on the board yet")
+    parser.add_argument("--write", action="store_true",
+                        help="write each event's slot block into its repository source")
+    parser.add_argument("--check", action="store_true",
+                        help="fail if any event's slot block in the repository isn't the one --write would write")
+    parser.add_argument("--header-copy", metavar="PATH",
+                        help="lay out this board's copy of the Board State Header, and write it to (or check it "
+                             "against) PATH")
+    args = parser.parse_args(argv)
+
+    if args.board is None and not args.extra_event:
+        parser.error("give a board file, or the events to lay out with --extra-event")
+    board = boardlib.load_board(args.board) if args.board else {}
+    board_name = args.board_name or board.get("name") or args.board
+    errors = []
+    events, placed_count, switched_on, pending = gather_events(board, args.embedded, args.repository_versions,
+                                                               args.extra_event, errors)
+    template = header_name = None
+    if args.header_copy:
+        template = boardlib.read_text(HEADER_TEMPLATE)
+        header_name = header_copy_name(board_name)
+        if header_name not in {name for name, _ in events}:
+            events.append((header_name, template))
+    if args.board is None:
+        placed_count = len(events)      # No board, so the extra events are the whole layout
+    # Extra events that share a group with a pinned event go with the repository version of it, so
+    # they're laid out with --repository-versions and left out of the layout of what the board deploys.
+    pending_groups = {event_group(name, code) for name, code in events[:placed_count] if name in pending}
+    if not args.repository_versions:
+        events = events[:placed_count] + [(name, code) for name, code in events[placed_count:]
+                                          if event_group(name, code) not in pending_groups]
+    fields, fixed_owner = allocate(events, errors, placed_count, switched_on)
+
+    placed_groups = {event_group(name, code) for name, code in events[:placed_count]}
+    version = layout_version(fields, fixed_owner, placed_groups)
+    print_report(fields, fixed_owner, sys.stdout)
+    sys.stdout.write("Layout version: %d\n" % version)
+
+    repo_sources = boardlib.find_repo_event_sources()
+    writes = []
+    header_block = None
+    for event_order, (name, code) in enumerate(events):
+        group = event_group(name, code)
+        is_pending = name in pending or (event_order >= placed_count and group in pending_groups)
+        if is_pending != args.repository_versions:
+            continue    # Pinned copies aren't ours to write, and --repository-versions only readies what they pin
+        header = boardlib.parse_event_header(code)
+        declared = {split_field_name(d.split("|")[0], group)
+                    for d in header.get("BOARD_RAM", []) + header.get("BOARD_RAM_BYTES", [])}
+        own = sorted((f for f in fields if f.address is not None and
+                      (f.group == group or (f.group, f.name) in declared)),
+                     key=lambda f: (f.event_order, f.order))
+        if not own:
+            continue
+        block = render_block(board_name, name, own, version)
+        sys.stdout.write("\n" + block)
+        if name == header_name:
+            header_block = block    # Written below, as the whole copy
+        elif name == HEADER_TEMPLATE_NAME:
+            errors.append("%s is a template; lay out this board's copy of it with --header-copy PATH" % name)
+        else:
+            writes.append((name, block))
+
+    header = render_header_copy(template, header_name, header_block) if header_block else None
+    if args.header_copy and header is None and not args.repository_versions:
+        errors.append("%s: no BOARD RAM SLOTS markers in %s" % (header_name, HEADER_TEMPLATE))
+
+    if args.write and not errors:
+        for name, block in writes:
+            path = repo_sources.get(name)
+            if path is None or not write_block_into_source(path, block):
+                errors.append("%s: couldn't --write, no BOARD RAM SLOTS markers in its source" % name)
+        if header is not None:
+            os.makedirs(os.path.dirname(os.path.abspath(args.header_copy)), exist_ok=True)
+            with open(args.header_copy, "w", encoding="utf-8", newline="\n") as f:
+                f.write(header)
+    elif args.check:
+        for name, block in writes:
+            path = repo_sources.get(name)
+            current = boardlib.read_generated_block(path, BEGIN_MARKER, END_MARKER) if path else None
+            if current is None:
+                errors.append("%s: no BOARD RAM SLOTS markers in its source" % name)
+            elif current != block:
+                errors.append("%s: its slot block isn't the one for the \"%s\" board (re-run with --write)"
+                              % (name, board_name))
+        if header is not None and (not os.path.isfile(args.header_copy)
+                                   or boardlib.read_text(args.header_copy) != header):
+            errors.append("%s: %s isn't the copy of the template for the \"%s\" board (re-run with --write)"
+                          % (header_name, args.header_copy, board_name))
+
+    if errors:
+        sys.stderr.write("\nBoard RAM check failed:\n")
+        for error in errors:
+            sys.stderr.write("  " + error + "\n")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""Keeps a board's embedded event code in step with the repository.
+
+PartyPlanner64 saves the full source of every custom event inside the board
+file, in its "events" map.  Those copies drift from the files under Complete/
+and In-Work/, and they make the board file huge (the Game Night Trivia Quiz
+alone is 90 KB of it).
+
+This tool swaps each embedded copy for a reference to the repository file it
+came from, addressed by the sha256 of that file:
+
+    "Game Night Trivia Quiz": {
+        "language": 1,
+        "source": "Complete/MP3/Board_Specific/GameNight/GameNight-Nintendo_Trivia_Quiz.c",
+        "sha256": "3f9c..."
+    }
+
+Line endings don't count as drift.  An event that was pasted in with CRLF
+endings gets "newline": "crlf", so rehydrate gives back exactly what was there.
+
+and puts the code back when it's time to open the board in PartyPlanner64:
+
+    extract    board.json -> board with references.  What the board deploys
+               never changes: an event whose embedded code differs from its
+               repository file is reported as drift and pinned, i.e. its code
+               is written byte for byte to deployed/ beside the board and
+               referenced there (or kept embedded with --keep-drifted).
+               --update NAME takes the repository version instead, for the
+               reviewed change that brings it into the board.  Events with no
+               file in the repository stay embedded.
+    rehydrate  board with references -> a board PartyPlanner64 can open.  Fails
+               if a referenced file has changed since the last extract, so a
+               changed event always shows up as a changed hash in the board's diff.
+               Images and music split out by board_assets.py are put back too.
+    verify     checks a board of either kind against the repository, and exits
+               with status 1 if what would be deployed doesn't match it.
+
+The other board tools (board_ram_alloc.py, door_lookahead.py) read either kind
+of board.  The pinned copies in deployed/ aren't event sources, so the tools
+that edit events (like board_ram_alloc.py --write) leave them alone.
+
+Usage:
+    python3 Tools/board_sources.py extract Complete/MP3/Boards/GameNight/game_night.json --in-place
+    python3 Tools/board_sources.py extract Complete/MP3/Boards/GameNight/game_night.json --in-place --update "Play Joy Animation"
+    python3 Tools/board_sources.py rehydrate Complete/MP3/Boards/GameNight/game_night.json -o game_night_full.json
+    python3 Tools/board_sources.py verify Complete/MP3/Boards/GameNight/game_night.json
+"""
+
+import argparse
+import os
+import sys
+
+import boardlib
+
+
+def same_code(a, b):
+    """PartyPlanner64 doesn't keep line endings, so compare without them."""
+    return a.replace("\r\n", "\n") == b.replace("\r\n", "\n")
+
+
+def relative_source(path):
+    return os.path.relpath(path, boardlib.REPO_ROOT).replace(os.sep, "/")
+
+
+def pin(code, board_dir, source_path):
+    """Writes an event's deployed code to the board's deployed/ folder, under its repository file's name.
+    Returns the path."""
+    folder = os.path.join(board_dir, boardlib.DEPLOYED_DIR_NAME)
+    os.makedirs(folder, exist_ok=True)
+    path = os.path.join(folder, os.path.basename(source_path))
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        f.write(code.replace("\r\n", "\n"))
+    return path
+
+
+def update_pinned(board, name, sources, out):
+    """Points a pinned reference back at the event's repository file and deletes the pinned copy."""
+    event = board["events"][name]
+    path = sources.get(name)
+    if path is None:
+        raise ValueError("%s isn't in the repository, so there's nothing to update it to" % name)
+    pinned = os.path.join(boardlib.REPO_ROOT, event["source"])
+    code = boardlib.read_source(path)
+    event["source"] = relative_source(path)
+    event["sha256"] = boardlib.source_hash(code)
+    if os.path.isfile(pinned):
+        os.remove(pinned)
+    out.write("  UPDATED    %s -> %s (the repository version replaces the pinned one)\n" % (name, relative_source(path)))
+
+
+def extract(board, board_dir, keep_drifted, updates, out):
+    """Swaps embedded code for references in place.  Returns the names of drifted events."""
+    sources = boardlib.find_repo_event_sources()
+    drifted = []
+    for name in sorted(board.get("events") or {}):
+        event = board["events"][name]
+        if boardlib.is_source_reference(event):
+            if name in updates and boardlib.is_deployed_copy(event["source"]):
+                update_pinned(board, name, sources, out)
+            continue
+        path = sources.get(name)
+        if path is None:
+            out.write("  embedded   %s (not in the repository)\n" % name)
+            continue
+
+        code = boardlib.read_source(path)
+        if not same_code(event.get("code", ""), code):
+            drifted.append(name)
+            if keep_drifted:
+                out.write("  DRIFTED    %s (kept embedded, differs from %s)\n" % (name, relative_source(path)))
+                continue
+            if name in updates:
+                out.write("  UPDATED    %s -> %s (the repository version replaces the embedded one)\n"
+                          % (name, relative_source(path)))
+            else:
+                repo_path = path
+                path = pin(event.get("code", ""), board_dir, repo_path)
+                code = boardlib.read_source(path)
+                out.write("  PINNED     %s -> %s (differs from %s; --update to take that instead)\n"
+                          % (name, relative_source(path), relative_source(repo_path)))
+        else:
+            out.write("  reference  %s -> %s\n" % (name, relative_source(path)))
+
+        reference = {k: v for k, v in event.items() if k != "code"}
+        reference["source"] = relative_source(path)
+        reference["sha256"] = boardlib.source_hash(code)
+        if "\r\n" in event.get("code", ""):
+            reference["newline"] = "crlf"
+        board["events"][name] = reference
+    return drifted
+
+
+def verify(board, out):
+    """Returns a list of problems with what this board would deploy."""
+    problems = []
+    sources = boardlib.find_repo_event_sources()
+    pinned = {name: event["source"] for name, event in (board.get("events") or {}).items()
+              if boardlib.is_source_reference(event) and boardlib.is_deployed_copy(event["source"])}
+    boardlib.rehydrate_events(board, strict=True, errors=problems)
+    for name in sorted(board.get("events") or {}):
+        event = board["events"][name]
+        if boardlib.is_source_reference(event):
+            continue    # Already reported by rehydrate_events
+        path = sources.get(name)
+        if name in pinned:
+            newer = "" if path is None or same_code(event.get("code", ""), boardlib.read_source(path)) \
+                else ", %s has changed since" % relative_source(path)
+            out.write("  pinned     %s (%s%s)\n" % (name, pinned[name], newer))
+        elif path is None:
+            out.write("  embedded   %s (not in the repository, can't check)\n" % name)
+        elif not same_code(event.get("code", ""), boardlib.read_source(path)):
+            problems.append("%s: deployed code differs from %s" % (name, relative_source(path)))
+        else:
+            out.write("  ok         %s\n" % name)
+    return problems
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_extract = sub.add_parser("extract", help="replace embedded event code with repository references")
+    p_extract.add_argument("board")
+    p_extract.add_argument("-o", "--output", help="where to write the board with references")
+    p_extract.add_argument("--in-place", action="store_true", help="overwrite the board file")
+    p_extract.add_argument("--keep-drifted", action="store_true",
+                           help="leave events that differ from the repository embedded instead of pinning them")
+    p_extract.add_argument("--update", action="append", default=[], metavar="NAME",
+                           help="take the repository version of this drifted or pinned event")
+
+    p_rehydrate = sub.add_parser("rehydrate", help="put the code back for PartyPlanner64")
+    p_rehydrate.add_argument("board")
+    p_rehydrate.add_argument("-o", "--output", required=True)
+
+    p_verify = sub.add_parser("verify", help="check a board's events against the repository")
+    p_verify.add_argument("board")
+
+    args = parser.parse_args(argv)
+    board = boardlib.load_raw_board(args.board)
+
+    if args.command == "extract":
+        if not args.output and not args.in_place:
+            parser.error("give -o/--output or --in-place")
+        before = os.path.getsize(args.board)
+        board_dir = os.path.dirname(os.path.abspath(args.output or args.board))
+        try:
+            drifted = extract(board, board_dir, args.keep_drifted, set(args.update), sys.stdout)
+        except ValueError as e:
+            sys.stderr.write("Extract failed: %s\n" % e)
+            return 1
+        output = args.board if args.in_place else args.output
+        boardlib.save_board(board, output, compact=False)
+        sys.stdout.write("Wrote %s: %d -> %d bytes, %d drifted event(s)\n"
+                         % (output, before, os.path.getsize(output), len(drifted)))
+        return 0
+
+    if args.command == "rehydrate":
+        errors = []
+        boardlib.rehydrate_events(board, strict=True, errors=errors)
+        boardlib.inline_assets(board, os.path.dirname(os.path.abspath(args.board)), errors=errors)
+        if errors:
+            sys.stderr.write("Rehydrate failed:\n")
+            for error in errors:
+                sys.stderr.write("  " + error + "\n")
+            return 1
+        boardlib.save_board(board, args.output, compact=True)
+        sys.stdout.write("Wrote %s (%d bytes)\n" % (args.output, os.path.getsize(args.output)))
+        return 0
+
+    problems = verify(board, sys.stdout)
+    if problems:
+        sys.stderr.write("\nBoard sources don't match the repository:\n")
+        for problem in problems:
+            sys.stderr.write("  " + problem + "\n")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
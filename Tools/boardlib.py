@@ -0,0 +1,345 @@
+"""Shared helpers for the host-side board tools.
+
+These scripts run on your PC, not on the N64.  They read PartyPlanner64 board
+files (like Complete/MP3/Boards/GameNight/game_night.json) and the event
+sources in this repository.  Only the Python 3 standard library is used, so
+there is nothing to install.
+"""
+
+import base64
+import collections
+import hashlib
+import json
+import mmap
+import os
+import re
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Folders that hold event sources.  Complete/ wins when an event NAME shows up
+# in more than one place.
+EVENT_SOURCE_DIRS = ("Complete", "In-Work")
+
+SINGLE_VALUE_HEADER_KEYS = ("NAME", "GAMES", "EXECUTION", "BOARD_RAM_GROUP")
+
+# Where Tools/board_assets.py puts a board's images and music, next to the board file.
+ASSET_DIR_NAME = "assets"
+
+# Where Tools/board_sources.py keeps, next to the board file, the code a board deploys for an event
+# whose repository file has moved on since.  These are pinned copies, not event sources, so
+# find_repo_event_sources() skips them.
+DEPLOYED_DIR_NAME = "deployed"
+
+# PartyPlanner64 stores images and music as data URLs: "data:image/png;base64,iVBOR..."
+_DATA_URL_RE = re.compile(r"^data:([^;,]*);base64,")
+
+# PartyPlanner64 space types that a dice roll passes over without using a step:
+# OTHER (invisible), STAR, START, ARROW and BLACKSTAR.
+STEP_FREE_SPACE_TYPES = (0, 5, 7, 13, 14)
+
+# PartyPlanner64 header lines look like "// NAME: ..." in C and "; NAME: ..." in MIPS.
+_HEADER_RE = re.compile(r"^\s*(?://|;)\s*([A-Z_]+):\s*(.*?)\s*$")
+
+
+def load_board(path, events=True):
+    """Loads a PartyPlanner64 board JSON file.
+
+    Events stored as references to repository sources (see
+    Tools/board_sources.py) get their code filled back in from the repository,
+    so callers see the same shape of board either way.  Pass events=False if
+    you only need the spaces and links.
+
+    Images and music stored as sidecar files (see Tools/board_assets.py) are
+    NOT read; they stay asset references until you open_asset() one.
+    """
+    board = load_raw_board(path)
+    if events:
+        rehydrate_events(board)
+    return board
+
+
+def load_raw_board(path):
+    """Loads a board file exactly as it is, without filling in any references."""
+    with open(path, "r", encoding="utf-8") as f:
+        return json.load(f)
+
+
+def save_board(board, path, compact):
+    """Boards with references are written indented so their diffs stay readable.
+    Full boards are written compact, the way PartyPlanner64 exports them."""
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        if compact:
+            json.dump(board, f, ensure_ascii=False, separators=(",", ":"))
+        else:
+            json.dump(board, f, ensure_ascii=False, indent=1)
+            f.write("\n")
+
+
+def source_hash(code):
+    """The content address of an event source: sha256 of its UTF-8 bytes."""
+    return hashlib.sha256(code.encode("utf-8")).hexdigest()
+
+
+def read_source(path):
+    """Reads an event source exactly as it is on disk, line endings and all."""
+    with open(path, "r", encoding="utf-8", errors="replace", newline="") as f:
+        return f.read()
+
+
+def is_source_reference(event):
+    return "source" in event and "code" not in event
+
+
+def rehydrate_events(board, root=REPO_ROOT, strict=False, errors=None):
+    """Replaces source references in board["events"] with the code they point to.
+
+    With strict, a reference whose file no longer hashes to the recorded
+    sha256 is reported in `errors` and left as a reference.  Otherwise the
+    current file is used, since the host tools (like board_ram_alloc.py
+    --write) edit those files themselves.  A missing file is always reported.
+    """
+    problems = []
+    for name, event in (board.get("events") or {}).items():
+        if not is_source_reference(event):
+            continue
+        path = os.path.join(root, event["source"])
+        if not os.path.isfile(path):
+            problems.append("%s: %s doesn't exist" % (name, event["source"]))
+            continue
+        code = read_source(path)
+        if strict and source_hash(code) != event.get("sha256"):
+            problems.append("%s: %s has changed since the board was extracted (re-run extract to accept it)"
+                            % (name, event["source"]))
+            continue
+        rehydrated = {k: v for k, v in event.items() if k not in ("source", "sha256", "newline")}
+        code = code.replace("\r\n", "\n")
+        if event.get("newline") == "crlf":
+            code = code.replace("\n", "\r\n")   # The event was pasted into PartyPlanner64 with CRLF endings
+        rehydrated["code"] = code
+        board["events"][name] = rehydrated
+    if errors is not None:
+        errors.extend(problems)
+    return board
+
+
+def parse_data_url(value):
+    """Returns (media type, base64 payload) for a base64 data URL, or None for any other value."""
+    if not isinstance(value, str):
+        return None
+    match = _DATA_URL_RE.match(value)
+    if not match:
+        return None
+    return match.group(1), value[match.end():]
+
+
+def is_asset_reference(value):
+    return isinstance(value, dict) and "asset" in value and "sha256" in value
+
+
+def iter_asset_slots(board):
+    """Yields (container, key, value) for every data URL or asset reference in the board.
+
+    Event code is skipped; everything else (bg, otherbg, audioData, ...) is
+    searched, so new PartyPlanner64 fields are picked up without changes here.
+    """
+    stack = [(board, key) for key in board if key != "events"]
+    while stack:
+        container, key = stack.pop()
+        value = container[key]
+        if is_asset_reference(value) or parse_data_url(value):
+            yield container, key, value
+        elif isinstance(value, dict):
+            stack.extend((value, k) for k in value)
+        elif isinstance(value, list):
+            stack.extend((value, i) for i in range(len(value)))
+
+
+def open_asset(board_dir, reference):
+    """Memory-maps a sidecar asset read-only and returns the mapping.
+
+    Nothing is read until the mapping is touched, so opening the 1.4 MB
+    board background just to check its size costs nothing.
+    """
+    with open(os.path.join(board_dir, reference["asset"]), "rb") as f:
+        if os.fstat(f.fileno()).st_size == 0:
+            return b""      # mmap can't map an empty file
+        return mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+
+def inline_assets(board, board_dir, strict=True, errors=None):
+    """Replaces asset references with the data URLs PartyPlanner64 expects.
+
+    A missing sidecar is always reported in `errors` and left as a reference.
+    With strict, so is a sidecar that no longer hashes to the recorded sha256.
+    """
+    problems = []
+    for container, key, value in list(iter_asset_slots(board)):
+        if not is_asset_reference(value):
+            continue
+        try:
+            data = open_asset(board_dir, value)
+        except OSError as e:
+            problems.append("%s: %s" % (value["asset"], e.strerror))
+            continue
+        if strict and hashlib.sha256(data).hexdigest() != value["sha256"]:
+            problems.append("%s has changed since the board was split (re-run split to accept it)" % value["asset"])
+            continue
+        container[key] = "data:%s;base64,%s" % (value.get("type", ""), base64.b64encode(data).decode("ascii"))
+    if errors is not None:
+        errors.extend(problems)
+    return board
+
+
+def iter_event_placements(board):
+    """Yields (space_index, placement) for every event placed on the board.
+
+    space_index is None for board events (after turn, before dice roll, ...).
+    """
+    for index, space in enumerate(board.get("spaces", [])):
+        for placement in space.get("events", []) or []:
+            yield index, placement
+    for placement in board.get("boardevents", []) or []:
+        yield None, placement
+
+
+def space_links(board, index):
+    """Returns the spaces that space `index` links forward to, as a list."""
+    links = board.get("links", {}).get(str(index), [])
+    return links if isinstance(links, list) else [links]
+
+
+def takes_a_step(board, space):
+    return board["spaces"][space].get("type") not in STEP_FREE_SPACE_TYPES
+
+
+def dice_distances(board, start, max_steps=None, stop_at=()):
+    """Returns {space: smallest dice roll that gets a player from start onto or past it}.
+
+    Steps are counted like the dice do: leaving the start space always costs
+    one, and after that only leaving a space that takes a step does, so an
+    invisible space between two blue spaces is one step past the first blue
+    space.  A 0-1 breadth-first walk, so every space comes out with its
+    smallest roll.  The walk doesn't go past spaces in stop_at, or further
+    than max_steps.
+    """
+    rolls = {start: 0}
+    queue = collections.deque([start])
+    while queue:
+        space = queue.popleft()
+        if space in stop_at and space != start:
+            continue
+        roll = rolls[space]
+        for nxt in space_links(board, space):
+            nxt_roll = roll + (1 if (space == start or takes_a_step(board, space)) else 0)
+            if (max_steps is not None and nxt_roll > max_steps) or nxt_roll >= rolls.get(nxt, nxt_roll + 1):
+                continue
+            rolls[nxt] = nxt_roll
+            # Zero-cost moves go to the front so rolls come out in order.
+            if nxt_roll == roll:
+                queue.appendleft(nxt)
+            else:
+                queue.append(nxt)
+    return rolls
+
+
+def placement_param(placement, name, event_header=None):
+    """Returns a placement's parameter value, falling back to the PARAM default in the event's header."""
+    values = placement.get("parameterValues") or {}
+    if name in values:
+        return values[name]
+    for param in (event_header or {}).get("PARAM", []):
+        parts = param.split("|")
+        if len(parts) >= 5 and parts[1] == name:
+            return int(parts[4])
+    return None
+
+
+def parse_event_header(code):
+    """Returns the PartyPlanner64 header of an event as a dict.
+
+    Single-value keys (NAME, GAMES, EXECUTION, BOARD_RAM_GROUP) map to a
+    string.  Repeatable keys (PARAM, BOARD_RAM, ...) map to a list of strings
+    in source order.  Parsing stops at the first line that is not a comment.
+    """
+    header = {}
+    for line in code.splitlines():
+        stripped = line.strip()
+        if not stripped:
+            continue
+        if not (stripped.startswith("//") or stripped.startswith(";")):
+            break
+        match = _HEADER_RE.match(stripped)
+        if not match:
+            continue
+        key, value = match.groups()
+        if key in SINGLE_VALUE_HEADER_KEYS:
+            header.setdefault(key, value)
+        else:
+            header.setdefault(key, []).append(value)
+    return header
+
+
+def find_repo_event_sources(root=REPO_ROOT):
+    """Maps each event NAME to the path of its source file in the repository."""
+    sources = {}
+    for top in EVENT_SOURCE_DIRS:
+        for dirpath, _, filenames in sorted(os.walk(os.path.join(root, top))):
+            if is_deployed_copy(os.path.join(dirpath, "")):
+                continue
+            for filename in sorted(filenames):
+                if not filename.endswith((".c", ".s")):
+                    continue
+                path = os.path.join(dirpath, filename)
+                with open(path, "r", encoding="utf-8", errors="replace") as f:
+                    name = parse_event_header(f.read()).get("NAME")
+                if name and name not in sources:
+                    sources[name] = path
+    return sources
+
+
+def is_deployed_copy(path):
+    """True for a file in a board's deployed/ folder (see DEPLOYED_DIR_NAME)."""
+    return DEPLOYED_DIR_NAME in path.replace(os.sep, "/").split("/")[:-1]
+
+
+def read_text(path):
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        return f.read()
+
+
+def read_generated_block(path, begin_marker, end_marker):
+    """Returns the generated block between the markers in a source file, end marker line included,
+    in the same shape write_generated_block() takes.  None if the markers are missing."""
+    code = read_text(path)
+    begin = code.find(begin_marker)
+    end = code.find(end_marker)
+    if begin < 0 or end < begin:
+        return None
+    end = code.find("\n", end)
+    return code[begin:] + "\n" if end < 0 else code[begin:end + 1]
+
+
+def replace_generated_block(code, block, begin_marker, end_marker):
+    """Returns code with the generated block between the markers replaced, end marker line and all.
+    None if the markers are missing."""
+    begin = code.find(begin_marker)
+    end = code.find(end_marker)
+    if begin < 0 or end < begin:
+        return None
+    end = code.find("\n", end)
+    end = len(code) if end < 0 else end + 1
+    return code[:begin] + block + code[end:]
+
+
+def write_generated_block(path, block, begin_marker, end_marker):
+    """Replaces the generated block between the markers in a source file.
+
+    The end marker's whole line is replaced too.  Returns False if the markers
+    are missing.
+    """
+    code = replace_generated_block(read_text(path), block, begin_marker, end_marker)
+    if code is None:
+        return False
+    with open(path, "w", encoding="utf-8", newline="") as f:
+        f.write(code)
+    return True
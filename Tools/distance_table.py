@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""All-pairs space distance table generator.
+
+CPU logic that wants to know "how far is this player from the star?" can't
+walk the board graph on the N64 every time it asks.  This tool walks it once,
+on your PC, for every pair of spaces, and writes the answers into a table an
+event can index with one load:
+
+    static const u8 DISTANCE_TABLE[97 * 97] = { ... };
+
+Entry (from * DISTANCE_TABLE_SPACE_COUNT + to) is the smallest dice roll that
+gets a player from space `from` onto or past space `to`, counted the way
+door_lookahead.py counts them (invisible, start, star and arrow spaces don't
+use up a step).  Spaces that can't be reached going forwards get
+DISTANCE_UNREACHABLE, and distances too big for an entry are clamped one
+below it.
+
+With --bits 6 the entries are packed 6 bits apiece (distances 0-62), which
+takes Game Night's table from 9409 bytes to 7057; read those with
+mplib_GetPackedField.  The mp3lib lookups (mp3_GetSpaceDistance and friends)
+handle both.
+
+The block also carries the star candidate index: the absolute index of every
+space marked as a possible star space on the board, so an event can find the
+nearest one with a few lookups.
+
+Spaces are numbered as in the board file, which is also the game's absolute
+space index, so events turn (chain, space) into an absolute index with
+GetAbsSpaceIndexFromChainSpaceIndex().
+
+Paste the DISTANCE TABLE markers into any event that wants the table and
+re-run this with --write whenever the board's spaces or links change:
+
+    //******************** DISTANCE TABLE (generated) **************************
+    //******************** /DISTANCE TABLE *************************************
+
+Usage:
+    python3 Tools/distance_table.py Complete/MP3/Boards/GameNight/game_night.json
+    python3 Tools/distance_table.py your_board.json --bits 6 --write --source your_event.c
+"""
+
+import argparse
+import sys
+
+import boardlib
+
+BEGIN_MARKER = "//******************** DISTANCE TABLE (generated) "
+END_MARKER = "//******************** /DISTANCE TABLE "
+
+UNREACHABLE = {8: 0xFF, 6: 0x3F}
+
+
+def build_matrix(board):
+    """Returns matrix[from][to] = smallest dice roll from `from` onto or past `to`, or None."""
+    count = len(board.get("spaces", []))
+    matrix = []
+    for start in range(count):
+        rolls = boardlib.dice_distances(board, start)
+        matrix.append([rolls.get(space) for space in range(count)])
+    return matrix
+
+
+def star_candidates(board):
+    return [index for index, space in enumerate(board.get("spaces", [])) if space.get("star")]
+
+
+def encode_entries(matrix, bits):
+    """Flattens the matrix into table entries, then packs them if bits < 8."""
+    unreachable = UNREACHABLE[bits]
+    entries = [unreachable if d is None else min(d, unreachable - 1) for row in matrix for d in row]
+    if bits == 8:
+        return entries
+    packed = bytearray((len(entries) * bits + 7) // 8)
+    for index, value in enumerate(entries):
+        bit = index * bits
+        window = value << (bit & 7)
+        packed[bit >> 3] |= window & 0xFF
+        if window >> 8:
+            packed[(bit >> 3) + 1] |= window >> 8
+    return list(packed)
+
+
+def render_block(board_name, matrix, bits, candidates):
+    table = encode_entries(matrix, bits)
+    count = len(matrix)
+    lines = [BEGIN_MARKER + "*" * max(0, 79 - len(BEGIN_MARKER)),
+             "// Generated by Tools/distance_table.py for the \"%s\" board." % board_name,
+             "// Re-run the tool instead of editing these by hand.",
+             "#define %-40s %d" % ("DISTANCE_TABLE_SPACE_COUNT", count),
+             "#define %-40s %d" % ("DISTANCE_TABLE_BITS", bits),
+             "#define %-40s %d" % ("DISTANCE_UNREACHABLE", UNREACHABLE[bits]),
+             "static const u8 DISTANCE_TABLE[%d] = {" % max(1, len(table))]
+    entries = ["0x%02X" % value for value in table] or ["0x%02X" % UNREACHABLE[bits]]
+    for row in range(0, len(entries), 16):
+        last = row + 16 >= len(entries)
+        lines.append("    " + ", ".join(entries[row:row + 16]) + ("" if last else ","))
+    lines.append("};")
+    lines.append("#define %-40s %d" % ("STAR_CANDIDATE_COUNT", len(candidates)))
+    lines.append("static const u8 STAR_CANDIDATES[%d] = { %s };"
+                 % (max(1, len(candidates)), ", ".join(str(c) for c in candidates) or "0"))
+    lines.append(END_MARKER + "*" * max(0, 79 - len(END_MARKER)))
+    return "\n".join(lines) + "\n"
+
+
+def print_report(matrix, candidates, out):
+    count = len(matrix)
+    reachable = [d for row in matrix for d in row if d is not None]
+    out.write("%d spaces, %d of %d pairs reachable going forwards, longest distance %d\n"
+              % (count, len(reachable), count * count, max(reachable) if reachable else 0))
+    out.write("Star candidates: %s\n" % (", ".join(str(c) for c in candidates) or "none"))
+    for candidate in candidates:
+        distances = [row[candidate] for row in matrix if row[candidate] is not None]
+        out.write("  space %d: reachable from %d spaces, farthest %d steps away\n"
+                  % (candidate, len(distances), max(distances) if distances else 0))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("board", help="PartyPlanner64 board JSON")
+    parser.add_argument("--bits", type=int, choices=(8, 6), default=8,
+                        help="bits per entry: 8 (one byte each, default) or 6 (packed)")
+    parser.add_argument("--write", action="store_true",
+                        help="write the table into each --source between the DISTANCE TABLE markers")
+    parser.add_argument("--source", action="append", default=[],
+                        help="event source to --write into (repeat for more than one)")
+    parser.add_argument("--quiet", action="store_true", help="don't print the generated block")
+    args = parser.parse_args(argv)
+
+    board = boardlib.load_board(args.board, events=False)
+    matrix = build_matrix(board)
+    candidates = star_candidates(board)
+    if len(candidates) > 255 or len(matrix) > 255:
+        sys.stderr.write("Distance table failed: more than 255 spaces or star candidates\n")
+        return 1
+
+    print_report(matrix, candidates, sys.stdout)
+    block = render_block(board.get("name", args.board), matrix, args.bits, candidates)
+    if not args.quiet:
+        sys.stdout.write("\n" + block)
+
+    errors = []
+    if args.write and not args.source:
+        errors.append("--write needs at least one --source")
+    for source in args.source if args.write else []:
+        if not boardlib.write_generated_block(source, block, BEGIN_MARKER, END_MARKER):
+            errors.append("%s: couldn't --write, no DISTANCE TABLE markers in it" % source)
+
+    if errors:
+        sys.stderr.write("\nDistance table failed:\n")
+        for error in errors:
+            sys.stderr.write("  " + error + "\n")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
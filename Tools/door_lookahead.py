@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Character Door lookahead table generator.
+
+Swap Character's CPUs should pick a character that can get through the next
+Character Door in front of them.  Walking the board graph on the N64 every time
+would mean following links space by space, so this tool walks it once, on your
+PC, and writes the answer for every space into a table:
+
+    static const u8 DOOR_LOOKAHEAD[97] = { ... };
+
+Entry N is the nearest Character Door a player standing on space N can reach
+within --steps dice steps along any path ahead, packed into one byte:
+
+    bits [2:0]  the door's DOOR_INDEX, to read its live state from board RAM
+    bits [4:3]  the door's placed PREFERRED_CHARACTER_CATEGORY
+    bits [6:5]  the door's OPEN_MODE
+    0xFF        no door within reach (DOOR_LOOKAHEAD_NONE)
+
+Steps are counted like the dice do: invisible, start, star and arrow spaces
+don't use up a step, so a door placed on an invisible space between two blue
+spaces is one step past the first blue space.  When two doors are equally
+close the lower DOOR_INDEX wins.
+
+Spaces are numbered as in the board file, which is also the game's absolute
+space index, so the event turns the player's chain and space index into an
+absolute index with GetAbsSpaceIndexFromChainSpaceIndex() and does one lookup.
+
+With --write, the table goes between the DOOR LOOKAHEAD markers of the Swap
+Character event (or the file given with --source).  Re-run it whenever doors
+or links on the board change.
+
+Usage:
+    python3 Tools/door_lookahead.py Complete/MP3/Boards/GameNight/game_night.json
+    python3 Tools/door_lookahead.py your_board.json --steps 6 --write
+"""
+
+import argparse
+import collections
+import os
+import sys
+
+import boardlib
+
+DOOR_EVENT_NAME = "Character Door"
+DEFAULT_SOURCE = os.path.join(boardlib.REPO_ROOT, "In-Work", "MP3", "CharacterSwap", "SwapCharacter.c")
+
+BEGIN_MARKER = "//******************** DOOR LOOKAHEAD (generated) "
+END_MARKER = "//******************** /DOOR LOOKAHEAD "
+
+NO_DOOR = 0xFF
+
+class Door:
+    def __init__(self, space, index, category, open_mode):
+        self.space = space
+        self.index = index
+        self.category = category
+        self.open_mode = open_mode
+
+    def entry(self):
+        return ((self.open_mode & 3) << 5) | ((self.category & 3) << 3) | (self.index & 7)
+
+
+def find_doors(board, errors):
+    """Returns {space index: Door} for every Character Door placed on the board."""
+    door_source = boardlib.find_repo_event_sources().get(DOOR_EVENT_NAME)
+    door_header = boardlib.parse_event_header(boardlib.read_text(door_source)) if door_source else {}
+
+    doors = {}
+    for space, placement in boardlib.iter_event_placements(board):
+        if space is None or placement.get("id") != DOOR_EVENT_NAME:
+            continue
+        door = Door(space,
+                    boardlib.placement_param(placement, "DOOR_INDEX", door_header) or 0,
+                    boardlib.placement_param(placement, "PREFERRED_CHARACTER_CATEGORY", door_header) or 0,
+                    boardlib.placement_param(placement, "OPEN_MODE", door_header) or 0)
+        doors[space] = door
+
+    by_index = collections.defaultdict(list)
+    for door in doors.values():
+        by_index[door.index].append(door.space)
+    for index, spaces in sorted(by_index.items()):
+        if len(spaces) > 1:
+            errors.append("DOOR_INDEX %d is used by more than one door (spaces %s)"
+                          % (index, ", ".join(str(s) for s in sorted(spaces))))
+    return doors
+
+
+def nearest_door(board, doors, start, max_steps):
+    """Returns (door, dice roll needed to reach it) for the nearest door ahead of start, or (None, None).
+
+    The walk stops at the first door on each path, since that door decides
+    whether the player gets any further.
+    """
+    rolls = boardlib.dice_distances(board, start, max_steps, stop_at=doors)
+    reached = [(roll, doors[space].index, space) for space, roll in rolls.items() if space in doors and space != start]
+    if not reached:
+        return None, None
+    roll, _, space = min(reached)
+    return doors[space], roll
+
+
+def build_table(board, doors, max_steps):
+    """Returns a list of (entry byte, door, roll) for every space on the board."""
+    table = []
+    for space in range(len(board.get("spaces", []))):
+        door, roll = nearest_door(board, doors, space, max_steps)
+        table.append((door.entry() if door else NO_DOOR, door, roll))
+    return table
+
+
+def render_block(board_name, table, max_steps, doors):
+    lines = [BEGIN_MARKER + "*" * max(0, 79 - len(BEGIN_MARKER)),
+             "// Generated by Tools/door_lookahead.py for the \"%s\" board, looking %d steps ahead."
+             % (board_name, max_steps),
+             "// Re-run the tool instead of editing these by hand."]
+    if not doors:
+        lines += ["// PLACEHOLDER: that board has no Character Doors, so every entry is DOOR_LOOKAHEAD_NONE and",
+                  "// CPUs score every character as free.  Re-run the tool on a board with doors before using it."]
+    lines += ["#define %-40s %d" % ("DOOR_LOOKAHEAD_SPACE_COUNT", len(table)),
+              "#define %-40s %d" % ("DOOR_LOOKAHEAD_STEPS", max_steps),
+              "static const u8 DOOR_LOOKAHEAD[%d] = {" % max(1, len(table))]
+    entries = ["0x%02X" % entry for entry, _, _ in table] or ["0x%02X" % NO_DOOR]
+    for row in range(0, len(entries), 12):
+        chunk = entries[row:row + 12]
+        last = row + 12 >= len(entries)
+        lines.append("    " + ", ".join(chunk) + ("" if last else ","))
+    lines.append("};")
+    lines.append(END_MARKER + "*" * max(0, 79 - len(END_MARKER)))
+    return "\n".join(lines) + "\n"
+
+
+def print_report(doors, table, out):
+    out.write("Character Doors:\n")
+    if not doors:
+        out.write("  none placed on this board - every space gets DOOR_LOOKAHEAD_NONE\n")
+    for space, door in sorted(doors.items(), key=lambda item: item[1].index):
+        out.write("  DOOR_INDEX %d on space %d: category %d, open mode %d\n"
+                  % (door.index, space, door.category, door.open_mode))
+    covered = sum(1 for entry, _, _ in table if entry != NO_DOOR)
+    out.write("Spaces with a door in reach: %d of %d\n" % (covered, len(table)))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("board", help="PartyPlanner64 board JSON")
+    parser.add_argument("--steps", type=int, default=10,
+                        help="how many dice steps ahead to look (default 10, the biggest roll)")
+    parser.add_argument("--write", action="store_true",
+                        help="write the table into the event source between the DOOR LOOKAHEAD markers")
+    parser.add_argument("--source", default=DEFAULT_SOURCE,
+                        help="event source to --write into (default: the Swap Character event)")
+    args = parser.parse_args(argv)
+
+    board = boardlib.load_board(args.board, events=False)    # Only the spaces and links
+    errors = []
+    doors = find_doors(board, errors)
+    table = build_table(board, doors, args.steps)
+
+    print_report(doors, table, sys.stdout)
+    block = render_block(board.get("name", args.board), table, args.steps, doors)
+    sys.stdout.write("\n" + block)
+
+    if args.write and not errors:
+        if not boardlib.write_generated_block(args.source, block, BEGIN_MARKER, END_MARKER):
+            errors.append("%s: couldn't --write, no DOOR LOOKAHEAD markers in it" % args.source)
+
+    if errors:
+        sys.stderr.write("\nDoor lookahead failed:\n")
+        for error in errors:
+            sys.stderr.write("  " + error + "\n")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
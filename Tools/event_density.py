@@ -0,0 +1,404 @@
+#!/usr/bin/env python3
+"""Board event-density report: how much custom event work a turn costs.
+
+Every custom event on a board costs some frames each time the game runs it,
+and on a busy board they add up: Game Night runs Turn Order Swap Passive
+after every turn and Reduce Hidden Blocks before every roll, and players
+walk past Ancient Mew, Item Shops and Game Guys every lap.  This tool
+estimates the total.
+
+It plays a single player around the board for thousands of turns (rolls of
+1-10, forks picked at random) on the binary board graph from board_graph.py,
+and counts how often each event is dispatched:
+  - passing events (activationType 1) on every space the player moves
+    through, but not the one the roll ends on, where only landing events run,
+  - landing events (2 and 3) on the space the roll ends on,
+  - board events by their timing: once per player turn for before/after
+    player turn and before dice roll, once per round of four player turns for
+    before/after turn.  The "after" ones run once the player has moved.
+
+Each dispatch is then costed with a static estimate of the event's code
+(see estimate_event_cost): a compute cost from its size, plus the frames it
+waits, which are frame_estimate.py's shortest and longest paths through the
+C.  Every dispatch waits the shortest path.  How often it takes the longest
+one, its show chance, comes from what triggers it:
+  - an event whose main() starts by returning unless some board RAM is set,
+    like Turn Order Swap Passive's "if((D_800CD0A3 != 1) || ...) return;",
+    is armed by the other events on the board that set those bytes (to
+    anything but 0).  It shows on the dispatches that come after one of them
+    ran, as if every run of theirs armed it.
+  - any other event is taken to show every time, its worst case.
+--show-chance overrides that per event, for a chance you've measured (with
+event_harness.py paths, say).  Assembly events aren't read by
+frame_estimate.py; their SleepProcess and message box calls are counted
+instead, as if every dispatch made them all.  The report gives dispatches
+and frames per player turn and per lap, expected and worst case (the longest
+path on every dispatch), and flags the board when the expected frames per
+player turn go over --budget.
+
+A lap is counted each time the player comes back to the first space of the
+loop they join from the start space.
+
+Usage:
+    python3 Tools/event_density.py Complete/MP3/Boards/GameNight/game_night.json
+    python3 Tools/event_density.py your_board.json --turns 50000 --budget 120
+"""
+
+import argparse
+import collections
+import random
+import re
+import sys
+
+import boardlib
+import board_graph
+import frame_estimate
+from frame_estimate import FRAMES_PER_SECOND, MESSAGE_FRAMES, PROMPT_FRAMES, SCENE_RELOAD_FRAMES
+
+# PartyPlanner64 activationType values.
+ACTIVATION_NAMES = {
+    1: "passing",
+    2: "landing",
+    3: "landing",
+    -1: "before turn",
+    -2: "before player turn",
+    -3: "after player turn",
+    -4: "before dice roll",
+    -5: "after turn",
+}
+PASSING = (1,)
+LANDING = (2, 3)
+PER_PLAYER_TURN = (-2, -3, -4)
+PER_ROUND = (-1, -5)
+AFTER_MOVING = (-3, -5)
+
+START_SPACE_TYPE = 7
+PLAYERS = 4
+
+# Cost model.  MP3 runs the board on a 93.75 MHz CPU; the frames waited are frame_estimate.py's.
+CYCLES_PER_FRAME = 93750000 // FRAMES_PER_SECOND
+CYCLES_PER_INSTRUCTION = 1.5        # Loads, branch delays and cache misses, roughly
+INSTRUCTIONS_PER_STATEMENT = 6      # For C; assembly events are counted an instruction per line
+
+# What assembly events are counted by.
+MESSAGE_CALLS = ("ShowMessage", "mp3_ShowMessageWithConfirmation", "ShowPlayerCoinChange")
+PROMPT_CALLS = ("GetBasicPromptSelection",)
+
+DEFAULT_BUDGET_FRAMES = 90          # 3 seconds of custom events per player turn
+
+# Board RAM, as the events name it: D_800CD098 to D_800CD0A8, and the slot defines that point there.
+_BOARD_RAM_RE = re.compile(r"D_800CD0[0-9A-Fa-f]{2}$")
+_SLOT_DEFINE_RE = re.compile(r"^\s*#\s*define\s+(\w+)\s+\(?&?(D_800CD0[0-9A-Fa-f]{2})\)?\s*$", re.M)
+_SIZE_DEFINE_RE = re.compile(r"^\s*#\s*define\s+(\w+)_SIZE\s+(\d+)\s*$", re.M)
+SET_CALLS = ("mplib_SetField", "mplib_SetPackedField")
+
+
+class EventCost:
+    def __init__(self, instructions, low_frames, high_frames, notes):
+        self.instructions = instructions
+        self.low_frames = low_frames        # Waited on the shortest path, every dispatch
+        self.high_frames = high_frames      # Waited on the longest path
+        self.notes = notes
+
+    def compute_frames(self):
+        return self.instructions * CYCLES_PER_INSTRUCTION / CYCLES_PER_FRAME
+
+    def expected_frames(self, show_chance):
+        return self.compute_frames() + self.low_frames + (self.high_frames - self.low_frames) * show_chance
+
+    def worst_frames(self):
+        return self.compute_frames() + self.high_frames
+
+
+def _strip_c(code):
+    code = re.sub(r"/\*.*?\*/", " ", code, flags=re.S)
+    code = re.sub(r"//[^\n]*", " ", code)
+    return re.sub(r'"(?:\\.|[^"\\])*"', '""', code)
+
+
+def estimate_event_cost(code):
+    """Returns an EventCost: a static estimate of an event's instructions and the frames it can wait.
+
+    The instructions are crude on purpose: statements (or assembly
+    instructions) counted.  The frames waited are frame_estimate.py's shortest
+    and longest paths through a C event's main(); an assembly event counts its
+    SleepProcess and message box calls, all of them on every dispatch.
+    """
+    if not code:
+        return EventCost(0, 0, 0, "no code on the board")
+    if code.lstrip().startswith(";"):
+        lines = [line.split("#")[0].split(";")[0].strip() for line in code.splitlines()]
+        instructions = sum(1 for line in lines if line and not line.endswith(":") and not line.startswith("."))
+        calls = collections.Counter(re.findall(r"\bjal\s+(\w+)", code))
+        messages = sum(calls[name] for name in MESSAGE_CALLS)
+        prompts = sum(calls[name] for name in PROMPT_CALLS)
+        wait = messages * MESSAGE_FRAMES + prompts * PROMPT_FRAMES
+        return EventCost(instructions, wait, wait, "assembly, %d message(s), %d prompt(s)" % (messages, prompts))
+
+    instructions = _strip_c(code).count(";") * INSTRUCTIONS_PER_STATEMENT
+    estimate = frame_estimate.estimate_code(code)
+    if estimate is None:
+        return EventCost(instructions, 0, 0, "no main()")
+    high = estimate.high
+    notes = "%d-%d frames waited: %d message(s), %d prompt(s), %d sleep frame(s), %d reload(s) on the longest path" \
+        % (estimate.low.frames, high.frames, high.messages, high.prompts, high.sleeps, high.reloads)
+    return EventCost(instructions, estimate.low.frames, high.frames, "; ".join([notes] + estimate.notes))
+
+
+def board_ram_names(code):
+    """Returns {name: set of board RAM bytes} for the names an event can reach board RAM by."""
+    names = {}
+    sizes = dict((name, int(size)) for name, size in _SIZE_DEFINE_RE.findall(code))
+    for name, address in _SLOT_DEFINE_RE.findall(code):
+        first = int(address[-2:], 16)
+        run = set("D_800CD0%02X" % (first + offset) for offset in range(sizes.get(name, 1)))
+        names[name] = run
+        if name.endswith("_BYTE"):
+            names[name[:-len("_BYTE")]] = run
+    return names
+
+
+def _bytes_named(token, names):
+    if _BOARD_RAM_RE.match(token):
+        return set([token.upper()])
+    return names.get(token, set())
+
+
+def guard_bytes(code):
+    """The board RAM bytes main()'s opening guard reads, or an empty set if it doesn't start with one.
+
+    A guard is main()'s first statement being an if whose body is just "return;".
+    """
+    tokens, _ = frame_estimate.tokenize(code)
+    main_function = frame_estimate.find_functions(tokens).get("main")
+    if main_function is None:
+        return set()
+    body = main_function[1]
+    if body[:2] != ["if", "("]:
+        return set()
+    close = frame_estimate.match_bracket(body, 1, "(", ")")
+    after = body[close + 1:close + 5]
+    if after[:2] != ["return", ";"] and after != ["{", "return", ";", "}"]:
+        return set()
+    names = board_ram_names(code)
+    read = set()
+    for token in body[2:close]:
+        read |= _bytes_named(token, names)
+    return read
+
+
+def written_bytes(code):
+    """The board RAM bytes an event sets to something other than 0."""
+    tokens, _ = frame_estimate.tokenize(code)
+    names = board_ram_names(code)
+    written = set()
+    for index, token in enumerate(tokens):
+        target = set()
+        if (token == "=" and 0 < index < len(tokens) - 1 and tokens[index - 1] not in "=!<>"
+                and tokens[index + 1] != "=" and tokens[index + 1:index + 3] != ["0", ";"]):
+            target = _bytes_named(tokens[index - 1], names)
+        elif token in SET_CALLS and tokens[index + 1:index + 2] == ["("]:
+            close = frame_estimate.match_bracket(tokens, index + 1, "(", ")")
+            if tokens[close - 2:close] != [",", "0"]:
+                target = _bytes_named(tokens[index + 2], names)
+        written |= target
+    return written
+
+
+def arming_events(codes):
+    """Returns {event name: set of the other events that arm it} for the events with a board RAM guard."""
+    writes = dict((name, written_bytes(code)) for name, code in codes.items() if code and not code.lstrip().startswith(";"))
+    armed = {}
+    for name, code in codes.items():
+        if not code or code.lstrip().startswith(";"):
+            continue
+        guard = guard_bytes(code)
+        if guard:
+            armed[name] = set(other for other, bytes_written in writes.items() if other != name and bytes_written & guard)
+    return armed
+
+
+def on_a_loop(graph, space):
+    """True if some path leads from space back to itself."""
+    seen = set()
+    stack = list(graph.links(space))
+    while stack:
+        current = stack.pop()
+        if current == space:
+            return True
+        if current not in seen:
+            seen.add(current)
+            stack.extend(graph.links(current))
+    return False
+
+
+def lap_space(graph, start):
+    """The first space on a loop that the player reaches from the start space, or None."""
+    current, seen = start, set()
+    while current not in seen:
+        if on_a_loop(graph, current):
+            return current
+        seen.add(current)
+        links = graph.links(current)
+        if len(links) == 0:
+            return None
+        current = links[0]
+    return None
+
+
+def simulate(graph, turns, seed, armed_by=None):
+    """Returns (dispatch counts by placement index, armed dispatch counts by placement index, laps) for
+    `turns` player turns.  armed_by maps a placement index to the placements whose dispatches arm it."""
+    rng = random.Random(seed)
+    armed_by = armed_by or {}
+    arms = collections.defaultdict(set)
+    for index, writers in armed_by.items():
+        for writer in writers:
+            arms[writer].add(index)
+    counts = collections.Counter()
+    shown = collections.Counter()
+    armed = set()
+    start_spaces = [s for s in range(graph.space_count) if graph.type[s] == START_SPACE_TYPE]
+    position = start_spaces[0] if start_spaces else 0
+    lap_marker = lap_space(graph, position)
+    laps = 0
+
+    def dispatch(index):
+        counts[index] += 1
+        if index in armed:
+            shown[index] += 1
+            armed.discard(index)
+        armed.update(arms[index])
+
+    def board_events(after_moving, turn):
+        for index in graph.board_events():
+            activation = graph.placement(index)[1]
+            if (activation in AFTER_MOVING) != after_moving:
+                continue
+            if activation in PER_PLAYER_TURN or (activation in PER_ROUND and turn % PLAYERS == 0):
+                dispatch(index)
+
+    for turn in range(turns):
+        board_events(False, turn)
+        remaining = rng.randint(1, 10)
+        while remaining > 0:
+            links = graph.links(position)
+            if len(links) == 0:
+                break
+            position = links[0] if len(links) == 1 else links[rng.randrange(len(links))]
+            if position == lap_marker:
+                laps += 1
+            if graph.type[position] not in boardlib.STEP_FREE_SPACE_TYPES:
+                remaining -= 1
+            if remaining > 0:
+                for index in graph.placements_on(position):
+                    if graph.placement(index)[1] in PASSING:
+                        dispatch(index)
+        for index in graph.placements_on(position):
+            if graph.placement(index)[1] in LANDING:
+                dispatch(index)
+        board_events(True, turn)
+    return counts, shown, laps
+
+
+def build_report(board, graph, turns, seed):
+    """Returns (rows, laps): a row per custom event and timing of (name, timing, dispatches per turn, EventCost,
+    show chance), where the show chance is None for an event that isn't armed by others (so shows every time)."""
+    names = {}
+    for index in range(graph.placement_count):
+        event, _, _, flags, _, _, _ = graph.placement(index)
+        if flags & board_graph.PLACEMENT_FLAG_CUSTOM:
+            names[index] = graph.string(event)
+    codes = dict((name, ((board.get("events") or {}).get(name) or {}).get("code", "")) for name in set(names.values()))
+    triggers = arming_events(codes)
+    armed_by = dict((index, set(other for other, other_name in names.items() if other_name in triggers[name]))
+                    for index, name in names.items() if name in triggers)
+    counts, shown, laps = simulate(graph, turns, seed, armed_by)
+
+    costs = {}
+    rows = collections.OrderedDict()
+    for index, name in names.items():
+        activation = graph.placement(index)[1]
+        if name not in costs:
+            costs[name] = estimate_event_cost(codes[name])
+        key = (name, ACTIVATION_NAMES.get(activation, "activation %d" % activation))
+        total, total_shown = rows.get(key, (0, 0))
+        rows[key] = (total + counts[index], total_shown + shown[index])
+    return [(name, timing, total / turns, costs[name],
+             (float(total_shown) / total if total else 0.0) if name in triggers else None)
+            for (name, timing), (total, total_shown) in rows.items()], laps
+
+
+def show_chance(name, derived, overrides):
+    if name in overrides:
+        return overrides[name]
+    return 1.0 if derived is None else derived
+
+
+def parse_show_chances(values, parser):
+    overrides = {}
+    for value in values:
+        name, _, chance = value.rpartition("=")
+        try:
+            overrides[name] = float(chance)
+        except ValueError:
+            parser.error("--show-chance wants NAME=CHANCE, like \"Turn Order Swap Passive=0.05\"")
+    return overrides
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("board", help="PartyPlanner64 board JSON")
+    parser.add_argument("--turns", type=int, default=20000, help="player turns to simulate (default 20000)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--budget", type=float, default=DEFAULT_BUDGET_FRAMES,
+                        help="expected custom event frames allowed per player turn (default %d)"
+                             % DEFAULT_BUDGET_FRAMES)
+    parser.add_argument("--show-chance", action="append", default=[], metavar="NAME=CHANCE",
+                        help="how often an event shows its messages, 0-1 (default: how often the events that "
+                             "trigger it ran, or 1)")
+    args = parser.parse_args(argv)
+    overrides = parse_show_chances(args.show_chance, parser)
+
+    board = boardlib.load_board(args.board)
+    graph = board_graph.load_graph(args.board)
+    rows, laps = build_report(board, graph, args.turns, args.seed)
+    turns_per_lap = args.turns / laps if laps else None
+
+    out = sys.stdout
+    out.write("%s: %d simulated player turns, %s\n\n" % (board.get("name", args.board), args.turns,
+              "a lap every %.1f turns" % turns_per_lap if turns_per_lap else "no laps (no start space on a loop)"))
+    out.write("Frames are per player turn: compute, expected (compute plus waits), and worst case.\n\n")
+    out.write("%-34s %-19s %9s %9s %6s %9s %9s %9s  %s\n" % ("custom event", "timing", "per turn", "per lap", "shows",
+                                                            "compute", "expected", "worst", "cost estimate"))
+    total_dispatches = total_compute = total_expected = total_worst = 0.0
+    for name, timing, per_turn, cost, derived in sorted(rows, key=lambda row: -row[2] * row[3].worst_frames()):
+        per_lap = "%9.2f" % (per_turn * turns_per_lap) if turns_per_lap else "%9s" % "-"
+        chance = show_chance(name, derived, overrides)
+        compute = per_turn * cost.compute_frames()
+        expected = per_turn * cost.expected_frames(chance)
+        worst = per_turn * cost.worst_frames()
+        total_dispatches += per_turn
+        total_compute += compute
+        total_expected += expected
+        total_worst += worst
+        out.write("%-34s %-19s %9.3f %s %6.3f %9.5f %9.2f %9.2f  ~%d instructions, %s\n"
+                  % (name[:34], timing, per_turn, per_lap, chance, compute, expected, worst, cost.instructions,
+                     cost.notes))
+
+    out.write("\nPer player turn: %.2f custom event dispatches; frames: %.5f compute, %.1f expected, %.1f worst case\n"
+              % (total_dispatches, total_compute, total_expected, total_worst))
+    if turns_per_lap:
+        out.write("Per lap:         %.2f custom event dispatches; frames: %.5f compute, %.1f expected, %.1f worst case\n"
+                  % (total_dispatches * turns_per_lap, total_compute * turns_per_lap,
+                     total_expected * turns_per_lap, total_worst * turns_per_lap))
+    if total_expected > args.budget:
+        out.write("\nOVER BUDGET: custom events add %.1f frames (%.1f s) to a player turn on average, budget is %.0f\n"
+                  % (total_expected, total_expected / FRAMES_PER_SECOND, args.budget))
+        return 1
+    out.write("\nWithin budget (%.0f frames per player turn)\n" % args.budget)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,866 @@
+#!/usr/bin/env python3
+"""Event harness: runs a compiled event on your PC and counts what it costs the N64's CPU.
+
+event_density.py guesses an event's cost from its source.  This runs the
+real code: compile the event to a MIPS object with your N64 toolchain, and
+the harness loads it into a model of the console's RDRAM, runs main() on the
+r4300.py interpreter, and reports instructions, CPU cycles (with the VR4300's
+16 KB instruction cache and 8 KB data cache) and the frames the event waits.
+
+    mips64-elf-gcc -march=vr4300 -mabi=32 -mno-abicalls -fno-pic -G0 -O2 -c YourEvent.c -o YourEvent.o
+
+The game itself isn't emulated.  Every function the event calls but doesn't
+define (ShowMessage, GetRandomByte, GetPlayerStruct, the func_800XXXXX
+calls...) runs a Python stand-in from HOST_FUNCTIONS instead, which does what
+the event needs from it (hands out heap, answers prompts, moves coins) and
+adds what the real one costs:
+  - frames it waits: SleepProcess(N) waits N, waiting on a message box
+    MESSAGE_FRAMES and a prompt PROMPT_FRAMES (event_density.py's numbers),
+  - GAME_CALL_CYCLES for the game's own code, plus a cycle a byte for bzero
+    and bcopy.
+Functions it doesn't know are logged and return 0.  D_800XXXXX symbols are
+that address in RDRAM, so board RAM and the turn counters are where the
+event expects them; --set pokes them before the run.
+
+One run follows one path through the event: the one its random bytes
+(--seed), prompt answers (--choice) and CPU players (--cpu) lead it down.
+--runs repeats it with the next seeds and gives the spread.  Heap is what
+the event had allocated at its peak.
+
+`paths` runs every path instead, to find the longest one a player can be
+made to wait through.  It answers each prompt every way it can be answered
+(its option count is the number of options in the message shown before it),
+gives each of the first --random-draws GetRandomByte calls each of
+--random-values values spread over 0-255 (later draws get 0, so re-roll
+loops end), and with --either-cpu tries every player the event asks about
+as both a human and a CPU.  Every leaf gets a row with its frames, heap and
+instructions, worst first, and the worst one is marked; --budget fails the
+run when it waits longer than that many frames.
+
+Every run also records the answers it got (each random byte, prompt
+answer and PlayerIsCPU answer) as an input trace.  `run --record FILE` saves
+it (with --runs, the slowest run's; with `paths`, the worst path's) and
+`run --replay FILE` feeds it back to the event exactly, so two builds of an
+event can be timed on identical inputs, or a slow run replayed with
+--trace.  Each kind of answer replays in its own order, so a build that
+draws the RNG before a prompt instead of after still gets the same values;
+a build that asks for more than was recorded stops with a fault, and one
+that asks for fewer is reported.
+
+`buffers` sizes the heap buffers messages are built in.  It runs every
+path the way `paths` does (by default every value of the first random byte,
+so every question of a quiz that picks one with it), and again with every
+player as each character when the event reads characters, including one
+past Daisy for the fallback a bad player index hits.  Each malloc gets a
+red zone after it, and the harness watches the event's stores: for each
+malloc call site it reports the most bytes any run wrote from the start of
+the buffer (the terminating 0 included) and suggests that, rounded up to
+the heap's 8 bytes, as the size to ask for (shrink the bzero with it).
+Sites that are never written are flagged for removal, and a store or bzero
+past the end of any buffer fails the run.
+
+Usage:
+    python3 Tools/event_harness.py run YourEvent.o
+    python3 Tools/event_harness.py run YourEvent.o --player 1 --cpu 1 --choice 1 --runs 100
+    python3 Tools/event_harness.py run YourEvent.o --set 0x800CD0A7=0x10 --trace
+    python3 Tools/event_harness.py paths TurnOrderTriggered.o --either-cpu --budget 600
+    python3 Tools/event_harness.py run Old.o --runs 200 --record slow.trace, then
+    python3 Tools/event_harness.py run New.o --replay slow.trace
+    python3 Tools/event_harness.py buffers GameNight-Nintendo_Trivia_Quiz.o
+"""
+
+import argparse
+import bisect
+import collections
+import copy
+import random
+import struct
+import sys
+import zlib
+
+import r4300
+from event_density import CYCLES_PER_FRAME, FRAMES_PER_SECOND, MESSAGE_FRAMES, PROMPT_FRAMES, SCENE_RELOAD_FRAMES
+
+# RDRAM layout.  MP3 doesn't use the Expansion Pak's 4 MB, so the event and
+# everything the harness hands it lives up there.
+EVENT_BASE = 0x80400000
+HEAP_BASE = 0x80600000
+HEAP_END = 0x80700000
+STACK_TOP = 0x807F0000
+HOST_BASE = 0x807F8000                  # Each host function gets a fake address here
+RETURN_ADDRESS = 0x80000000             # main() returning lands here
+
+PLAYER_STRUCTS = 0x800D1108             # MP3's four struct Players
+PLAYER_STRUCT_SIZE = 56
+PLAYER_COINS, PLAYER_FLAGS, PLAYER_CHARACTER = 10, 4, 3
+CHARACTER_NAMES = ("Mario", "Luigi", "Peach", "Yoshi", "Wario", "DK", "Waluigi", "Daisy")
+TOTAL_TURNS = 0x800CD05A
+CURRENT_TURN = 0x800CD05B
+
+GAME_CALL_CYCLES = 40                   # The game's own code behind each call, roughly
+HEAP_FILL = 0xAA                        # New allocations aren't zeroed on the console either
+MESSAGE_OPTION = 0x0C                   # "Start option" in a message string
+RED_ZONE = 1024                         # Gap after each allocation in `buffers`, to catch overflows in
+MAX_COINS = 999
+
+# Input trace file: this header, then the random bytes, the prompt answers
+# (a byte each) and the PlayerIsCPU answers (a bit each, lowest bit first).
+TRACE_MAGIC = b"MPIT"
+TRACE_VERSION = 1
+TRACE_HEADER = struct.Struct("<4sBBHIIII")   # magic, version, player, reserved, 3 counts, crc32 of the rest
+
+
+class InputTrace:
+    """Every answer one run got, by kind, in the order it got them."""
+
+    def __init__(self, player=0):
+        self.player = player
+        self.random = bytearray()
+        self.prompts = bytearray()
+        self.cpu = []
+
+    def counts(self):
+        return "%d random bytes, %d prompt answers, %d PlayerIsCPU answers" % (
+            len(self.random), len(self.prompts), len(self.cpu))
+
+    def to_bytes(self):
+        cpu_bits = bytearray((len(self.cpu) + 7) // 8)
+        for index, answer in enumerate(self.cpu):
+            if answer:
+                cpu_bits[index >> 3] |= 1 << (index & 7)
+        body = bytes(self.random) + bytes(self.prompts) + bytes(cpu_bits)
+        return TRACE_HEADER.pack(TRACE_MAGIC, TRACE_VERSION, self.player, 0, len(self.random),
+                                 len(self.prompts), len(self.cpu), zlib.crc32(body)) + body
+
+    @classmethod
+    def from_bytes(cls, data):
+        if len(data) < TRACE_HEADER.size or data[:4] != TRACE_MAGIC:
+            raise ValueError("not an input trace")
+        _, version, player, _, randoms, prompts, cpus, crc = TRACE_HEADER.unpack_from(data)
+        if version != TRACE_VERSION:
+            raise ValueError("input trace version %d, this tool reads version %d" % (version, TRACE_VERSION))
+        body = data[TRACE_HEADER.size:]
+        if len(body) != randoms + prompts + (cpus + 7) // 8 or zlib.crc32(body) != crc:
+            raise ValueError("input trace is truncated or corrupt")
+        trace = cls(player)
+        trace.random = bytearray(body[:randoms])
+        trace.prompts = bytearray(body[randoms:randoms + prompts])
+        bits = body[randoms + prompts:]
+        trace.cpu = [(bits[index >> 3] >> (index & 7)) & 1 for index in range(cpus)]
+        return trace
+
+    @classmethod
+    def load(cls, path):
+        with open(path, "rb") as f:
+            return cls.from_bytes(f.read())
+
+    def save(self, path):
+        with open(path, "wb") as f:
+            f.write(self.to_bytes())
+
+
+class Inputs:
+    """Everything the event asks that a player or the RNG would answer.
+
+    Records each answer in `log` as (kind, value), so a run can say which
+    path it took.
+    """
+
+    def __init__(self, seed=1, choices=()):
+        self.rng = random.Random(seed)
+        self.choices = list(choices)
+        self.log = []
+
+    def random_byte(self):
+        value = self.rng.randrange(256)
+        self.log.append(("random", value))
+        return value
+
+    def prompt(self, options):
+        """The option a human picks from a prompt with `options` choices."""
+        value = self.choices.pop(0) if self.choices else 0
+        self.log.append(("prompt", value))
+        return value
+
+    def player_is_cpu(self, player, flags_say):
+        self.log.append(("cpu", int(flags_say)))
+        return flags_say
+
+    def describe(self):
+        parts = ["%s %d" % entry for entry in self.log if entry[0] != "cpu"]
+        return ", ".join(parts) or "no choices"
+
+
+class ReplayInputs(Inputs):
+    """Inputs that hand back an InputTrace's answers, each kind in its recorded order."""
+
+    def __init__(self, trace):
+        Inputs.__init__(self)
+        self.trace = trace
+        self.used = {"random": 0, "prompt": 0, "cpu": 0}
+
+    def _next(self, kind, values):
+        index = self.used[kind]
+        if index >= len(values):
+            raise r4300.Fault("the input trace ran out: the event asked for %s answer %d, %d were recorded"
+                              % (kind, index + 1, len(values)))
+        self.used[kind] += 1
+        return values[index]
+
+    def random_byte(self):
+        value = self._next("random", self.trace.random)
+        self.log.append(("random", value))
+        return value
+
+    def prompt(self, options):
+        value = self._next("prompt", self.trace.prompts)
+        self.log.append(("prompt", value))
+        return value
+
+    def player_is_cpu(self, player, flags_say):
+        return self._next("cpu", self.trace.cpu)
+
+    def unused(self):
+        """What the event didn't ask for, or None."""
+        left = [(len(values) - self.used[kind], kind) for kind, values in
+                (("random", self.trace.random), ("prompt", self.trace.prompts), ("cpu", self.trace.cpu))]
+        left = ["%d %s" % (count, kind) for count, kind in left if count]
+        return ", ".join(left) or None
+
+
+class PathInputs(Inputs):
+    """Inputs for one run of `paths`: the decisions in prefix, then the first option of every later one.
+
+    Every answer that could have gone another way is a decision, kept in
+    `decisions` as (kind, index picked, how many there were to pick from).
+    """
+
+    def __init__(self, prefix, random_values, random_draws, either_cpu):
+        """random_values has a list of values to try for each draw; the last list goes for the rest."""
+        Inputs.__init__(self)
+        self.prefix = prefix
+        self.random_values = random_values
+        self.random_draws = random_draws
+        self.either_cpu = either_cpu
+        self.decisions = []
+        self.draws = 0
+        self.fixed_draws = 0
+        self.cpu_answers = {}
+
+    def _decide(self, kind, count):
+        index = len(self.decisions)
+        pick = self.prefix[index] if index < len(self.prefix) else 0
+        self.decisions.append((kind, pick, count))
+        return pick
+
+    def random_byte(self):
+        self.draws += 1
+        if self.draws > self.random_draws:
+            self.fixed_draws += 1
+            return 0
+        values = self.random_values[min(self.draws, len(self.random_values)) - 1]
+        value = values[self._decide("random", len(values))]
+        self.log.append(("random", value))
+        return value
+
+    def prompt(self, options):
+        value = self._decide("prompt", options)
+        self.log.append(("prompt", value))
+        return value
+
+    def player_is_cpu(self, player, flags_say):
+        if not self.either_cpu:
+            return flags_say
+        if player not in self.cpu_answers:
+            self.cpu_answers[player] = self._decide("P%d" % (player + 1), 2)
+            self.log.append(("P%d %s" % (player + 1, "CPU" if self.cpu_answers[player] else "human"), None))
+        return self.cpu_answers[player]
+
+    def describe(self):
+        parts = [kind if value is None else "%s %d" % (kind, value) for kind, value in self.log]
+        if self.fixed_draws:
+            parts.append("%d more random 0" % self.fixed_draws)
+        return ", ".join(parts) or "no choices"
+
+
+class RunResult:
+    def __init__(self):
+        self.instructions = 0
+        self.cycles = 0
+        self.wait_frames = 0
+        self.heap_peak = 0
+        self.calls = collections.Counter()
+        self.unknown = collections.Counter()
+        self.messages = []
+        self.path = ""
+        self.inputs = None                  # InputTrace of the answers the run got
+        self.allocations = []               # Allocation per malloc, in order
+        self.reads_character = False        # Loaded a player's character (watch_buffers runs only)
+        self.return_value = 0
+        self.fault = None
+        self.icache = self.dcache = None
+
+    def compute_frames(self):
+        return self.cycles / CYCLES_PER_FRAME
+
+    def frames(self):
+        return self.compute_frames() + self.wait_frames
+
+
+class Allocation:
+    """One malloc: where it was called from, what it asked for, and how much of it got written."""
+
+    def __init__(self, site, address, size):
+        self.site = site                    # "function+0x1C" of the call
+        self.address = address
+        self.size = size
+        self.used = 0                       # One past the highest byte the event wrote, from the start
+        self.zeroed = 0                     # How much bzero cleared from the start
+
+    def overflow(self):
+        return max(0, max(self.used, self.zeroed) - self.size)
+
+
+class Game:
+    """The console an event runs on: RDRAM with the game state it reads, and the game's functions."""
+
+    def __init__(self, inputs, player=0, cpu_players=(), trace=None, watch_buffers=False):
+        self.memory = r4300.Memory()
+        self.cpu = r4300.Cpu(self.memory)
+        self.image = None
+        self.inputs = inputs
+        self.current_player = player
+        self.trace = trace
+        self.result = RunResult()
+        self.result.inputs = InputTrace(player)
+        self.heap_next = HEAP_BASE
+        self.heap_live = {}
+        self.heap_starts = []               # Allocation addresses, ascending, for _watch
+        self.red_zone = 0
+        self.sites = {}
+        if watch_buffers:
+            self.red_zone = RED_ZONE
+            self.cpu.watch = self._watch
+        self.option_count = 2
+        self.host_addresses = {}
+        for index in range(4):
+            base = PLAYER_STRUCTS + index * PLAYER_STRUCT_SIZE
+            self.memory.write_u8(base + PLAYER_CHARACTER, index)
+            self.memory.write_u8(base + PLAYER_FLAGS, 1 if index in cpu_players else 0)
+            self.memory.write_u16(base + PLAYER_COINS, 10)
+        self.memory.write_u8(TOTAL_TURNS, 20)
+        self.memory.write_u8(CURRENT_TURN, 1)
+
+    def load(self, data):
+        self.image = r4300.link_object(data, self.memory, EVENT_BASE, self.resolve)
+        return self.image
+
+    def resolve(self, name):
+        """Addresses for the symbols an event leaves undefined."""
+        prefix, _, address = name.partition("_")
+        if prefix == "D" and len(address) == 8:
+            try:
+                return int(address, 16)
+            except ValueError:
+                pass
+        if name not in self.host_addresses:
+            address = HOST_BASE + 8 * len(self.host_addresses)
+            self.host_addresses[name] = address
+            function = HOST_FUNCTIONS.get(name)
+            self.cpu.traps[address] = lambda cpu, name=name, function=function: self._call(name, function)
+        return self.host_addresses[name]
+
+    def run(self, image, entry="main", max_instructions=20000000):
+        if entry not in image.symbols:
+            raise ValueError("the object has no %s()" % entry)
+        self.cpu.gpr[r4300.SP] = r4300.sext32(STACK_TOP - 32)
+        result = self.result
+        try:
+            result.return_value = self.cpu.call(image.symbols[entry], return_address=RETURN_ADDRESS,
+                                                max_instructions=max_instructions) & r4300.MASK32
+        except r4300.Fault as e:
+            where = image.symbol_at(e.pc) if e.pc is not None else None
+            result.fault = str(e) + (" in %s" % where if where else "")
+        result.instructions = self.cpu.instructions
+        result.cycles = self.cpu.cycles
+        result.icache, result.dcache = self.cpu.icache, self.cpu.dcache
+        result.path = self.inputs.describe()
+        return result
+
+    # Host functions
+
+    def arg(self, index):
+        """Argument `index` of the call being made, as a signed 32-bit int."""
+        if index < 4:
+            return r4300.signed32(self.cpu.gpr[r4300.A0 + index])
+        return r4300.signed32(self.memory.read_u32((self.cpu.gpr[r4300.SP] + 4 * index) & r4300.MASK32))
+
+    def player(self, index):
+        return self.current_player if index < 0 else index & 3
+
+    def player_struct(self, index):
+        return PLAYER_STRUCTS + self.player(index) * PLAYER_STRUCT_SIZE
+
+    def wait(self, frames):
+        self.result.wait_frames += frames
+
+    def _call(self, name, function):
+        self.result.calls[name] += 1
+        self.cpu.cycles += GAME_CALL_CYCLES
+        if function is None:
+            self.result.unknown[name] += 1
+            value = 0
+        else:
+            value = function(self) or 0
+        if self.trace:
+            self.trace.write("  %-36s (%s) -> %s\n" % (name, ", ".join(_number(self.arg(i)) for i in range(4)), _number(value)))
+        self.cpu.gpr[r4300.V0] = r4300.sext32(value)
+
+    def malloc(self):
+        asked = max(0, self.arg(0))
+        size = (asked + 7) & ~7
+        if self.heap_next + size + self.red_zone > HEAP_END:
+            raise r4300.Fault("out of heap (%d bytes live)" % sum(self.heap_live.values()))
+        address = self.heap_next
+        self.heap_next += size + self.red_zone
+        self.heap_live[address] = size
+        self.memory.write(address, bytes([HEAP_FILL]) * (size + self.red_zone))
+        self.result.heap_peak = max(self.result.heap_peak, sum(self.heap_live.values()))
+        call = (self.cpu.gpr[r4300.RA] - 8) & r4300.MASK32
+        if call not in self.sites:
+            self.sites[call] = self.image.symbol_at(call) if self.image else None
+        self.result.allocations.append(Allocation(self.sites[call] or "%08X" % call, address, asked))
+        self.heap_starts.append(address)
+        return address
+
+    def free(self):
+        self.heap_live.pop(self.arg(0) & r4300.MASK32, None)
+
+    def bzero(self):
+        size = max(0, self.arg(1))
+        self.memory.write(self.arg(0), bytes(size))
+        self.cpu.cycles += size
+        allocation = self.allocation_at(self.arg(0) & r4300.MASK32)
+        if allocation:
+            allocation.zeroed = max(allocation.zeroed, (self.arg(0) & r4300.MASK32) + size - allocation.address)
+
+    def bcopy(self):
+        size = max(0, self.arg(2))
+        self.memory.write(self.arg(1), self.memory.read(self.arg(0), size))
+        self.cpu.cycles += size
+        if self.cpu.watch and size:
+            self._watch(self.arg(1) & r4300.MASK32, size, True)
+
+    def allocation_at(self, address):
+        """The allocation address is in (or in the red zone after), or None."""
+        if not self.heap_starts or not HEAP_BASE <= address < self.heap_next:
+            return None
+        return self.result.allocations[bisect.bisect_right(self.heap_starts, address) - 1]
+
+    def _watch(self, address, size, store):
+        """Cpu.watch for buffers: how far into each allocation the event writes, and if it reads characters."""
+        if store:
+            if HEAP_BASE <= address < self.heap_next:
+                allocation = self.allocation_at(address)
+                allocation.used = max(allocation.used, address + size - allocation.address)
+        elif PLAYER_STRUCTS <= address < PLAYER_STRUCTS + 4 * PLAYER_STRUCT_SIZE:
+            offset = (address - PLAYER_STRUCTS) % PLAYER_STRUCT_SIZE
+            if offset <= PLAYER_CHARACTER < offset + size:
+                self.result.reads_character = True
+
+    def show_message(self):
+        message = self.arg(1) & r4300.MASK32
+        if message >= r4300.K0BASE:
+            text = self.memory.read_cstring(message)
+            self.option_count = max(1, text.count(MESSAGE_OPTION))
+            self.result.messages.append(text)
+        else:
+            self.option_count = 2
+            self.result.messages.append(b"<message %d>" % message)
+
+    def prompt(self):
+        self.wait(PROMPT_FRAMES)
+        if self.is_cpu(-1):
+            strategy = self.arg(0)
+            return (0, 1, self.arg(1))[strategy] if 0 <= strategy <= 2 else 0
+        value = self.inputs.prompt(self.option_count)
+        self.result.inputs.prompts.append(value & 0xFF)
+        return value
+
+    def is_cpu(self, index):
+        index = self.player(index)
+        flags_say = self.memory.read_u8(self.player_struct(index) + PLAYER_FLAGS) & 1
+        answer = 1 if self.inputs.player_is_cpu(index, flags_say) else 0
+        self.result.inputs.cpu.append(answer)
+        return answer
+
+    def random_byte(self):
+        value = self.inputs.random_byte() & 0xFF
+        self.result.inputs.random.append(value)
+        return value
+
+    def player_is_cpu(self):
+        return self.is_cpu(self.arg(0))
+
+    def adjust_coins(self):
+        address = self.player_struct(self.arg(0)) + PLAYER_COINS
+        coins = r4300.sext16(self.memory.read_u16(address))
+        self.memory.write_u16(address, min(MAX_COINS, max(0, coins + self.arg(1))))
+
+
+def _number(value):
+    """Small numbers in decimal, pointers in hex."""
+    return "0x%08X" % (value & r4300.MASK32) if not -0x8000 <= value < 0x10000 else str(value)
+
+
+def _nothing(game):
+    return 0
+
+
+HOST_FUNCTIONS = {
+    "GetRandomByte": Game.random_byte,
+    "GetCurrentPlayerIndex": lambda game: game.current_player,
+    "GetPlayerStruct": lambda game: game.player_struct(game.arg(0)),
+    "PlayerIsCPU": Game.player_is_cpu,
+    "GetBasicPromptSelection": Game.prompt,
+    "SleepProcess": lambda game: game.wait(max(0, game.arg(0))),
+    "ShowMessage": Game.show_message,
+    "func_800EC9DC": lambda game: game.wait(MESSAGE_FRAMES),       # Wait for the player to confirm a message
+    "CloseMessage": _nothing,
+    "func_800EC6EC": _nothing,                                      # Message box teardown
+    "MallocPerm": Game.malloc,
+    "func_80035934": Game.malloc,                                   # malloc() from the scene heap
+    "FreePerm": Game.free,
+    "func_80035958": Game.free,
+    "bzero": Game.bzero,
+    "bcopy": Game.bcopy,
+    "AdjustPlayerCoinsGradual": Game.adjust_coins,
+    "ShowPlayerCoinChange": _nothing,
+    "GetAbsSpaceIndexFromChainSpaceIndex": lambda game: game.arg(1),   # No board loaded: the chain index is it
+    "InitFadeOut": _nothing,
+    "func_800F2304": _nothing,                                      # Play a character animation
+    "func_800F8C74": lambda game: game.wait(SCENE_RELOAD_FRAMES),  # Reload the current scene
+    "func_8004819C": _nothing,
+    "func_8004849C": _nothing,
+    "func_8004F010": _nothing,
+    "func_8004F074": _nothing,
+    "osGetCount": lambda game: (game.cpu.cycles // r4300.COP0_COUNT_DIVIDER) & r4300.MASK32,   # mp3lib profiling
+}
+
+
+def parse_pokes(values, parser):
+    pokes = []
+    for value in values:
+        address, _, byte = value.partition("=")
+        try:
+            pokes.append((int(address, 0), int(byte, 0)))
+        except ValueError:
+            parser.error("--set wants ADDRESS=BYTE, like 0x800CD0A7=0x10")
+    return pokes
+
+
+def run_event(data, args, inputs, trace=None, watch_buffers=False):
+    """Loads the object into a fresh console and runs it once; returns its RunResult."""
+    game = Game(inputs, args.player, args.cpu, trace, watch_buffers)
+    image = game.load(data)
+    for address, value in args.pokes:
+        game.memory.write_u8(address, value)
+    return game.run(image, args.entry, args.max_instructions)
+
+
+def print_result(result, out):
+    out.write("instructions   %d\n" % result.instructions)
+    out.write("cycles         %d (%.4f frames of CPU at %d cycles a frame)\n"
+              % (result.cycles, result.compute_frames(), CYCLES_PER_FRAME))
+    for name, cache in (("I-cache", result.icache), ("D-cache", result.dcache)):
+        out.write("%-14s %d hits, %d misses%s\n" % (name, cache.hits, cache.misses,
+                  ", %d writebacks" % cache.writebacks if cache.writebacks else ""))
+    out.write("waits          %d frames\n" % result.wait_frames)
+    out.write("heap           %d bytes at peak\n" % result.heap_peak)
+    out.write("path           %s\n" % result.path)
+    out.write("game calls     %s\n" % (", ".join("%s x%d" % item for item in sorted(result.calls.items())) or "none"))
+    if result.unknown:
+        out.write("not stubbed    %s (returned 0)\n" % ", ".join(sorted(result.unknown)))
+    if result.fault:
+        out.write("FAULT          %s\n" % result.fault)
+
+
+def cmd_run(args):
+    with open(args.object, "rb") as f:
+        data = f.read()
+    replay = None
+    if args.replay:
+        replay = InputTrace.load(args.replay)
+        if args.runs != 1:
+            raise ValueError("--replay runs the trace once; leave out --runs")
+        if args.player is None:
+            args.player = replay.player
+    if args.player is None:
+        args.player = 0
+    results = []
+    for run in range(args.runs):
+        trace = sys.stdout if args.trace else None
+        if trace and args.runs > 1:
+            trace.write("run %d (seed %d)\n" % (run + 1, args.seed + run))
+        inputs = ReplayInputs(replay) if replay else Inputs(args.seed + run, args.choice)
+        results.append(run_event(data, args, inputs, trace))
+
+    out = sys.stdout
+    out.write("%s: %s(), %s\n\n" % (args.object, args.entry,
+              "replaying %s (%s)" % (args.replay, replay.counts()) if replay else "%d run(s)" % args.runs))
+    if args.runs == 1:
+        print_result(results[0], out)
+        unused = inputs.unused() if replay else None
+        if unused:
+            out.write("not replayed   %s (this build asked for fewer answers than were recorded)\n" % unused)
+    else:
+        out.write("%6s %12s %12s %8s %8s  %s\n" % ("seed", "instructions", "cycles", "waits", "heap", "path"))
+        for run, result in enumerate(results):
+            out.write("%6d %12d %12d %8d %8d  %s%s\n" % (args.seed + run, result.instructions, result.cycles,
+                      result.wait_frames, result.heap_peak, result.path[:60],
+                      "  FAULT: " + result.fault if result.fault else ""))
+        cycles = [result.cycles for result in results]
+        out.write("\ncycles: min %d, mean %.0f, max %d\n" % (min(cycles), sum(cycles) / len(cycles), max(cycles)))
+    if args.record:
+        slowest = max(results, key=lambda result: (result.frames(), result.cycles))
+        slowest.inputs.save(args.record)
+        out.write("\nrecorded %s%s to %s\n" % (slowest.inputs.counts(),
+                  " from the slowest run (%s)" % slowest.path if args.runs > 1 else "", args.record))
+    return 1 if any(result.fault for result in results) else 0
+
+
+def spread_values(count):
+    """count random byte values spread evenly over 0-255, both ends included."""
+    if count <= 1:
+        return [0]
+    return [round(index * 255 / (count - 1)) for index in range(count)]
+
+
+def value_counts(text):
+    """--random-values: "4", or "256,4" for every value on the first draw and 4 on the rest."""
+    try:
+        counts = [int(count) for count in text.split(",")]
+    except ValueError:
+        counts = []
+    if not counts or min(counts) < 1 or max(counts) > 256:
+        raise argparse.ArgumentTypeError("wants counts from 1 to 256, like 4 or 256,4")
+    return counts
+
+
+def explore_paths(data, args, watch_buffers=False):
+    """Runs every path through the event; returns (RunResults, True if --max-paths cut it short).
+
+    Each run replays a prefix of decisions and takes the first option of
+    everything after it, then queues a prefix for every option it didn't
+    take, so each leaf runs exactly once.
+    """
+    values = [spread_values(count) for count in args.random_values]
+    results = []
+    pending = [[]]
+    while pending and len(results) < args.max_paths:
+        prefix = pending.pop()
+        inputs = PathInputs(prefix, values, args.random_draws, args.either_cpu)
+        results.append(run_event(data, args, inputs, watch_buffers=watch_buffers))
+        picks = [pick for _, pick, _ in inputs.decisions]
+        for index in range(len(inputs.decisions) - 1, len(prefix) - 1, -1):
+            count = inputs.decisions[index][2]
+            for pick in range(count - 1, 0, -1):
+                pending.append(picks[:index] + [pick])
+    return results, bool(pending)
+
+
+def cmd_paths(args):
+    status = 0
+    out = sys.stdout
+    for path in args.objects:
+        with open(path, "rb") as f:
+            data = f.read()
+        results, cut_short = explore_paths(data, args)
+        results.sort(key=lambda result: (-result.frames(), -result.cycles))
+        worst = results[0]
+        out.write("%s: %s(), %d path(s)%s\n\n" % (path, args.entry, len(results),
+                  ", STOPPED at --max-paths" if cut_short else ""))
+        out.write("%9s %8s %12s %10s %8s  %s\n" % ("frames", "waits", "instructions", "cycles", "heap", "path"))
+        for result in results[:args.top]:
+            out.write("%9.2f %8d %12d %10d %8d  %s%s%s\n" % (result.frames(), result.wait_frames, result.instructions,
+                      result.cycles, result.heap_peak, result.path,
+                      "  FAULT: " + result.fault if result.fault else "",
+                      "  <- worst case" if result is worst else ""))
+        if len(results) > args.top:
+            out.write("  ... %d more (--top shows more)\n" % (len(results) - args.top))
+        if args.record:
+            worst.inputs.save(args.record)
+            out.write("  recorded the worst path's inputs to %s\n" % args.record)
+        out.write("\nWorst case: %.1f frames (%.1f s), %d instructions, %d bytes of heap; "
+                  "most heap on any path %d bytes, most instructions %d\n"
+                  % (worst.frames(), worst.frames() / FRAMES_PER_SECOND, worst.instructions, worst.heap_peak,
+                     max(result.heap_peak for result in results), max(result.instructions for result in results)))
+        faults = [result for result in results if result.fault]
+        if faults:
+            out.write("%d path(s) FAULTED\n" % len(faults))
+            status = 1
+        if args.budget is not None and worst.frames() > args.budget:
+            out.write("OVER BUDGET: the worst path waits %.1f frames, budget is %.0f\n" % (worst.frames(), args.budget))
+            status = 1
+        out.write("\n")
+    return status
+
+
+def parse_characters(text):
+    """--characters: "0-8" or "6,8"."""
+    characters = []
+    try:
+        for part in text.split(","):
+            first, _, last = part.partition("-")
+            characters.extend(range(int(first), int(last or first) + 1))
+    except ValueError:
+        characters = []
+    if not characters or min(characters) < 0 or max(characters) > 255:
+        raise argparse.ArgumentTypeError("wants character numbers 0-255, like 0-8 or 6,8")
+    return characters
+
+
+def character_name(character):
+    return CHARACTER_NAMES[character] if character < len(CHARACTER_NAMES) else "character %d" % character
+
+
+def sweep_buffers(data, args):
+    """Runs every path with the buffer watch on, then again with every player as each of --characters
+    if the event looked at anyone's character; returns ([(characters label, RunResult)], cut short)."""
+    results, cut_short = explore_paths(data, args, watch_buffers=True)
+    label = "P1-P4 %s" % ", ".join(character_name(index) for index in range(4))
+    runs = [(label, result) for result in results]
+    if not any(result.reads_character for result in results):
+        return runs, cut_short
+    for character in args.characters:
+        sweep = copy.copy(args)
+        sweep.pokes = args.pokes + [(PLAYER_STRUCTS + index * PLAYER_STRUCT_SIZE + PLAYER_CHARACTER, character)
+                                    for index in range(4)]
+        results, more_cut_short = explore_paths(data, sweep, watch_buffers=True)
+        runs.extend(("everyone %s" % character_name(character), result) for result in results)
+        cut_short = cut_short or more_cut_short
+    return runs, cut_short
+
+
+def cmd_buffers(args):
+    status = 0
+    out = sys.stdout
+    for path in args.objects:
+        with open(path, "rb") as f:
+            data = f.read()
+        runs, cut_short = sweep_buffers(data, args)
+        sites = collections.OrderedDict()      # site -> [calls, smallest size, largest size, most used, worst, overflow, worst overflow]
+        for label, result in runs:
+            for allocation in result.allocations:
+                site = sites.setdefault(allocation.site, [0, allocation.size, allocation.size, 0, None, 0, None])
+                site[0] += 1
+                site[1] = min(site[1], allocation.size)
+                site[2] = max(site[2], allocation.size)
+                if allocation.used > site[3] or site[4] is None:
+                    site[3] = max(site[3], allocation.used)
+                    site[4] = "%s, %s" % (label, result.path)
+                if allocation.overflow() > site[5]:
+                    site[5] = allocation.overflow()
+                    site[6] = "%s, %s" % (label, result.path)
+
+        out.write("%s: %s(), %d run(s)%s\n\n" % (path, args.entry, len(runs),
+                  ", STOPPED at --max-paths" if cut_short else ""))
+        if not sites:
+            out.write("no mallocs\n\n")
+        else:
+            out.write("%-44s %6s %6s %6s %7s  %s\n" % ("malloc call site", "size", "calls", "needs", "suggest", "worst case"))
+        overflows = saved = 0
+        for name, (calls, smallest, largest, used, worst, overflow, worst_overflow) in sites.items():
+            size = "%d" % largest if smallest == largest else "%d-%d" % (smallest, largest)
+            suggest = (used + 7) & ~7
+            if overflow:
+                overflows += 1
+                note = "OVERFLOW by %d byte(s): %s" % (overflow, worst_overflow)
+            elif used == 0:
+                note = "never written: drop it"
+                saved += largest
+            else:
+                note = "%s, %s" % ("saves %d bytes" % (largest - suggest) if largest > suggest else "right-sized", worst)
+                saved += max(0, largest - suggest)
+            out.write("%-44s %6s %6d %6d %7s  %s\n" % (name[:44], size, calls, used, suggest if used else "-", note))
+        faults = sum(1 for _, result in runs if result.fault)
+        if faults:
+            out.write("\n%d run(s) FAULTED, first: %s\n" % (faults, next(result.fault for _, result in runs if result.fault)))
+            status = 1
+        if overflows:
+            out.write("\n%d call site(s) OVERFLOW their buffer\n" % overflows)
+            status = 1
+        elif sites:
+            out.write("\nNo overflows; right-sizing saves %d bytes of heap (one call of each site)\n" % saved)
+        out.write("\n")
+    return status
+
+
+def add_console_arguments(command):
+    command.add_argument("--entry", default="main", help="function to run (default main)")
+    command.add_argument("--player", type=int, help="current player index, 0-3 (default 0, or the --replay trace's)")
+    command.add_argument("--cpu", type=int, action="append", default=[], metavar="PLAYER",
+                         help="make a player a CPU (repeat for more)")
+    command.add_argument("--set", action="append", default=[], metavar="ADDRESS=BYTE",
+                         help="poke a byte of RDRAM first, like board RAM: 0x800CD0A7=0x10")
+    command.add_argument("--max-instructions", type=int, default=20000000)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    commands = parser.add_subparsers(dest="command")
+    command = commands.add_parser("run", help="run an event and count its instructions, cycles and waits")
+    command.add_argument("object", help="the event compiled to a big-endian MIPS .o")
+    add_console_arguments(command)
+    command.add_argument("--choice", type=int, action="append", default=[],
+                         help="a human player's answer to the next prompt (repeat in order; default 0)")
+    command.add_argument("--seed", type=int, default=1, help="seed for GetRandomByte (default 1)")
+    command.add_argument("--runs", type=int, default=1, help="run this many times, seed, seed+1, ...")
+    command.add_argument("--trace", action="store_true", help="print every game call as it happens")
+    command.add_argument("--record", metavar="FILE", help="save the run's inputs (the slowest run's, with --runs)")
+    command.add_argument("--replay", metavar="FILE", help="answer with a recorded input trace instead")
+
+    command = commands.add_parser("paths", help="run every prompt answer and RNG outcome, worst case first")
+    command.add_argument("objects", nargs="+", help="events compiled to big-endian MIPS .o files")
+    add_console_arguments(command)
+    command.add_argument("--random-values", type=value_counts, default=[4],
+                         help="values each random draw tries, spread over 0-255 (default 4; 256,4 tries all "
+                              "256 on the first draw)")
+    command.add_argument("--random-draws", type=int, default=6,
+                         help="draws that branch; later ones get 0 (default 6)")
+    command.add_argument("--either-cpu", action="store_true",
+                         help="try every player the event asks about as a human and as a CPU")
+    command.add_argument("--max-paths", type=int, default=5000, help="stop after this many paths (default 5000)")
+    command.add_argument("--top", type=int, default=20, help="paths to list (default 20)")
+    command.add_argument("--budget", type=float, help="fail if the worst path takes more frames than this")
+    command.add_argument("--record", metavar="FILE", help="save the worst path's inputs, for run --replay")
+
+    command = commands.add_parser("buffers", help="find how much of each malloc'd buffer the event really uses")
+    command.add_argument("objects", nargs="+", help="events compiled to big-endian MIPS .o files")
+    add_console_arguments(command)
+    command.add_argument("--random-values", type=value_counts, default=[256, 4],
+                         help="values each random draw tries (default 256,4: all 256 on the first, 4 on the rest)")
+    command.add_argument("--random-draws", type=int, default=3, help="draws that branch; later ones get 0 (default 3)")
+    command.add_argument("--either-cpu", action="store_true",
+                         help="try every player the event asks about as a human and as a CPU")
+    command.add_argument("--max-paths", type=int, default=20000,
+                         help="stop after this many paths per set of characters (default 20000)")
+    command.add_argument("--characters", type=parse_characters, default=list(range(len(CHARACTER_NAMES) + 1)),
+                         help="characters to make every player, if the event reads them (default 0-%d; %d is out "
+                              "of range, like a bad player index)" % (len(CHARACTER_NAMES), len(CHARACTER_NAMES)))
+    args = parser.parse_args(argv)
+    if args.command is None:
+        parser.error("pick a command: run, paths or buffers")
+    args.pokes = parse_pokes(args.set, parser)
+    if args.command != "run" and args.player is None:
+        args.player = 0
+
+    try:
+        return {"run": cmd_run, "paths": cmd_paths, "buffers": cmd_buffers}[args.command](args)
+    except (ValueError, OSError) as e:
+        sys.stderr.write("Event harness failed: %s\n" % e)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
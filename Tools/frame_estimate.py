@@ -0,0 +1,520 @@
+#!/usr/bin/env python3
+"""Static frame-cost estimator: how long can an event make a player wait?
+
+event_harness.py answers that by running the compiled event.  This answers
+it from the source, with nothing to compile: it reads each event's .c file,
+builds the call graph from main() down (main -> GraduallyAdjustPlayerCoins
+-> SleepProcess(30), mp3_ShowMessageWithConfirmation -> func_800EC9DC) and
+adds up, along every path through the ifs, loops and switches, the frames
+the event spends waiting:
+  - SleepProcess(N) waits N frames, when N is a number, a #define, or a
+    parameter a caller passed a number for,
+  - waiting for a message box to be confirmed (func_800EC9DC) costs
+    MESSAGE_FRAMES and a prompt (GetBasicPromptSelection) PROMPT_FRAMES,
+  - a scene reload (the func_800F8C74 in mp3_ReloadCurrentSceneWithTransition)
+    costs SCENE_RELOAD_FRAMES,
+which are the numbers event_density.py and event_harness.py use too.  The
+shortest and longest paths give each event's min and max; ShowMessage
+calls along the longest path are counted as its message boxes.
+
+It's an estimate, not a proof.  Conditions aren't evaluated, so both sides
+of every if count.  Loops run zero times on the shortest path and, unless a
+for loop has a constant bound, once on the longest (the notes say when a
+loop has waits in it).  Code running its own compute (string building,
+tables) is free here; use event_harness.py for that.
+
+With no paths it reads every .c file under Complete/MP3 that has a main()
+and prints one row per event, slowest first.
+
+Usage:
+    python3 Tools/frame_estimate.py
+    python3 Tools/frame_estimate.py Complete/MP3/TurnOrderSwap/TurnOrderTriggered.c --calls
+    python3 Tools/frame_estimate.py --budget 900
+"""
+
+import argparse
+import os
+import re
+import sys
+
+import boardlib
+
+DEFAULT_ROOT = os.path.join("Complete", "MP3")
+
+# MP3 runs the board at 30 frames a second.
+FRAMES_PER_SECOND = 30
+MESSAGE_FRAMES = 60                 # A message box someone reads and closes
+PROMPT_FRAMES = 90                  # A message box with choices
+SCENE_RELOAD_FRAMES = 60            # Fading out and reloading the board scene
+
+SLEEP_CALL = "SleepProcess"
+MESSAGE_CALL = "ShowMessage"
+# Game functions that wait: name -> (frames, what it counts as).
+WAIT_CALLS = {
+    "func_800EC9DC": (MESSAGE_FRAMES, None),            # Wait for the player to confirm a message
+    "GetBasicPromptSelection": (PROMPT_FRAMES, "prompts"),
+    "func_800F8C74": (SCENE_RELOAD_FRAMES, "reloads"),  # Reload the current scene
+}
+ASSUMED_LOOP_RUNS = 1
+C_KEYWORDS = {"if", "else", "while", "for", "do", "switch", "case", "default", "return", "break",
+              "continue", "sizeof", "goto"}
+
+_TOKEN_RE = re.compile(r"\s+|(?P<token>[A-Za-z_]\w*|0[xX][0-9A-Fa-f]+|\d+|\"(?:\\.|[^\"\\])*\"|'(?:\\.|[^'\\])*'|.)")
+_DEFINE_RE = re.compile(r"^\s*#\s*define\s+(\w+)\s+\(?\s*(-?(?:0[xX][0-9A-Fa-f]+|\d+))\s*\)?\s*$")
+
+
+class Cost:
+    """One path's worth of waiting."""
+
+    __slots__ = ("frames", "messages", "prompts", "sleeps", "reloads")
+
+    def __init__(self, frames=0, messages=0, prompts=0, sleeps=0, reloads=0):
+        self.frames = frames
+        self.messages = messages
+        self.prompts = prompts
+        self.sleeps = sleeps
+        self.reloads = reloads
+
+    def __add__(self, other):
+        return Cost(self.frames + other.frames, self.messages + other.messages, self.prompts + other.prompts,
+                    self.sleeps + other.sleeps, self.reloads + other.reloads)
+
+    def times(self, count):
+        return Cost(self.frames * count, self.messages * count, self.prompts * count,
+                    self.sleeps * count, self.reloads * count)
+
+
+ZERO = Cost()
+
+
+class Range:
+    """The shortest and the longest of a set of paths."""
+
+    def __init__(self, low, high=None):
+        self.low = low
+        self.high = low if high is None else high
+
+    def __add__(self, other):
+        return Range(self.low + other.low, self.high + other.high)
+
+    def union(self, other):
+        if other is None:
+            return self
+        return Range(min(self.low, other.low, key=lambda cost: cost.frames),
+                     max(self.high, other.high, key=lambda cost: cost.frames))
+
+
+def _union(a, b):
+    return b if a is None else a.union(b)
+
+
+def _then(a, b):
+    return None if a is None or b is None else a + b
+
+
+class Outcome:
+    """What running some code can do: fall through to the next statement, or return, each over a Range."""
+
+    def __init__(self, falls=None, returns=None):
+        self.falls = falls
+        self.returns = returns
+
+    def then(self, other):
+        return Outcome(_then(self.falls, other.falls), _union(self.returns, _then(self.falls, other.returns)))
+
+    def either(self, other):
+        return Outcome(_union(self.falls, other.falls), _union(self.returns, other.returns))
+
+    def total(self):
+        return _union(self.falls, self.returns) or Range(ZERO)
+
+
+NOTHING = Outcome(Range(ZERO))
+
+
+def tokenize(source):
+    """Returns (tokens, defines): C tokens without comments or preprocessor lines, and the #define NAME number values."""
+    source = re.sub(r"/\*.*?\*/", " ", source, flags=re.S)
+    source = re.sub(r"//[^\n]*", " ", source)
+    defines = {}
+    lines = []
+    for line in source.splitlines():
+        if line.lstrip().startswith("#"):
+            match = _DEFINE_RE.match(line)
+            if match:
+                defines[match.group(1)] = int(match.group(2), 0)
+            continue
+        lines.append(line)
+    tokens = [match.group("token") for match in _TOKEN_RE.finditer("\n".join(lines)) if match.group("token")]
+    return tokens, defines
+
+
+def match_bracket(tokens, start, opening, closing):
+    """Index of the bracket closing the one at start."""
+    depth = 0
+    for index in range(start, len(tokens)):
+        if tokens[index] == opening:
+            depth += 1
+        elif tokens[index] == closing:
+            depth -= 1
+            if depth == 0:
+                return index
+    return len(tokens) - 1
+
+
+def find_functions(tokens):
+    """Returns {name: (parameter names, body tokens)} for the functions defined at file scope."""
+    functions = {}
+    index = 0
+    while index < len(tokens):
+        if tokens[index] == "{":
+            end = match_bracket(tokens, index, "{", "}")
+            if index > 0 and tokens[index - 1] == ")":
+                depth, open_at = 0, index - 1
+                while open_at > 0:
+                    depth += {")": 1, "(": -1}.get(tokens[open_at], 0)
+                    if depth == 0:
+                        break
+                    open_at -= 1
+                name = tokens[open_at - 1]
+                if re.match(r"[A-Za-z_]\w*$", name) and name not in C_KEYWORDS:
+                    parameters = []
+                    for piece in " ".join(tokens[open_at + 1:index - 1]).split(","):
+                        words = re.findall(r"[A-Za-z_]\w*", piece)
+                        if words and words[-1] != "void":
+                            parameters.append(words[-1])
+                    functions[name] = (parameters, tokens[index + 1:end])
+            index = end + 1
+        else:
+            index += 1
+    return functions
+
+
+class Estimator:
+    """Walks one source file's functions, costing each call with its constant arguments."""
+
+    def __init__(self, functions, defines):
+        self.functions = functions
+        self.defines = defines
+        self.cache = {}
+        self.active = set()
+        self.notes = set()
+        self.calls = {}                 # function -> names of the functions it calls, in order
+        self.caller = None
+        self.bindings = {}
+
+    def function(self, name, arguments=()):
+        """Range of the frames a call to a function in this file waits."""
+        parameters, body = self.functions[name]
+        bindings = dict((parameter, value) for parameter, value in zip(parameters, arguments) if value is not None)
+        key = (name, tuple(sorted(bindings.items())))
+        if key in self.cache:
+            return self.cache[key]
+        if name in self.active:
+            self.notes.add("%s() is recursive, counted once" % name)
+            return Range(ZERO)
+        self.active.add(name)
+        self.calls.setdefault(name, [])
+        saved_caller, saved_bindings = self.caller, self.bindings
+        self.caller, self.bindings = name, bindings
+        outcome, _ = self.block(body, 0, len(body))
+        self.bindings, self.caller = saved_bindings, saved_caller
+        self.active.discard(name)
+        self.cache[key] = outcome.total()
+        return self.cache[key]
+
+    def constant(self, tokens):
+        """The value of a one-token argument that's a number, a #define or a bound parameter, else None."""
+        if len(tokens) == 2 and tokens[0] == "-":
+            value = self.constant(tokens[1:])
+            return None if value is None else -value
+        if len(tokens) != 1:
+            return None
+        token = tokens[0]
+        if re.match(r"0[xX][0-9A-Fa-f]+$|\d+$", token):
+            return int(token, 0)
+        if token in self.defines:
+            return self.defines[token]
+        return self.bindings.get(token)
+
+    def arguments(self, tokens, open_at):
+        """The argument token lists of the call whose "(" is at open_at, and the index of its ")"."""
+        close = match_bracket(tokens, open_at, "(", ")")
+        arguments, current, depth = [], [], 0
+        for token in tokens[open_at + 1:close]:
+            if token in "([{":
+                depth += 1
+            elif token in ")]}":
+                depth -= 1
+            if token == "," and depth == 0:
+                arguments.append(current)
+                current = []
+            else:
+                current.append(token)
+        if current:
+            arguments.append(current)
+        return arguments, close
+
+    def expression(self, tokens, start, end):
+        """Range of the waits in the calls in tokens[start:end], which all run."""
+        total = Range(ZERO)
+        for index in range(start, end - 1):
+            name = tokens[index]
+            if tokens[index + 1] != "(" or name in C_KEYWORDS or not re.match(r"[A-Za-z_]\w*$", name):
+                continue
+            arguments, _ = self.arguments(tokens, index + 1)
+            if self.caller is not None and name not in self.calls[self.caller]:
+                self.calls[self.caller].append(name)
+            if name == SLEEP_CALL:
+                frames = self.constant(arguments[0]) if arguments else None
+                if frames is None:
+                    self.notes.add("SleepProcess(%s) isn't a constant, counted as 0" % " ".join(arguments[0])
+                                   if arguments else "SleepProcess() with no argument")
+                    frames = 0
+                total = total + Range(Cost(frames=frames, sleeps=frames))
+            elif name == MESSAGE_CALL:
+                total = total + Range(Cost(messages=1))
+            elif name in WAIT_CALLS:
+                frames, counter = WAIT_CALLS[name]
+                cost = Cost(frames=frames)
+                if counter:
+                    setattr(cost, counter, 1)
+                total = total + Range(cost)
+            elif name in self.functions:
+                total = total + self.function(name, [self.constant(argument) for argument in arguments])
+        return total
+
+    def block(self, tokens, start, end):
+        """Outcome of the statements in tokens[start:end]."""
+        outcome = NOTHING
+        index = start
+        while index < end:
+            statement, index = self.statement(tokens, index, end)
+            outcome = outcome.then(statement)
+            if outcome.falls is None:
+                break
+        return outcome, index
+
+    def statement(self, tokens, index, end):
+        """Outcome of the statement at tokens[index], and the index after it."""
+        token = tokens[index]
+        if token == "{":
+            close = match_bracket(tokens, index, "{", "}")
+            return self.block(tokens, index + 1, close)[0], close + 1
+        if token == ";":
+            return NOTHING, index + 1
+        if token in ("case", "default"):
+            while index < end and tokens[index] != ":":
+                index += 1
+            return NOTHING, index + 1
+        if token in ("break", "continue"):
+            return NOTHING, index + 2
+        if token == "return":
+            stop = self._statement_end(tokens, index, end)
+            return Outcome(None, self.expression(tokens, index + 1, stop)), stop + 1
+        if token == "if":
+            close = match_bracket(tokens, index + 1, "(", ")")
+            condition = Outcome(self.expression(tokens, index + 2, close))
+            then, after = self.statement(tokens, close + 1, end)
+            otherwise = NOTHING
+            if after < end and tokens[after] == "else":
+                otherwise, after = self.statement(tokens, after + 1, end)
+            return condition.then(then.either(otherwise)), after
+        if token in ("while", "for"):
+            close = match_bracket(tokens, index + 1, "(", ")")
+            header = Outcome(self.expression(tokens, index + 2, close))
+            body, after = self.statement(tokens, close + 1, end)
+            runs = self._loop_runs(tokens[index + 2:close]) if token == "for" else None
+            return header.then(self._loop(body, runs, 0)), after
+        if token == "do":
+            body, after = self.statement(tokens, index + 1, end)
+            close = match_bracket(tokens, after + 1, "(", ")")
+            condition = Outcome(self.expression(tokens, after + 2, close))
+            return self._loop(body, None, 1).then(condition), close + 2
+        if token == "switch":
+            close = match_bracket(tokens, index + 1, "(", ")")
+            subject = Outcome(self.expression(tokens, index + 2, close))
+            body_end = match_bracket(tokens, close + 1, "{", "}")
+            return subject.then(self._switch(tokens, close + 2, body_end)), body_end + 1
+        stop = self._statement_end(tokens, index, end)
+        return Outcome(self.expression(tokens, index, stop)), stop + 1
+
+    def _statement_end(self, tokens, index, end):
+        depth = 0
+        while index < end:
+            if tokens[index] in "([{":
+                depth += 1
+            elif tokens[index] in ")]}":
+                depth -= 1
+            elif tokens[index] == ";" and depth == 0:
+                return index
+            index += 1
+        return end
+
+    def _loop_runs(self, header):
+        """The iteration count of `for (i = A; i < B; i++)` with constant A and B, else None."""
+        text = " ".join(header)
+        match = re.match(r"(?:\w+ )?(\w+) = (-?\s?\w+) ; (\w+) (<|<=) (\w+) ;", text)
+        if not match or match.group(1) != match.group(3):
+            return None
+        first = self.constant(match.group(2).split())
+        last = self.constant([match.group(5)])
+        if first is None or last is None:
+            return None
+        return max(0, last - first + (1 if match.group(4) == "<=" else 0))
+
+    def _loop(self, body, runs, minimum_runs):
+        falls = body.falls or Range(ZERO)
+        if runs is None:
+            if falls.high.frames:
+                self.notes.add("a loop with waits in it is counted %s" % ("once" if ASSUMED_LOOP_RUNS == 1
+                               else "%d times" % ASSUMED_LOOP_RUNS))
+            runs = ASSUMED_LOOP_RUNS
+        low = falls.low.times(minimum_runs) if minimum_runs else ZERO
+        return Outcome(Range(low, falls.high.times(max(runs, minimum_runs))), body.returns)
+
+    def _switch(self, tokens, start, end):
+        """Each case runs from its label to the next break at the switch's own level."""
+        labels, breaks, index = [], [], start
+        while index < end:
+            token = tokens[index]
+            if token in ("case", "default"):
+                labels.append(index)
+                if token == "default":
+                    labels.append(None)     # Marks that there's a default
+            elif token == "break":
+                breaks.append(index)
+            if token in ("{", "(", "["):
+                index = match_bracket(tokens, index, token, {"{": "}", "(": ")", "[": "]"}[token])
+            index += 1
+        has_default = None in labels
+        outcome = None if has_default else NOTHING
+        for label in (label for label in labels if label is not None):
+            stop = next((at for at in breaks if at > label), end)
+            case, _ = self.block(tokens, label, stop)
+            outcome = case if outcome is None else outcome.either(case)
+        return outcome or NOTHING
+
+
+class EventEstimate:
+    def __init__(self, path, low, high, notes, estimator):
+        self.path = path
+        self.low = low
+        self.high = high
+        self.notes = notes
+        self.estimator = estimator
+
+
+def estimate_source(path, entry="main"):
+    """Returns an EventEstimate for the event in path, or None if it has no entry function."""
+    return estimate_code(boardlib.read_text(path), path, entry)
+
+
+def estimate_code(code, path=None, entry="main"):
+    """estimate_source for C code you already have, like an event's code from a board file."""
+    tokens, defines = tokenize(code)
+    functions = find_functions(tokens)
+    if entry not in functions:
+        return None
+    estimator = Estimator(functions, defines)
+    total = estimator.function(entry)
+    return EventEstimate(path, total.low, total.high, sorted(estimator.notes), estimator)
+
+
+def find_sources(root):
+    sources = []
+    for folder, _, files in os.walk(root):
+        if boardlib.is_deployed_copy(os.path.join(folder, "")):
+            continue    # A board's pinned copies, not event sources
+        for file_name in files:
+            if file_name.endswith(".c"):
+                sources.append(os.path.join(folder, file_name))
+    return sorted(sources)
+
+
+def print_calls(estimate, out):
+    """The call graph from main() down to the waits, with each function's range (for the arguments it was first
+    costed with).  Functions that never wait are left out."""
+    estimator = estimate.estimator
+    ranges = {}
+    for (name, _), cost in estimator.cache.items():
+        ranges.setdefault(name, cost)
+    seen = set()
+
+    def walk(name, depth):
+        cost = ranges.get(name)
+        label = "%s()" % name
+        if cost is not None:
+            if not cost.high.frames and not cost.high.messages:
+                return
+            label += "  %d-%d frames" % (cost.low.frames, cost.high.frames)
+        elif name in WAIT_CALLS or name in (SLEEP_CALL, MESSAGE_CALL):
+            label += "  (waits)" if name != MESSAGE_CALL else "  (message box)"
+        else:
+            return
+        out.write("    %s%s%s\n" % ("  " * depth, label, "  ..." if name in seen and name in estimator.calls else ""))
+        if name in seen:
+            return
+        seen.add(name)
+        for callee in estimator.calls.get(name, []):
+            walk(callee, depth + 1)
+
+    walk("main", 0)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("paths", nargs="*", help="event .c files or folders (default %s)" % DEFAULT_ROOT)
+    parser.add_argument("--calls", action="store_true", help="print each event's call graph with its frames")
+    parser.add_argument("--budget", type=float,
+                        help="mark events whose longest path waits more frames than this, and exit 1 if any do")
+    args = parser.parse_args(argv)
+
+    sources = []
+    for path in args.paths or [os.path.join(boardlib.REPO_ROOT, DEFAULT_ROOT)]:
+        sources.extend(find_sources(path) if os.path.isdir(path) else [path])
+    estimates = []
+    errors = []
+    for path in sources:
+        try:
+            estimate = estimate_source(path)
+        except OSError as e:
+            errors.append("%s: %s" % (path, e))
+            continue
+        if estimate is not None:
+            estimates.append(estimate)
+
+    out = sys.stdout
+    root = os.path.join(boardlib.REPO_ROOT, DEFAULT_ROOT)
+    out.write("Frames an event waits, shortest and longest path.  Longest path: message boxes, prompts,\n"
+              "SleepProcess frames and scene reloads.\n\n")
+    out.write("%-52s %6s %6s %5s %5s %6s %5s  %s\n" % ("event", "min", "max", "msgs", "asks", "sleep", "loads", "notes"))
+    over = 0
+    for estimate in sorted(estimates, key=lambda estimate: -estimate.high.frames):
+        high = estimate.high
+        slow = args.budget is not None and high.frames > args.budget
+        over += slow
+        shown = os.path.relpath(estimate.path, root)
+        if shown.startswith(".."):
+            shown = os.path.relpath(estimate.path, boardlib.REPO_ROOT)
+        if shown.startswith(".."):
+            shown = estimate.path
+        out.write("%-52s %6d %6d %5d %5d %6d %5d  %s\n" % (shown, estimate.low.frames, high.frames,
+                  high.messages, high.prompts, high.sleeps, high.reloads,
+                  "; ".join((["SLOW"] if slow else []) + estimate.notes)))
+        if args.calls:
+            print_calls(estimate, out)
+
+    if errors:
+        sys.stderr.write("\nFrame estimate failed:\n")
+        for error in errors:
+            sys.stderr.write("  " + error + "\n")
+        return 1
+    if over:
+        out.write("\n%d event(s) can wait longer than %.0f frames (%.1f s)\n" % (over, args.budget, args.budget / FRAMES_PER_SECOND))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Simulates Reduce Hidden Blocks By Percent over many games.
+
+Compares the event's two modes for one hidden block type:
+
+  * coin flip - every dice roll hides the blocks HIDDEN_BLOCK_REDUCTION_PERCENT
+    of the time (mp3_ReturnTruePercentOfTime, including its 0-98 roll).
+  * schedule  - USE_TURN_SCHEDULE: the first roll deals out a 32-bit schedule of
+    allowed turns, built the same way as BuildHiddenBlockSchedule().
+
+A roll on an allowed turn finds the block with --find-chance (the game moves the
+block somewhere else once it's found, so it can be found again).  The default
+of 0.021 per roll is roughly 3 blocks in a 35 turn game with 4 players when
+every roll is allowed (--percent 0).  At --percent 66 only a third of the rolls
+are, so both modes find about 1 block a game.
+
+For each mode it prints the mean and standard deviation of the rolls blocks
+were allowed on and of the blocks found per game, plus a histogram of blocks
+found.  The schedule takes away the spread in allowed rolls; what's left in
+the blocks found is the luck of landing on the block.
+
+Usage:
+    python3 Tools/hidden_block_sim.py --turns 35 --percent 66
+"""
+
+import argparse
+import random
+import statistics
+import sys
+
+SCHEDULE_BITS = 32
+
+
+def pick_0_to_n(rng, n):
+    """mp3_PickARandomNumberBetween0AndN: rejection sampling on a random byte."""
+    rand_limit = 255 - ((255 % n) + 1)
+    result = rng.randrange(256)
+    while result > rand_limit:
+        result = rng.randrange(256)
+    return result % n
+
+
+def return_true_percent_of_time(rng, percent):
+    if percent <= 0:
+        return False
+    if percent >= 100:
+        return True
+    return pick_0_to_n(rng, 99) < percent
+
+
+def turns_per_schedule_bit(total_turns):
+    return (total_turns + SCHEDULE_BITS - 1) // SCHEDULE_BITS
+
+
+def build_schedule(rng, total_turns, percent):
+    """Mirrors BuildHiddenBlockSchedule() in ReduceHiddenBlocksByPercent.c."""
+    turns_per_bit = turns_per_schedule_bit(total_turns)
+    schedule_bits = (total_turns + turns_per_bit - 1) // turns_per_bit
+    allowed_percent = 100 - max(0, min(percent, 100))
+    allowed_bits = (schedule_bits * allowed_percent + 50) // 100
+
+    schedule = 0
+    for window in range(allowed_bits):
+        start = window * schedule_bits // allowed_bits
+        end = (window + 1) * schedule_bits // allowed_bits
+        schedule |= 1 << (start + pick_0_to_n(rng, end - start))
+    return schedule
+
+
+def play_game(rng, mode, args):
+    """Returns (rolls with blocks allowed, blocks found) for one game."""
+    schedule = 0
+    allowed_rolls = 0
+    found = 0
+    for turn in range(1, args.turns + 1):
+        for _ in range(args.players):
+            if mode == "schedule":
+                if schedule == 0:
+                    schedule = build_schedule(rng, args.turns, args.percent)
+                allowed = (schedule >> ((turn - 1) // turns_per_schedule_bit(args.turns))) & 1
+            else:
+                allowed = not return_true_percent_of_time(rng, args.percent)
+            if allowed:
+                allowed_rolls += 1
+                if rng.random() < args.find_chance:
+                    found += 1
+    return allowed_rolls, found
+
+
+def summarize(name, results, out):
+    allowed = [a for a, _ in results]
+    found = [f for _, f in results]
+    out.write("%s\n" % name)
+    out.write("  rolls allowed:  mean %6.2f  stdev %5.2f\n"
+              % (statistics.mean(allowed), statistics.pstdev(allowed)))
+    out.write("  blocks found:   mean %6.2f  stdev %5.2f\n"
+              % (statistics.mean(found), statistics.pstdev(found)))
+    for count in range(max(found) + 1):
+        share = found.count(count) / len(found)
+        out.write("    %2d blocks  %5.1f%%  %s\n" % (count, share * 100, "#" * int(round(share * 50))))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--turns", type=int, default=35, help="turns in the game (default 35)")
+    parser.add_argument("--percent", type=int, default=66, help="HIDDEN_BLOCK_REDUCTION_PERCENT (default 66)")
+    parser.add_argument("--players", type=int, default=4)
+    parser.add_argument("--find-chance", type=float, default=0.021,
+                        help="chance a roll finds the block when it's allowed (default 0.021)")
+    parser.add_argument("--games", type=int, default=20000)
+    parser.add_argument("--seed", type=int, default=64, help="random seed, for repeatable runs")
+    args = parser.parse_args(argv)
+
+    rng = random.Random(args.seed)
+    sys.stdout.write("%d games of %d turns, HIDDEN_BLOCK_REDUCTION_PERCENT %d, target %.1f allowed rolls\n\n"
+                     % (args.games, args.turns, args.percent,
+                        args.turns * args.players * (100 - args.percent) / 100))
+    for mode, name in (("coin", "Coin flip every roll"), ("schedule", "USE_TURN_SCHEDULE")):
+        results = [play_game(rng, mode, args) for _ in range(args.games)]
+        summarize(name, results, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
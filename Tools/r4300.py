@@ -0,0 +1,1084 @@
+"""MIPS III interpreter for the N64's VR4300, with a cycle and cache model.
+
+event_harness.py runs compiled events with this.  It's an interpreter, not an
+emulator: there's no TLB, no exceptions or interrupts, no RSP or RDP, and
+coprocessor 0 only answers Count.  What it does model is what an event's own
+code costs the CPU:
+  - the MIPS III integer instructions, 64-bit ones included, with branch delay
+    slots and branch-likely nullification, plus the usual COP1 float ones,
+  - a cycle count: one per instruction, plus the VR4300's multiply, divide
+    and float latencies, a cycle whenever an instruction uses the register the
+    load just before it loaded, and cache misses,
+  - the caches R4300.h (vs-highlighting/ultra-64/PR) describes: a 16 KB
+    instruction cache with 32-byte lines and an 8 KB write-back data cache
+    with 16-byte lines, both direct mapped.  KSEG1 accesses skip the caches and
+    pay UNCACHED_CYCLES every time.
+
+The cycle counts are approximate (the VR4300 also stalls on things like the
+write buffer and RDRAM refresh), but they move the way the console's do:
+fewer instructions, fewer multiplies and tighter loops all show up.
+
+Memory is the 8 MB of RDRAM (with the Expansion Pak), seen through KSEG0 at
+0x80000000 and KSEG1 at 0xA0000000.  Addresses in Cpu.traps run a Python
+function instead of code; that's how the harness stands in for the game.
+
+link_object() loads a big-endian relocatable object (.o) the way
+PartyPlanner64 loads an event: every section at one base address, relocations
+applied, and undefined symbols handed to a resolver.  Build objects for o32
+without PIC or the small-data section, e.g.
+
+    mips64-elf-gcc -march=vr4300 -mabi=32 -mno-abicalls -fno-pic -G0 -O2 -c event.c
+"""
+
+import struct
+
+K0BASE = 0x80000000
+K1BASE = 0xA0000000
+K2BASE = 0xC0000000
+RDRAM_SIZE = 0x800000                   # 8 MB, with the Expansion Pak
+
+# From R4300.h.
+ICACHE_SIZE = 0x4000                    # 16K
+ICACHE_LINESIZE = 32                    # 8 words
+DCACHE_SIZE = 0x2000                    # 8K
+DCACHE_LINESIZE = 16                    # 4 words
+
+# Cycle model, in CPU cycles at 93.75 MHz.
+ICACHE_MISS_CYCLES = 40                 # Refill an 8-word line from RDRAM
+DCACHE_MISS_CYCLES = 32                 # Refill a 4-word line from RDRAM
+DCACHE_WRITEBACK_CYCLES = 32            # Write a dirty line back before refilling it
+UNCACHED_CYCLES = 30                    # Any KSEG1 load or store
+LOAD_USE_CYCLES = 1                     # The next instruction uses what a load loaded
+BRANCH_LIKELY_SKIP_CYCLES = 1           # A nullified delay slot still takes its cycle
+COP0_COUNT_DIVIDER = 2                  # Count goes up once every two CPU cycles
+
+# Extra cycles beyond the first, from the VR4300 manual's latency tables.
+MULT_CYCLES = 4
+DMULT_CYCLES = 7
+DIV_CYCLES = 36
+DDIV_CYCLES = 68
+FLOAT_CYCLES = {
+    "add": (2, 2), "sub": (2, 2), "mul": (4, 7), "div": (28, 57), "sqrt": (28, 57),
+    "abs": (0, 0), "mov": (0, 0), "neg": (0, 0), "cvt": (4, 4), "c": (0, 0),
+}
+
+MASK32 = 0xFFFFFFFF
+MASK64 = 0xFFFFFFFFFFFFFFFF
+
+REGISTER_NAMES = ("zero", "at", "v0", "v1", "a0", "a1", "a2", "a3",
+                  "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+                  "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+                  "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra")
+A0, V0, SP, RA = 4, 2, 29, 31
+
+
+class Fault(Exception):
+    """The event did something the console would crash or hang on (or this interpreter can't run)."""
+
+    def __init__(self, message, pc=None):
+        Exception.__init__(self, message if pc is None else "%s (pc %08X)" % (message, pc))
+        self.pc = pc
+
+
+def sext32(value):
+    """The low 32 bits of value, sign-extended to a 64-bit register value."""
+    value &= MASK32
+    return value | 0xFFFFFFFF00000000 if value & 0x80000000 else value
+
+
+def signed32(value):
+    value &= MASK32
+    return value - 0x100000000 if value & 0x80000000 else value
+
+
+def signed64(value):
+    return value - 0x10000000000000000 if value & 0x8000000000000000 else value
+
+
+def sext16(value):
+    value &= 0xFFFF
+    return value - 0x10000 if value & 0x8000 else value
+
+
+def _divide(a, b):
+    """C-style (truncating) quotient and remainder."""
+    quotient = abs(a) // abs(b)
+    if (a < 0) != (b < 0):
+        quotient = -quotient
+    return quotient, a - quotient * b
+
+
+def _float32(value):
+    try:
+        return struct.unpack(">f", struct.pack(">f", value))[0]
+    except OverflowError:
+        return float("inf") if value > 0 else float("-inf")
+
+
+class Cache:
+    """A direct-mapped cache: just the tags, for counting hits and misses."""
+
+    def __init__(self, size, line_size, miss_cycles, writeback_cycles=0):
+        self.line_shift = line_size.bit_length() - 1
+        self.line_count = size // line_size
+        self.miss_cycles = miss_cycles
+        self.writeback_cycles = writeback_cycles
+        self.tags = [-1] * self.line_count
+        self.dirty = [False] * self.line_count
+        self.hits = self.misses = self.writebacks = 0
+
+    def access(self, physical, store=False):
+        """Returns the cycles the access stalls for: 0 on a hit."""
+        line = physical >> self.line_shift
+        index = line % self.line_count
+        if self.tags[index] == line:
+            self.hits += 1
+            if store:
+                self.dirty[index] = True
+            return 0
+        self.misses += 1
+        cycles = self.miss_cycles
+        if self.dirty[index]:
+            self.writebacks += 1
+            cycles += self.writeback_cycles
+        self.tags[index] = line
+        self.dirty[index] = store
+        return cycles
+
+
+class Memory:
+    """RDRAM, addressed through KSEG0 and KSEG1."""
+
+    def __init__(self, size=RDRAM_SIZE):
+        self.rdram = bytearray(size)
+        self.size = size
+
+    def physical(self, address, size=1):
+        address &= MASK32
+        if not K0BASE <= address < K2BASE:
+            raise Fault("address %08X isn't in KSEG0 or KSEG1" % address)
+        physical = address & 0x1FFFFFFF
+        if physical + size > self.size:
+            raise Fault("address %08X is past the end of RDRAM" % address)
+        return physical
+
+    def read(self, address, size):
+        physical = self.physical(address, size)
+        return bytes(self.rdram[physical:physical + size])
+
+    def write(self, address, data):
+        physical = self.physical(address, len(data))
+        self.rdram[physical:physical + len(data)] = data
+
+    def read_u8(self, address):
+        return self.rdram[self.physical(address)]
+
+    def read_u16(self, address):
+        return int.from_bytes(self.read(address, 2), "big")
+
+    def read_u32(self, address):
+        return int.from_bytes(self.read(address, 4), "big")
+
+    def write_u8(self, address, value):
+        self.rdram[self.physical(address)] = value & 0xFF
+
+    def write_u16(self, address, value):
+        self.write(address, (value & 0xFFFF).to_bytes(2, "big"))
+
+    def write_u32(self, address, value):
+        self.write(address, (value & MASK32).to_bytes(4, "big"))
+
+    def read_cstring(self, address, limit=4096):
+        """The bytes at address up to (not including) the first 0, at most limit of them."""
+        physical = self.physical(address)
+        end = self.rdram.find(b"\0", physical, min(self.size, physical + limit))
+        return bytes(self.rdram[physical:end if end >= 0 else min(self.size, physical + limit)])
+
+
+class Cpu:
+    """The VR4300 running code out of a Memory, counting instructions and cycles.
+
+    Registers hold 64-bit values as unsigned ints; 32-bit results are
+    sign-extended into them the way the hardware does it.
+    """
+
+    def __init__(self, memory):
+        self.memory = memory
+        self.rdram = memory.rdram
+        self.gpr = [0] * 32
+        self.hi = self.lo = 0
+        self.fpr = [0] * 32                 # 32-bit halves; doubles use even/odd pairs (Status.FR off)
+        self.fcr31 = 0
+        self.pc = self.npc = 0
+        self.current_pc = 0                 # The instruction running now (self.pc is the next one)
+        self.traps = {}                     # address -> function(cpu), run instead of code at that address
+        self.icache = Cache(ICACHE_SIZE, ICACHE_LINESIZE, ICACHE_MISS_CYCLES)
+        self.dcache = Cache(DCACHE_SIZE, DCACHE_LINESIZE, DCACHE_MISS_CYCLES, DCACHE_WRITEBACK_CYCLES)
+        self.instructions = 0
+        self.cycles = 0
+        self.uncached_accesses = 0
+        self.watch = None                   # function(address, size, store) called on every load and store
+        self._load_mask = 0                 # Bit for the register the last instruction loaded
+        self._decoded = {}
+        self._build_tables()
+
+    # Running
+
+    def call(self, address, args=(), return_address=0x80000000, max_instructions=50000000):
+        """Runs the function at address until it returns to return_address; returns v0.
+
+        return_address must be somewhere the code never runs (the default,
+        the exception vectors, is fine).  Up to four args go in a0-a3; the
+        caller sets up sp.
+        """
+        for index, value in enumerate(args[:4]):
+            self.gpr[A0 + index] = sext32(value)
+        self.gpr[RA] = sext32(return_address)
+        self.pc = address & MASK32
+        self.npc = self.pc + 4
+        self.run(return_address, max_instructions)
+        return self.gpr[V0]
+
+    def run(self, stop_address, max_instructions):
+        gpr = self.gpr
+        rdram = self.rdram
+        decoded = self._decoded
+        traps = self.traps
+        icache = self.icache
+        last_line = None
+        limit = self.instructions + max_instructions
+        while True:
+            pc = self.pc
+            if pc == stop_address:
+                return
+            trap = traps.get(pc)
+            if trap is not None:
+                trap(self)
+                self.pc = gpr[RA] & MASK32
+                self.npc = self.pc + 4
+                last_line = None
+                continue
+
+            entry = decoded.get(pc)
+            if entry is None:
+                if pc & 3 or not K0BASE <= pc < K2BASE or (pc & 0x1FFFFFFF) + 4 > self.memory.size:
+                    raise Fault("jumped to a bad address", pc)
+                physical = pc & 0x1FFFFFFF
+                word = int.from_bytes(rdram[physical:physical + 4], "big")
+                entry = decoded[pc] = self._decode(word, pc)
+            handler, word, reads = entry
+
+            if pc < K1BASE:
+                line = pc >> 5
+                if line != last_line:
+                    self.cycles += icache.access(pc & 0x1FFFFFFF)
+                    last_line = line
+                else:
+                    icache.hits += 1
+            else:
+                self.cycles += UNCACHED_CYCLES
+                self.uncached_accesses += 1
+                last_line = None
+
+            if self._load_mask & reads:
+                self.cycles += LOAD_USE_CYCLES
+            self._load_mask = 0
+            self.current_pc = pc
+            self.pc = self.npc
+            self.npc = self.pc + 4
+            self.instructions += 1
+            self.cycles += 1
+            handler(word)
+            gpr[0] = 0
+            if self.instructions >= limit:
+                raise Fault("gave up after %d instructions (infinite loop?)" % max_instructions, pc)
+
+    def invalidate(self, address, size):
+        """Forgets decoded instructions in a range (call this after writing code into memory)."""
+        for pc in [pc for pc in self._decoded if address <= pc < address + size]:
+            del self._decoded[pc]
+
+    # Decoding
+
+    def _build_tables(self):
+        self._opcodes = {
+            0x02: self._j, 0x03: self._jal, 0x04: self._beq, 0x05: self._bne, 0x06: self._blez, 0x07: self._bgtz,
+            0x08: self._addi, 0x09: self._addiu, 0x0A: self._slti, 0x0B: self._sltiu,
+            0x0C: self._andi, 0x0D: self._ori, 0x0E: self._xori, 0x0F: self._lui,
+            0x10: self._cop0, 0x11: self._cop1,
+            0x14: self._beql, 0x15: self._bnel, 0x16: self._blezl, 0x17: self._bgtzl,
+            0x18: self._daddi, 0x19: self._daddiu, 0x1A: self._ldl, 0x1B: self._ldr,
+            0x20: self._lb, 0x21: self._lh, 0x22: self._lwl, 0x23: self._lw, 0x24: self._lbu, 0x25: self._lhu,
+            0x26: self._lwr, 0x27: self._lwu, 0x28: self._sb, 0x29: self._sh, 0x2A: self._swl, 0x2B: self._sw,
+            0x2C: self._sdl, 0x2D: self._sdr, 0x2E: self._swr, 0x2F: self._nop, 0x30: self._lw,
+            0x31: self._lwc1, 0x35: self._ldc1, 0x37: self._ld, 0x38: self._sc, 0x39: self._swc1,
+            0x3D: self._sdc1, 0x3F: self._sd,
+        }
+        self._special = {
+            0x00: self._sll, 0x02: self._srl, 0x03: self._sra, 0x04: self._sllv, 0x06: self._srlv, 0x07: self._srav,
+            0x08: self._jr, 0x09: self._jalr, 0x0C: self._syscall, 0x0D: self._syscall, 0x0F: self._nop,
+            0x10: self._mfhi, 0x11: self._mthi, 0x12: self._mflo, 0x13: self._mtlo,
+            0x14: self._dsllv, 0x16: self._dsrlv, 0x17: self._dsrav,
+            0x18: self._mult, 0x19: self._multu, 0x1A: self._div, 0x1B: self._divu,
+            0x1C: self._dmult, 0x1D: self._dmultu, 0x1E: self._ddiv, 0x1F: self._ddivu,
+            0x20: self._add, 0x21: self._addu, 0x22: self._sub, 0x23: self._subu,
+            0x24: self._and, 0x25: self._or, 0x26: self._xor, 0x27: self._nor, 0x2A: self._slt, 0x2B: self._sltu,
+            0x2C: self._dadd, 0x2D: self._daddu, 0x2E: self._dsub, 0x2F: self._dsubu,
+            0x30: self._trap_compare, 0x31: self._trap_compare, 0x32: self._trap_compare,
+            0x33: self._trap_compare, 0x34: self._trap_compare, 0x36: self._trap_compare,
+            0x38: self._dsll, 0x3A: self._dsrl, 0x3B: self._dsra, 0x3C: self._dsll32, 0x3E: self._dsrl32,
+            0x3F: self._dsra32,
+        }
+        self._regimm = {0x00: self._bltz, 0x01: self._bgez, 0x02: self._bltzl, 0x03: self._bgezl,
+                        0x10: self._bltzal, 0x11: self._bgezal, 0x12: self._bltzall, 0x13: self._bgezall}
+
+    def _decode(self, word, pc):
+        """Returns (handler, word, mask of the registers the instruction reads)."""
+        op = word >> 26
+        rs = 1 << ((word >> 21) & 31)
+        rt = 1 << ((word >> 16) & 31)
+        if op == 0:
+            handler = self._special.get(word & 0x3F)
+            reads = rs | rt
+        elif op == 1:
+            handler = self._regimm.get((word >> 16) & 31)
+            reads = rs
+        else:
+            handler = self._opcodes.get(op)
+            # Branches and stores read rt too; everything else writes it.
+            reads = rs | rt if op in (0x04, 0x05, 0x14, 0x15) or op >= 0x28 else rs
+        if handler is None:
+            return (lambda word: self._unsupported(word, pc)), word, 0
+        return handler, word, reads & ~1
+
+    def _unsupported(self, word, pc):
+        raise Fault("unsupported instruction %08X" % word, pc)
+
+    # Memory access from code
+
+    def _data(self, address, size, store=False):
+        """Checks a load or store, charges the cache for it, and returns its RDRAM offset."""
+        address &= MASK32
+        if address & (size - 1):
+            raise Fault("unaligned %d-byte %s at %08X" % (size, "store" if store else "load", address), self.current_pc)
+        if not K0BASE <= address < K2BASE or (address & 0x1FFFFFFF) + size > self.memory.size:
+            raise Fault("%s at bad address %08X" % ("store" if store else "load", address), self.current_pc)
+        physical = address & 0x1FFFFFFF
+        if self.watch is not None:
+            self.watch(address, size, store)
+        if address < K1BASE:
+            self.cycles += self.dcache.access(physical, store)
+        else:
+            self.cycles += UNCACHED_CYCLES
+            self.uncached_accesses += 1
+        return physical
+
+    def _address(self, word):
+        return self.gpr[(word >> 21) & 31] + sext16(word)
+
+    def _load(self, word, size, signed):
+        physical = self._data(self._address(word), size)
+        value = int.from_bytes(self.rdram[physical:physical + size], "big")
+        if signed and value >> (size * 8 - 1):
+            value -= 1 << (size * 8)
+        rt = (word >> 16) & 31
+        self.gpr[rt] = value & MASK64
+        self._load_mask = 1 << rt
+
+    def _store(self, word, size, value):
+        physical = self._data(self._address(word), size, True)
+        self.rdram[physical:physical + size] = (value & ((1 << (size * 8)) - 1)).to_bytes(size, "big")
+
+    def _load_partial(self, word, size, left):
+        """LWL/LWR/LDL/LDR: merge the bytes of an unaligned value that fall in one aligned word."""
+        address = self._address(word) & MASK32
+        physical = self._data(address & ~(size - 1), size)
+        memory = int.from_bytes(self.rdram[physical:physical + size], "big")
+        rt = (word >> 16) & 31
+        old = self.gpr[rt]
+        bits = size * 8
+        mask = (1 << bits) - 1
+        offset = address & (size - 1)
+        if left:
+            shift = offset * 8
+            value = ((memory << shift) & mask) | (old & ((1 << shift) - 1))
+        else:
+            shift = (size - 1 - offset) * 8
+            value = (memory >> shift) | (old & mask & ~(mask >> shift))
+        self.gpr[rt] = sext32(value) if size == 4 else value
+        self._load_mask = 1 << rt
+
+    def _store_partial(self, word, size, left):
+        """SWL/SWR/SDL/SDR."""
+        address = self._address(word) & MASK32
+        physical = self._data(address & ~(size - 1), size, True)
+        memory = int.from_bytes(self.rdram[physical:physical + size], "big")
+        bits = size * 8
+        mask = (1 << bits) - 1
+        value = self.gpr[(word >> 16) & 31] & mask
+        offset = address & (size - 1)
+        if left:
+            shift = offset * 8
+            memory = (memory & ~(mask >> shift) & mask) | (value >> shift)
+        else:
+            shift = (size - 1 - offset) * 8
+            memory = ((value << shift) & mask) | (memory & ((1 << shift) - 1))
+        self.rdram[physical:physical + size] = memory.to_bytes(size, "big")
+
+    # Branches and jumps.  self.pc is the delay slot when these run.
+
+    def _branch(self, word, taken, likely=False, link=False):
+        if link:
+            self.gpr[RA] = sext32(self.pc + 4)
+        if taken:
+            self.npc = (self.pc + (sext16(word) << 2)) & MASK32
+        elif likely:
+            self.pc = self.npc
+            self.npc = self.pc + 4
+            self.cycles += BRANCH_LIKELY_SKIP_CYCLES
+
+    def _rs(self, word):
+        return self.gpr[(word >> 21) & 31]
+
+    def _rt(self, word):
+        return self.gpr[(word >> 16) & 31]
+
+    def _j(self, word):
+        self.npc = (self.pc & 0xF0000000) | ((word & 0x3FFFFFF) << 2)
+
+    def _jal(self, word):
+        self.gpr[RA] = sext32(self.pc + 4)
+        self.npc = (self.pc & 0xF0000000) | ((word & 0x3FFFFFF) << 2)
+
+    def _jr(self, word):
+        self.npc = self._rs(word) & MASK32
+
+    def _jalr(self, word):
+        target = self._rs(word) & MASK32
+        self.gpr[(word >> 11) & 31] = sext32(self.pc + 4)
+        self.npc = target
+
+    def _beq(self, word):
+        self._branch(word, self._rs(word) == self._rt(word))
+
+    def _bne(self, word):
+        self._branch(word, self._rs(word) != self._rt(word))
+
+    def _blez(self, word):
+        self._branch(word, signed64(self._rs(word)) <= 0)
+
+    def _bgtz(self, word):
+        self._branch(word, signed64(self._rs(word)) > 0)
+
+    def _beql(self, word):
+        self._branch(word, self._rs(word) == self._rt(word), likely=True)
+
+    def _bnel(self, word):
+        self._branch(word, self._rs(word) != self._rt(word), likely=True)
+
+    def _blezl(self, word):
+        self._branch(word, signed64(self._rs(word)) <= 0, likely=True)
+
+    def _bgtzl(self, word):
+        self._branch(word, signed64(self._rs(word)) > 0, likely=True)
+
+    def _bltz(self, word):
+        self._branch(word, signed64(self._rs(word)) < 0)
+
+    def _bgez(self, word):
+        self._branch(word, signed64(self._rs(word)) >= 0)
+
+    def _bltzl(self, word):
+        self._branch(word, signed64(self._rs(word)) < 0, likely=True)
+
+    def _bgezl(self, word):
+        self._branch(word, signed64(self._rs(word)) >= 0, likely=True)
+
+    def _bltzal(self, word):
+        self._branch(word, signed64(self._rs(word)) < 0, link=True)
+
+    def _bgezal(self, word):
+        self._branch(word, signed64(self._rs(word)) >= 0, link=True)
+
+    def _bltzall(self, word):
+        self._branch(word, signed64(self._rs(word)) < 0, likely=True, link=True)
+
+    def _bgezall(self, word):
+        self._branch(word, signed64(self._rs(word)) >= 0, likely=True, link=True)
+
+    # Immediate arithmetic
+
+    def _set_rt(self, word, value):
+        self.gpr[(word >> 16) & 31] = value
+
+    def _addi(self, word):
+        result = signed32(self._rs(word)) + sext16(word)
+        if not -0x80000000 <= result <= 0x7FFFFFFF:
+            raise Fault("ADDI overflowed", self.current_pc)
+        self._set_rt(word, sext32(result))
+
+    def _addiu(self, word):
+        self._set_rt(word, sext32(self._rs(word) + sext16(word)))
+
+    def _daddi(self, word):
+        self._set_rt(word, (self._rs(word) + sext16(word)) & MASK64)
+
+    _daddiu = _daddi
+
+    def _slti(self, word):
+        self._set_rt(word, int(signed64(self._rs(word)) < sext16(word)))
+
+    def _sltiu(self, word):
+        self._set_rt(word, int(self._rs(word) < (sext16(word) & MASK64)))
+
+    def _andi(self, word):
+        self._set_rt(word, self._rs(word) & (word & 0xFFFF))
+
+    def _ori(self, word):
+        self._set_rt(word, self._rs(word) | (word & 0xFFFF))
+
+    def _xori(self, word):
+        self._set_rt(word, self._rs(word) ^ (word & 0xFFFF))
+
+    def _lui(self, word):
+        self._set_rt(word, sext32((word & 0xFFFF) << 16))
+
+    # Loads and stores
+
+    def _lb(self, word):
+        self._load(word, 1, True)
+
+    def _lbu(self, word):
+        self._load(word, 1, False)
+
+    def _lh(self, word):
+        self._load(word, 2, True)
+
+    def _lhu(self, word):
+        self._load(word, 2, False)
+
+    def _lw(self, word):
+        self._load(word, 4, True)
+
+    def _lwu(self, word):
+        self._load(word, 4, False)
+
+    def _ld(self, word):
+        self._load(word, 8, False)
+
+    def _lwl(self, word):
+        self._load_partial(word, 4, True)
+
+    def _lwr(self, word):
+        self._load_partial(word, 4, False)
+
+    def _ldl(self, word):
+        self._load_partial(word, 8, True)
+
+    def _ldr(self, word):
+        self._load_partial(word, 8, False)
+
+    def _sb(self, word):
+        self._store(word, 1, self._rt(word))
+
+    def _sh(self, word):
+        self._store(word, 2, self._rt(word))
+
+    def _sw(self, word):
+        self._store(word, 4, self._rt(word))
+
+    def _sd(self, word):
+        self._store(word, 8, self._rt(word))
+
+    def _sc(self, word):
+        self._store(word, 4, self._rt(word))
+        self._set_rt(word, 1)
+
+    def _swl(self, word):
+        self._store_partial(word, 4, True)
+
+    def _swr(self, word):
+        self._store_partial(word, 4, False)
+
+    def _sdl(self, word):
+        self._store_partial(word, 8, True)
+
+    def _sdr(self, word):
+        self._store_partial(word, 8, False)
+
+    def _nop(self, word):
+        pass
+
+    # SPECIAL
+
+    def _set_rd(self, word, value):
+        self.gpr[(word >> 11) & 31] = value
+
+    def _sll(self, word):
+        self._set_rd(word, sext32(self._rt(word) << ((word >> 6) & 31)))
+
+    def _srl(self, word):
+        self._set_rd(word, sext32((self._rt(word) & MASK32) >> ((word >> 6) & 31)))
+
+    def _sra(self, word):
+        self._set_rd(word, sext32(signed32(self._rt(word)) >> ((word >> 6) & 31)))
+
+    def _sllv(self, word):
+        self._set_rd(word, sext32(self._rt(word) << (self._rs(word) & 31)))
+
+    def _srlv(self, word):
+        self._set_rd(word, sext32((self._rt(word) & MASK32) >> (self._rs(word) & 31)))
+
+    def _srav(self, word):
+        self._set_rd(word, sext32(signed32(self._rt(word)) >> (self._rs(word) & 31)))
+
+    def _dsllv(self, word):
+        self._set_rd(word, (self._rt(word) << (self._rs(word) & 63)) & MASK64)
+
+    def _dsrlv(self, word):
+        self._set_rd(word, self._rt(word) >> (self._rs(word) & 63))
+
+    def _dsrav(self, word):
+        self._set_rd(word, (signed64(self._rt(word)) >> (self._rs(word) & 63)) & MASK64)
+
+    def _dsll(self, word):
+        self._set_rd(word, (self._rt(word) << ((word >> 6) & 31)) & MASK64)
+
+    def _dsrl(self, word):
+        self._set_rd(word, self._rt(word) >> ((word >> 6) & 31))
+
+    def _dsra(self, word):
+        self._set_rd(word, (signed64(self._rt(word)) >> ((word >> 6) & 31)) & MASK64)
+
+    def _dsll32(self, word):
+        self._set_rd(word, (self._rt(word) << (32 + ((word >> 6) & 31))) & MASK64)
+
+    def _dsrl32(self, word):
+        self._set_rd(word, self._rt(word) >> (32 + ((word >> 6) & 31)))
+
+    def _dsra32(self, word):
+        self._set_rd(word, (signed64(self._rt(word)) >> (32 + ((word >> 6) & 31))) & MASK64)
+
+    def _syscall(self, word):
+        raise Fault("SYSCALL/BREAK %d" % ((word >> 6) & 0xFFFFF), self.current_pc)
+
+    def _trap_compare(self, word):
+        a, b = self._rs(word), self._rt(word)
+        funct = word & 0x3F
+        taken = {0x30: signed64(a) >= signed64(b), 0x31: a >= b, 0x32: signed64(a) < signed64(b),
+                 0x33: a < b, 0x34: a == b, 0x36: a != b}[funct]
+        if taken:
+            raise Fault("trap %d (divide by zero?)" % ((word >> 6) & 0x3FF), self.current_pc)
+
+    def _mfhi(self, word):
+        self._set_rd(word, self.hi)
+
+    def _mflo(self, word):
+        self._set_rd(word, self.lo)
+
+    def _mthi(self, word):
+        self.hi = self._rs(word)
+
+    def _mtlo(self, word):
+        self.lo = self._rs(word)
+
+    def _mult(self, word):
+        product = signed32(self._rs(word)) * signed32(self._rt(word))
+        self.lo, self.hi = sext32(product), sext32(product >> 32)
+        self.cycles += MULT_CYCLES
+
+    def _multu(self, word):
+        product = (self._rs(word) & MASK32) * (self._rt(word) & MASK32)
+        self.lo, self.hi = sext32(product), sext32(product >> 32)
+        self.cycles += MULT_CYCLES
+
+    def _dmult(self, word):
+        product = signed64(self._rs(word)) * signed64(self._rt(word))
+        self.lo, self.hi = product & MASK64, (product >> 64) & MASK64
+        self.cycles += DMULT_CYCLES
+
+    def _dmultu(self, word):
+        product = self._rs(word) * self._rt(word)
+        self.lo, self.hi = product & MASK64, product >> 64
+        self.cycles += DMULT_CYCLES
+
+    def _div(self, word):
+        a, b = signed32(self._rs(word)), signed32(self._rt(word))
+        self.cycles += DIV_CYCLES
+        if b == 0:
+            self.lo, self.hi = sext32(-1 if a >= 0 else 1), sext32(a)
+            return
+        quotient, remainder = _divide(a, b)
+        self.lo, self.hi = sext32(quotient), sext32(remainder)
+
+    def _divu(self, word):
+        a, b = self._rs(word) & MASK32, self._rt(word) & MASK32
+        self.cycles += DIV_CYCLES
+        if b == 0:
+            self.lo, self.hi = MASK64, sext32(a)
+            return
+        self.lo, self.hi = sext32(a // b), sext32(a % b)
+
+    def _ddiv(self, word):
+        a, b = signed64(self._rs(word)), signed64(self._rt(word))
+        self.cycles += DDIV_CYCLES
+        if b == 0:
+            self.lo, self.hi = (-1 if a >= 0 else 1) & MASK64, a & MASK64
+            return
+        quotient, remainder = _divide(a, b)
+        self.lo, self.hi = quotient & MASK64, remainder & MASK64
+
+    def _ddivu(self, word):
+        a, b = self._rs(word), self._rt(word)
+        self.cycles += DDIV_CYCLES
+        if b == 0:
+            self.lo, self.hi = MASK64, a
+            return
+        self.lo, self.hi = a // b, a % b
+
+    def _add(self, word):
+        result = signed32(self._rs(word)) + signed32(self._rt(word))
+        if not -0x80000000 <= result <= 0x7FFFFFFF:
+            raise Fault("ADD overflowed", self.current_pc)
+        self._set_rd(word, sext32(result))
+
+    def _addu(self, word):
+        self._set_rd(word, sext32(self._rs(word) + self._rt(word)))
+
+    def _sub(self, word):
+        result = signed32(self._rs(word)) - signed32(self._rt(word))
+        if not -0x80000000 <= result <= 0x7FFFFFFF:
+            raise Fault("SUB overflowed", self.current_pc)
+        self._set_rd(word, sext32(result))
+
+    def _subu(self, word):
+        self._set_rd(word, sext32(self._rs(word) - self._rt(word)))
+
+    def _dadd(self, word):
+        self._set_rd(word, (self._rs(word) + self._rt(word)) & MASK64)
+
+    _daddu = _dadd
+
+    def _dsub(self, word):
+        self._set_rd(word, (self._rs(word) - self._rt(word)) & MASK64)
+
+    _dsubu = _dsub
+
+    def _and(self, word):
+        self._set_rd(word, self._rs(word) & self._rt(word))
+
+    def _or(self, word):
+        self._set_rd(word, self._rs(word) | self._rt(word))
+
+    def _xor(self, word):
+        self._set_rd(word, self._rs(word) ^ self._rt(word))
+
+    def _nor(self, word):
+        self._set_rd(word, ~(self._rs(word) | self._rt(word)) & MASK64)
+
+    def _slt(self, word):
+        self._set_rd(word, int(signed64(self._rs(word)) < signed64(self._rt(word))))
+
+    def _sltu(self, word):
+        self._set_rd(word, int(self._rs(word) < self._rt(word)))
+
+    # Coprocessors
+
+    def _cop0(self, word):
+        rs = (word >> 21) & 31
+        if rs == 0:                                 # MFC0: only Count ($9) means anything here
+            count = self.cycles // COP0_COUNT_DIVIDER if (word >> 11) & 31 == 9 else 0
+            self._set_rt(word, sext32(count))
+        elif rs not in (4, 16):                     # MTC0 and TLB/ERET ops are ignored
+            self._unsupported(word, self.current_pc)
+
+    def _get_single(self, index):
+        return struct.unpack(">f", self.fpr[index].to_bytes(4, "big"))[0]
+
+    def _set_single(self, index, value):
+        self.fpr[index] = int.from_bytes(struct.pack(">f", _float32(value)), "big")
+
+    def _get_double(self, index):
+        bits = (self.fpr[index | 1] << 32) | self.fpr[index & ~1]
+        return struct.unpack(">d", bits.to_bytes(8, "big"))[0]
+
+    def _set_double(self, index, value):
+        bits = int.from_bytes(struct.pack(">d", value), "big")
+        self.fpr[index & ~1], self.fpr[index | 1] = bits & MASK32, bits >> 32
+
+    def _get_fixed(self, index, fmt):
+        if fmt == 20:
+            return signed32(self.fpr[index])
+        return signed64((self.fpr[index | 1] << 32) | self.fpr[index & ~1])
+
+    def _set_fixed(self, index, value, long_result):
+        if long_result:
+            value &= MASK64
+            self.fpr[index & ~1], self.fpr[index | 1] = value & MASK32, value >> 32
+        else:
+            self.fpr[index] = value & MASK32
+
+    def _cop1(self, word):
+        rs = (word >> 21) & 31
+        rt = (word >> 16) & 31
+        fs = (word >> 11) & 31
+        if rs == 0:                                 # MFC1
+            self._set_rt(word, sext32(self.fpr[fs]))
+            self._load_mask = 1 << rt
+        elif rs == 1:                               # DMFC1
+            self._set_rt(word, (self.fpr[fs | 1] << 32) | self.fpr[fs & ~1])
+        elif rs == 2:                               # CFC1
+            self._set_rt(word, sext32(self.fcr31 if fs == 31 else 0))
+        elif rs == 4:                               # MTC1
+            self.fpr[fs] = self.gpr[rt] & MASK32
+        elif rs == 5:                               # DMTC1
+            self.fpr[fs & ~1], self.fpr[fs | 1] = self.gpr[rt] & MASK32, (self.gpr[rt] >> 32) & MASK32
+        elif rs == 6:                               # CTC1
+            if fs == 31:
+                self.fcr31 = self.gpr[rt] & MASK32
+        elif rs == 8:                               # BC1F, BC1T, BC1FL, BC1TL
+            condition = bool(self.fcr31 & 0x800000)
+            self._branch(word, condition == bool(rt & 1), likely=bool(rt & 2))
+        elif rs in (16, 17):
+            self._cop1_float(word, rs == 17)
+        elif rs in (20, 21):                        # CVT.S/CVT.D from W or L
+            funct = word & 0x3F
+            value = float(self._get_fixed(fs, rs))
+            fd = (word >> 6) & 31
+            if funct == 0x20:
+                self._set_single(fd, value)
+            elif funct == 0x21:
+                self._set_double(fd, value)
+            else:
+                self._unsupported(word, self.current_pc)
+            self.cycles += FLOAT_CYCLES["cvt"][1]
+        else:
+            self._unsupported(word, self.current_pc)
+
+    def _cop1_float(self, word, double):
+        funct = word & 0x3F
+        ft = (word >> 16) & 31
+        fs = (word >> 11) & 31
+        fd = (word >> 6) & 31
+        get = self._get_double if double else self._get_single
+        put = self._set_double if double else self._set_single
+        a = get(fs)
+        if funct >= 0x30:                           # C.cond: bit 0 unordered, 1 equal, 2 less than
+            b = get(ft)
+            unordered = a != a or b != b
+            condition = ((funct & 1 and unordered) or (funct & 2 and not unordered and a == b)
+                         or (funct & 4 and not unordered and a < b))
+            self.fcr31 = (self.fcr31 | 0x800000) if condition else (self.fcr31 & ~0x800000)
+            return
+        operations = {0: ("add", lambda: a + get(ft)), 1: ("sub", lambda: a - get(ft)),
+                      2: ("mul", lambda: a * get(ft)), 3: ("div", lambda: self._float_divide(a, get(ft))),
+                      4: ("sqrt", lambda: a ** 0.5 if a >= 0 else float("nan")),
+                      5: ("abs", lambda: abs(a)), 6: ("mov", lambda: a), 7: ("neg", lambda: -a)}
+        if funct in operations:
+            name, operation = operations[funct]
+            put(fd, operation())
+            self.cycles += FLOAT_CYCLES[name][double]
+        elif funct in (0x20, 0x21):                 # CVT.S, CVT.D
+            (self._set_double if funct == 0x21 else self._set_single)(fd, a)
+            self.cycles += FLOAT_CYCLES["cvt"][double]
+        elif funct in (0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x24, 0x25):
+            if a != a or a in (float("inf"), float("-inf")):
+                raise Fault("float to integer conversion of %r" % a, self.current_pc)
+            mode = {0x08: 0, 0x0C: 0, 0x09: 1, 0x0D: 1, 0x0A: 2, 0x0E: 2, 0x0B: 3, 0x0F: 3}.get(
+                funct, self.fcr31 & 3)
+            rounded = (round(a), int(a), -int(-a // 1), int(a // 1))[mode]
+            self._set_fixed(fd, rounded, funct in (0x08, 0x09, 0x0A, 0x0B, 0x25))
+            self.cycles += FLOAT_CYCLES["cvt"][double]
+        else:
+            self._unsupported(word, self.current_pc)
+
+    def _float_divide(self, a, b):
+        if b == 0:
+            return float("nan") if a == 0 or a != a else (float("inf") if a > 0 else float("-inf"))
+        return a / b
+
+    def _lwc1(self, word):
+        physical = self._data(self._address(word), 4)
+        self.fpr[(word >> 16) & 31] = int.from_bytes(self.rdram[physical:physical + 4], "big")
+
+    def _swc1(self, word):
+        physical = self._data(self._address(word), 4, True)
+        self.rdram[physical:physical + 4] = self.fpr[(word >> 16) & 31].to_bytes(4, "big")
+
+    def _ldc1(self, word):
+        physical = self._data(self._address(word), 8)
+        ft = (word >> 16) & 31
+        self.fpr[ft | 1] = int.from_bytes(self.rdram[physical:physical + 4], "big")
+        self.fpr[ft & ~1] = int.from_bytes(self.rdram[physical + 4:physical + 8], "big")
+
+    def _sdc1(self, word):
+        physical = self._data(self._address(word), 8, True)
+        ft = (word >> 16) & 31
+        self.rdram[physical:physical + 8] = self.fpr[ft | 1].to_bytes(4, "big") + self.fpr[ft & ~1].to_bytes(4, "big")
+
+
+# ELF loading
+
+ET_REL = 1
+EM_MIPS = 8
+SHT_SYMTAB, SHT_RELA, SHT_NOBITS, SHT_REL = 2, 4, 8, 9
+SHT_LOPROC = 0x70000000
+SHF_ALLOC = 0x2
+SHN_UNDEF, SHN_ABS, SHN_COMMON = 0, 0xFFF1, 0xFFF2
+STT_SECTION = 3
+R_MIPS_NONE, R_MIPS_32, R_MIPS_26, R_MIPS_HI16, R_MIPS_LO16, R_MIPS_PC16 = 0, 2, 4, 5, 6, 10
+R_MIPS_NAMES = {7: "GPREL16 (build with -G0)", 9: "GOT16 (build with -fno-pic -mno-abicalls)",
+                11: "CALL16 (build with -fno-pic -mno-abicalls)"}
+
+
+class Section:
+    def __init__(self, name, kind, flags, offset, size, link, info, align, entsize):
+        self.name = name
+        self.kind = kind
+        self.flags = flags
+        self.offset = offset
+        self.size = size
+        self.link = link
+        self.info = info
+        self.align = max(1, align)
+        self.entsize = entsize
+        self.address = None
+
+
+class LinkedImage:
+    """What link_object() put where: section addresses and the symbols it defined or resolved."""
+
+    def __init__(self):
+        self.sections = []              # (name, address, size)
+        self.symbols = {}               # name -> address, for defined functions and data
+        self.imports = {}               # name -> address the resolver gave an undefined symbol
+        self.start = self.end = 0
+
+    def symbol_at(self, address):
+        """The defined symbol at or before address, as "name+0x10", or None."""
+        best = None
+        for name, value in self.symbols.items():
+            if value <= address and (best is None or value > best[1]):
+                best = (name, value)
+        if best is None:
+            return None
+        return best[0] if best[1] == address else "%s+0x%X" % (best[0], address - best[1])
+
+
+def _elf_sections(data):
+    if data[:4] != b"\x7fELF" or len(data) < 52:
+        raise ValueError("not an ELF file")
+    if data[4] != 1 or data[5] != 2:
+        raise ValueError("not a 32-bit big-endian ELF file (build for o32, big-endian)")
+    (kind, machine, _, _, _, shoff, _, _, _, _, shentsize, shnum, shstrndx) = struct.unpack_from(
+        ">HHIIIIIHHHHHH", data, 16)
+    if machine != EM_MIPS:
+        raise ValueError("not a MIPS ELF file")
+    if kind != ET_REL:
+        raise ValueError("not a relocatable object; pass the .o from `gcc -c`, not a linked program")
+    headers = [struct.unpack_from(">IIIIIIIIII", data, shoff + index * shentsize) for index in range(shnum)]
+    names = headers[shstrndx]
+    sections = []
+    for name, kind, flags, _, offset, size, link, info, align, entsize in headers:
+        name_at = names[4] + name
+        sections.append(Section(data[name_at:data.index(b"\0", name_at)].decode("latin-1"),
+                                kind, flags, offset, size, link, info, align, entsize))
+    return sections
+
+
+def link_object(data, memory, base, resolve):
+    """Loads a relocatable MIPS object into memory at base and relocates it.
+
+    resolve(name) gives the address for each undefined symbol.  Returns a
+    LinkedImage.  Raises ValueError for objects this can't load.
+    """
+    sections = _elf_sections(data)
+    image = LinkedImage()
+    address = base
+    for section in sections:
+        if section.flags & SHF_ALLOC and section.kind < SHT_LOPROC and section.size:
+            address = (address + section.align - 1) & ~(section.align - 1)
+            section.address = address
+            if section.kind != SHT_NOBITS:
+                memory.write(address, data[section.offset:section.offset + section.size])
+            else:
+                memory.write(address, bytes(section.size))
+            image.sections.append((section.name, address, section.size))
+            address += section.size
+
+    symtab = next((section for section in sections if section.kind == SHT_SYMTAB), None)
+    symbols = []
+    if symtab is not None:
+        strings = sections[symtab.link]
+        for offset in range(symtab.offset, symtab.offset + symtab.size, 16):
+            name, value, size, info, _, shndx = struct.unpack_from(">IIIBBH", data, offset)
+            name_at = strings.offset + name
+            name = data[name_at:data.index(b"\0", name_at)].decode("latin-1")
+            if info & 0xF == STT_SECTION:
+                symbols.append(sections[shndx].address or 0)
+            elif shndx == SHN_UNDEF:
+                if name and name not in image.imports:
+                    image.imports[name] = resolve(name) & MASK32
+                symbols.append(image.imports.get(name, 0))
+            elif shndx == SHN_ABS:
+                symbols.append(value)
+            elif shndx == SHN_COMMON:
+                address = (address + max(1, value) - 1) & ~(max(1, value) - 1)
+                memory.write(address, bytes(size))
+                image.symbols[name] = address
+                symbols.append(address)
+                address += size
+            elif sections[shndx].address is not None:
+                symbols.append(sections[shndx].address + value)
+                if name:
+                    image.symbols[name] = sections[shndx].address + value
+            else:
+                symbols.append(0)
+
+    for section in sections:
+        if section.kind in (SHT_REL, SHT_RELA) and sections[section.info].address is not None:
+            _relocate(data, memory, section, sections[section.info].address, symbols)
+
+    image.start, image.end = base, address
+    return image
+
+
+def _relocate(data, memory, section, target, symbols):
+    step = 12 if section.kind == SHT_RELA else 8
+    pending_hi = []
+    for offset in range(section.offset, section.offset + section.size, step):
+        r_offset, info = struct.unpack_from(">II", data, offset)
+        addend = struct.unpack_from(">i", data, offset + 8)[0] if step == 12 else None
+        kind = info & 0xFF
+        symbol = symbols[info >> 8] if info >> 8 < len(symbols) else 0
+        place = target + r_offset
+        if kind == R_MIPS_NONE:
+            continue
+        word = memory.read_u32(place)
+        if kind == R_MIPS_32:
+            memory.write_u32(place, symbol + (word if addend is None else addend))
+        elif kind == R_MIPS_26:
+            value = symbol + (((word & 0x3FFFFFF) << 2) if addend is None else addend)
+            if (value ^ (place + 4)) & 0xF0000000:
+                raise ValueError("jump at %08X can't reach %08X" % (place, value))
+            memory.write_u32(place, (word & 0xFC000000) | ((value >> 2) & 0x3FFFFFF))
+        elif kind == R_MIPS_HI16:
+            if addend is None:
+                pending_hi.append((place, symbol, word))
+            else:
+                memory.write_u32(place, (word & 0xFFFF0000) | (((symbol + addend + 0x8000) >> 16) & 0xFFFF))
+        elif kind == R_MIPS_LO16:
+            low = sext16(word) if addend is None else addend
+            for hi_place, hi_symbol, hi_word in pending_hi:
+                value = hi_symbol + ((hi_word & 0xFFFF) << 16) + low
+                memory.write_u32(hi_place, (hi_word & 0xFFFF0000) | (((value + 0x8000) >> 16) & 0xFFFF))
+            pending_hi = []
+            memory.write_u32(place, (word & 0xFFFF0000) | ((symbol + low) & 0xFFFF))
+        elif kind == R_MIPS_PC16:
+            value = symbol + ((sext16(word) << 2) if addend is None else addend) - place
+            memory.write_u32(place, (word & 0xFFFF0000) | ((value >> 2) & 0xFFFF))
+        else:
+            raise ValueError("unsupported relocation type %s at %08X"
+                             % (R_MIPS_NAMES.get(kind, str(kind)), place))
+    if pending_hi:
+        raise ValueError("R_MIPS_HI16 without a matching R_MIPS_LO16 in %s" % section.name)
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""Release pipeline for a board's .xdelta patches.
+
+Until now every release meant hand-making a fresh patch against the vanilla
+ROM, so a one-line fix to the quiz shipped as another 1.9 MB download.  This
+tool keeps a release_manifest.json beside the board that records, for each
+release:
+  - the hash of every input that goes into the ROM: each event's code, each
+    image and song (see board_sources.py and board_assets.py), and the board
+    layout itself;
+  - the sha256 of the patched ROM it produced;
+  - which ROM byte ranges changed, and which inputs changed with them, so the
+    manifest learns over time which ROM regions each event and asset feeds.
+
+    status   lists the inputs that changed since the last release, and the ROM
+             regions each of them fed last time, so you know which events to
+             re-paste in PartyPlanner64 and roughly where the ROM will change.
+    release  takes the ROM PartyPlanner64 exported and writes two patches:
+             the full one (vanilla -> new) and an update (last release -> new).
+             The update only carries the changed regions, so it's kilobytes.
+             Both are checked by applying them before anything is written.
+    baseline records the board as it is now as an existing release whose
+             patched ROM you don't have on hand (like Game Night 1.0.0), so
+             status has something to compare against.
+
+The previous release's patched ROM comes from --previous, or is rebuilt by
+applying that release's full patch to vanilla when this tool made it.
+Patches are plain VCDIFF (see vcdiff.py) and open in any xdelta patcher.
+
+Usage:
+    python3 Tools/release_patch.py status Complete/MP3/Boards/GameNight/game_night.json
+    python3 Tools/release_patch.py release Complete/MP3/Boards/GameNight/game_night.json \\
+        --vanilla mp3_usa.z64 --rom game_night_1_0_1.z64 --version 1.0.1 [--previous game_night_1_0_0.z64]
+"""
+
+import argparse
+import base64
+import hashlib
+import json
+import os
+import sys
+
+import boardlib
+import vcdiff
+
+MANIFEST_NAME = "release_manifest.json"
+
+# Byte ranges closer together than this are reported as one region.
+REGION_MERGE_GAP = 64
+
+
+def sha256(data):
+    return hashlib.sha256(data).hexdigest()
+
+
+#***************************************************************************#
+#********************************* Inputs **********************************#
+#***************************************************************************#
+
+def board_inputs(board):
+    """Returns {input name: sha256} for everything in a raw board that ends up in the ROM."""
+    inputs = {}
+    for name, event in (board.get("events") or {}).items():
+        if boardlib.is_source_reference(event):
+            inputs["event:" + name] = event["sha256"]
+        else:
+            inputs["event:" + name] = boardlib.source_hash(event.get("code", ""))
+
+    for container, key, value in boardlib.iter_asset_slots(board):
+        if boardlib.is_asset_reference(value):
+            digest = value["sha256"]
+        else:
+            digest = sha256(base64.b64decode(boardlib.parse_data_url(value)[1]))
+        inputs["asset:" + asset_slot_path(board, container, key)] = digest
+
+    # Everything else (spaces, links, placements and their parameters, names) is the layout.
+    layout = {k: v for k, v in board.items() if k not in ("events", "bg", "otherbg", "audioData")}
+    layout["bg"] = {k: v for k, v in (board.get("bg") or {}).items() if k != "src"}
+    inputs["board:layout"] = sha256(json.dumps(layout, sort_keys=True).encode("utf-8"))
+    return inputs
+
+
+def asset_slot_path(board, container, key):
+    """A stable name for where an asset sits in the board, like "otherbg.boardlogo" or "audioData[0]"."""
+    if container is board.get("bg"):
+        return "bg"
+    if container is board.get("otherbg"):
+        return "otherbg." + key
+    for index, entry in enumerate(board.get("audioData") or []):
+        if container is entry:
+            return "audioData[%d]" % index
+    return str(key)
+
+
+def diff_inputs(old, new):
+    """Returns (changed, added, removed) input names."""
+    changed = sorted(name for name in new if name in old and old[name] != new[name])
+    added = sorted(name for name in new if name not in old)
+    removed = sorted(name for name in old if name not in new)
+    return changed, added, removed
+
+
+#***************************************************************************#
+#******************************** ROM regions ******************************#
+#***************************************************************************#
+
+def changed_regions(old, new, block=4096):
+    """Returns [start, end) byte ranges where new differs from old (or runs past its end)."""
+    regions = []
+    length = min(len(old), len(new))
+    for start in range(0, length, block):
+        end = min(start + block, length)
+        if old[start:end] == new[start:end]:
+            continue
+        pos = start
+        while pos < end:
+            if old[pos] == new[pos]:
+                pos += 1
+                continue
+            first = pos
+            while pos < end and old[pos] != new[pos]:
+                pos += 1
+            if regions and first - regions[-1][1] < REGION_MERGE_GAP:
+                regions[-1][1] = pos
+            else:
+                regions.append([first, pos])
+    if len(new) > length:
+        regions.append([length, len(new)])
+    return regions
+
+
+def format_region(region):
+    return "0x%08X-0x%08X (%d bytes)" % (region[0], region[1], region[1] - region[0])
+
+
+#***************************************************************************#
+#********************************* Manifest ********************************#
+#***************************************************************************#
+
+def manifest_path(board_path):
+    return os.path.join(os.path.dirname(os.path.abspath(board_path)), MANIFEST_NAME)
+
+
+def load_manifest(board_path):
+    path = manifest_path(board_path)
+    if not os.path.isfile(path):
+        return {"releases": [], "regions": {}}
+    with open(path, "r", encoding="utf-8") as f:
+        return json.load(f)
+
+
+def save_manifest(board_path, manifest):
+    with open(manifest_path(board_path), "w", encoding="utf-8", newline="\n") as f:
+        json.dump(manifest, f, indent=1, sort_keys=True)
+        f.write("\n")
+
+
+def patch_prefix(board):
+    return "MP3_" + board.get("name", "Board").replace(" ", "_")
+
+
+def version_tag(version):
+    return "v" + version.replace(".", "_")
+
+
+def read_file(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def previous_rom(args, manifest, vanilla, board_dir):
+    """Returns the last release's patched ROM, or None if there's no last release."""
+    if not manifest["releases"]:
+        return None
+    last = manifest["releases"][-1]
+    if args.previous:
+        rom = read_file(args.previous)
+    elif last.get("full_patch"):
+        rom = vcdiff.decode(vanilla, read_file(os.path.join(board_dir, last["full_patch"])))
+    else:
+        raise ValueError("release %s has no patch this tool can apply; pass its patched ROM with --previous"
+                         % last["version"])
+    if last.get("rom_sha256") and sha256(rom) != last["rom_sha256"]:
+        raise ValueError("the previous ROM isn't release %s (sha256 doesn't match the manifest)" % last["version"])
+    return rom
+
+
+def attribute_regions(manifest, version, changed_inputs, regions):
+    """Records which ROM regions the inputs that changed in this release fed.
+
+    With one changed input, its regions are known exactly.  With several, every
+    one of them gets all the regions, marked shared, until a later release
+    changes one on its own.
+    """
+    for name in changed_inputs:
+        manifest["regions"][name] = {
+            "release": version,
+            "ranges": regions,
+            "shared_with": [other for other in changed_inputs if other != name],
+        }
+
+
+#***************************************************************************#
+#********************************* Commands ********************************#
+#***************************************************************************#
+
+def status(args, board, manifest, out):
+    if not manifest["releases"]:
+        out.write("No releases in %s yet.\n" % manifest_path(args.board))
+        return 0
+    last = manifest["releases"][-1]
+    changed, added, removed = diff_inputs(last["inputs"], board_inputs(board))
+    if not (changed or added or removed):
+        out.write("Nothing has changed since release %s.\n" % last["version"])
+        return 0
+    out.write("Changed since release %s:\n" % last["version"])
+    for label, names in (("changed", changed), ("added", added), ("removed", removed)):
+        for name in names:
+            out.write("  %-8s %s\n" % (label, name))
+            known = manifest["regions"].get(name)
+            if known:
+                shared = " (shared with %s)" % ", ".join(known["shared_with"]) if known["shared_with"] else ""
+                out.write("             fed %d ROM region(s) in %s%s:\n" % (len(known["ranges"]), known["release"], shared))
+                for region in known["ranges"][:8]:
+                    out.write("               %s\n" % format_region(region))
+    out.write("Re-paste the changed events in PartyPlanner64, export the ROM, then run release.\n")
+    return 0
+
+
+def baseline(args, board, manifest, out):
+    if any(release["version"] == args.version for release in manifest["releases"]):
+        raise ValueError("release %s is already in the manifest" % args.version)
+    release = {"version": args.version, "inputs": board_inputs(board)}
+    if args.patch:
+        release["legacy_patch"] = args.patch
+    manifest["releases"].append(release)
+    save_manifest(args.board, manifest)
+    out.write("Recorded release %s (%d inputs) in %s\n" % (args.version, len(release["inputs"]),
+                                                         manifest_path(args.board)))
+    return 0
+
+
+def release(args, board, manifest, out):
+    board_dir = os.path.dirname(os.path.abspath(args.board))
+    if any(release["version"] == args.version for release in manifest["releases"]):
+        raise ValueError("release %s is already in the manifest" % args.version)
+
+    vanilla = read_file(args.vanilla)
+    if manifest.get("vanilla_sha256") and sha256(vanilla) != manifest["vanilla_sha256"]:
+        raise ValueError("%s isn't the vanilla ROM earlier releases were made from" % args.vanilla)
+    rom = read_file(args.rom)
+    previous = previous_rom(args, manifest, vanilla, board_dir)
+
+    inputs = board_inputs(board)
+    prefix = patch_prefix(board)
+    patches = {}    # file name -> (source, patch bytes)
+
+    full_name = "%s_%s.xdelta" % (prefix, version_tag(args.version))
+    patches[full_name] = (vanilla, vcdiff.encode(vanilla, rom))
+    entry = {"version": args.version, "inputs": inputs, "rom_sha256": sha256(rom), "full_patch": full_name}
+
+    if previous is not None:
+        last = manifest["releases"][-1]
+        changed, added, removed = diff_inputs(last["inputs"], inputs)
+        regions = changed_regions(previous, rom)
+        update_name = "%s_%s_to_%s.xdelta" % (prefix, version_tag(last["version"]), version_tag(args.version))
+        patches[update_name] = (previous, vcdiff.encode(previous, rom))
+        entry["update_patch"] = update_name
+        entry["changed_inputs"] = changed + added
+        entry["changed_regions"] = regions
+
+        out.write("Changed since %s: %s\n" % (last["version"], ", ".join(changed + added) or "nothing"))
+        out.write("ROM regions that changed: %d\n" % len(regions))
+        for region in regions[:16]:
+            out.write("  %s\n" % format_region(region))
+        if not (changed or added) and regions:
+            out.write("  (no tracked input changed - PartyPlanner64 or a setting did this)\n")
+        attribute_regions(manifest, args.version, changed + added, regions)
+        for name in removed:
+            manifest["regions"].pop(name, None)
+
+    for name, (source, patch) in patches.items():
+        if sha256(vcdiff.decode(source, patch)) != entry["rom_sha256"]:
+            raise ValueError("%s doesn't reproduce the ROM (encoder bug?); nothing was written" % name)
+
+    for name, (_, patch) in patches.items():
+        with open(os.path.join(board_dir, name), "wb") as f:
+            f.write(patch)
+        out.write("Wrote %s (%d bytes)\n" % (name, len(patch)))
+    manifest["vanilla_sha256"] = sha256(vanilla)
+    manifest["releases"].append(entry)
+    save_manifest(args.board, manifest)
+    return 0
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_status = sub.add_parser("status", help="list inputs changed since the last release")
+    p_status.add_argument("board")
+
+    p_release = sub.add_parser("release", help="write the full and update patches for a new ROM")
+    p_release.add_argument("board")
+    p_release.add_argument("--vanilla", required=True, help="the unmodified Mario Party 3 (USA) ROM")
+    p_release.add_argument("--rom", required=True, help="the ROM PartyPlanner64 exported for this release")
+    p_release.add_argument("--version", required=True, help="like 1.0.1")
+    p_release.add_argument("--previous", help="the last release's patched ROM, if this tool can't rebuild it")
+
+    p_baseline = sub.add_parser("baseline", help="record the board as an existing release")
+    p_baseline.add_argument("board")
+    p_baseline.add_argument("--version", required=True)
+    p_baseline.add_argument("--patch", help="the release's existing patch file, for the record")
+
+    args = parser.parse_args(argv)
+    board = boardlib.load_raw_board(args.board)
+    manifest = load_manifest(args.board)
+    command = {"status": status, "release": release, "baseline": baseline}[args.command]
+    try:
+        return command(args, board, manifest, sys.stdout)
+    except (ValueError, OSError) as e:
+        sys.stderr.write("%s failed: %s\n" % (args.command, e))
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
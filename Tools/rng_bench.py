@@ -0,0 +1,309 @@
+#!/usr/bin/env python3
+"""RNG benchmark: how fair the events' random helpers are, and how many random bytes they use.
+
+Every random choice an event makes comes out of GetRandomByte(), through a
+helper: mp3_PickARandomNumberBetween0AndN's rejection loop,
+mp3_ReturnTruePercentOfTime, the quiz's option shuffle, Ancient Mew's coin
+fuzz.  This calls the compiled helpers themselves, on the event_harness.py
+console, many times each with GetRandomByte answering from a seeded
+uniform generator, and for each one reports:
+  - the mean (and most) GetRandomByte calls one call of it used, against
+    the least a rejection sampler needs for that range,
+  - a chi-square test of its results against the distribution it should
+    have (uniform over 0 to N-1, or true P% of the time), with its p-value,
+  - the outcome furthest from its expected share, as a percentage and as
+    standard deviations (z), and any result it should never return.
+
+A case FAILS when the p-value is under --alpha, an outcome is more than
+--max-bias percent off and clearly (|z| > 4) so, it returns something out of
+range, it uses more random bytes on average than its limit, or it faults.
+
+The suite is the helpers and arguments the events in Complete/MP3 use;
+cases whose helper isn't in the object are skipped, so run it on each event
+that defines them.  --call adds a case of your own.  Compile the event as
+for event_harness.py; Ancient Mew's Mystery needs its PARAM values, e.g.
+-DHAPPENING_COIN_MULTIPLIER=3.
+
+Usage:
+    python3 Tools/rng_bench.py GameNight-Nintendo_Trivia_Quiz.o
+    python3 Tools/rng_bench.py Ancient_Mews_Mystery.o --samples 1000000
+    python3 Tools/rng_bench.py YourEvent.o --call "PickSpace(12)" --uniform 0-11 --outcomes
+"""
+
+import argparse
+import math
+import re
+import sys
+
+import r4300
+import event_harness
+
+DEFAULT_SAMPLES = 200000
+DEFAULT_ALPHA = 0.0001
+DEFAULT_MAX_BIAS = 1.0                  # Percent of an outcome's expected share
+SIGNIFICANT_Z = 4.0
+DRAWS_SLACK = 1.05                      # Suite cases may use this much more than the fewest random bytes
+SCRATCH = event_harness.HEAP_END        # Room for the arrays helpers fill in (the quiz's randomizedOptions)
+
+
+def uniform(low, high):
+    return dict((value, 1.0 / (high - low + 1)) for value in range(low, high + 1))
+
+
+def chance(percent):
+    return {1: percent / 100.0, 0: 1 - percent / 100.0}
+
+
+def rejection_draws(n):
+    """The fewest GetRandomByte calls, on average, a rejection sampler needs for 0 to n-1."""
+    return 256.0 / (256 - 256 % n)
+
+
+class Case:
+    def __init__(self, function, args, expect=None, minimum=None, max_draws=None):
+        self.function = function
+        self.args = args
+        self.expect = expect                # {outcome: probability}, or None to only check minimum
+        self.minimum = minimum
+        self.max_draws = max_draws
+
+    def name(self):
+        return "%s(%s)" % (self.function, ", ".join("scratch" if arg == SCRATCH else str(arg) for arg in self.args))
+
+
+def _pick(n):
+    return Case("mp3_PickARandomNumberBetween0AndN", (n,), uniform(0, n - 1), max_draws=rejection_draws(n) * DRAWS_SLACK)
+
+
+def _percent(percent):
+    return Case("mp3_ReturnTruePercentOfTime", (percent,), chance(percent), max_draws=rejection_draws(100) * DRAWS_SLACK)
+
+
+SUITE = [
+    _pick(2), _pick(3), _pick(48), _pick(64), _pick(99),       # 48/64: ACTIVE_QUESTIONS
+    _percent(25), _percent(50), _percent(75),                   # Quiz CPU accuracy, Reduce Hidden Blocks
+    Case("RandomizeOptionOrder", (SCRATCH, 1, 2, 3, 4), uniform(0, 3), max_draws=7),
+    Case("CalculateCoinReward", (0,), minimum=0),
+    Case("CalculateCoinReward", (1,), minimum=0),
+]
+
+
+class StubInputs(event_harness.Inputs):
+    """GetRandomByte from a seeded generator, counted and not logged."""
+
+    def __init__(self, seed):
+        event_harness.Inputs.__init__(self, seed)
+        self.draws = 0
+
+    def random_byte(self):
+        self.draws += 1
+        return self.rng.getrandbits(8)
+
+
+class Stats:
+    def __init__(self):
+        self.calls = 0
+        self.counts = {}
+        self.draws = 0
+        self.most_draws = 0
+        self.fault = None
+
+
+def run_case(data, case, samples, seed):
+    inputs = StubInputs(seed)
+    game = event_harness.Game(inputs)
+    image = game.load(data)
+    stats = Stats()
+    address = image.symbols[case.function]
+    cpu = game.cpu
+    for _ in range(samples):
+        cpu.gpr[r4300.SP] = r4300.sext32(event_harness.STACK_TOP - 64)
+        for index, value in enumerate(case.args[4:]):
+            game.memory.write_u32(event_harness.STACK_TOP - 64 + 16 + 4 * index, value)
+        game.heap_next = event_harness.HEAP_BASE
+        before = inputs.draws
+        try:
+            value = r4300.signed32(cpu.call(address, case.args, event_harness.RETURN_ADDRESS, 1000000))
+        except r4300.Fault as e:
+            where = image.symbol_at(e.pc) if e.pc is not None else None
+            stats.fault = str(e) + (" in %s" % where if where else "")
+            break
+        game.result.inputs.random = bytearray()
+        stats.calls += 1
+        stats.counts[value] = stats.counts.get(value, 0) + 1
+        stats.draws += inputs.draws - before
+        stats.most_draws = max(stats.most_draws, inputs.draws - before)
+    return stats
+
+
+def chi_square_p(statistic, freedom):
+    """P(X >= statistic) for X chi-square distributed with `freedom` degrees of freedom."""
+    if freedom <= 0:
+        return 1.0
+    a, x = freedom / 2.0, statistic / 2.0
+    if x <= 0:
+        return 1.0
+    log_front = a * math.log(x) - x - math.lgamma(a)
+    if x < a + 1:
+        term = total = 1.0 / a
+        for n in range(1, 1000):
+            term *= x / (a + n)
+            total += term
+            if term < total * 1e-15:
+                break
+        return max(0.0, 1.0 - total * math.exp(log_front))
+    # Lentz's continued fraction for the upper tail.
+    b = x + 1 - a
+    c = 1e300
+    d = 1 / b
+    h = d
+    for n in range(1, 1000):
+        an = -n * (n - a)
+        b += 2
+        d = an * d + b
+        d = 1e-300 if abs(d) < 1e-300 else d
+        c = b + an / c
+        c = 1e-300 if abs(c) < 1e-300 else c
+        d = 1 / d
+        h *= d * c
+        if abs(d * c - 1) < 1e-15:
+            break
+    return math.exp(log_front) * h
+
+
+def judge(case, stats, args):
+    """Returns (chi-square p or None, worst (outcome, bias %, z) or None, [failure reasons])."""
+    failures = []
+    if stats.fault:
+        failures.append("FAULT: %s" % stats.fault)
+    if not stats.calls:
+        return None, None, failures
+    mean_draws = stats.draws / stats.calls
+    limit = args.max_draws if args.max_draws is not None else case.max_draws
+    if limit is not None and mean_draws > limit:
+        failures.append("uses %.3f random bytes a call, limit %.3f" % (mean_draws, limit))
+    if case.minimum is not None and min(stats.counts) < case.minimum:
+        failures.append("returned %d, below %d" % (min(stats.counts), case.minimum))
+    if case.expect is None:
+        return None, None, failures
+
+    strays = sorted(value for value in stats.counts if value not in case.expect)
+    if strays:
+        failures.append("returned %s, never expected" % ", ".join(str(value) for value in strays[:5]))
+    statistic = 0.0
+    worst = None
+    biased = 0
+    for outcome, probability in sorted(case.expect.items()):
+        expected = stats.calls * probability
+        observed = stats.counts.get(outcome, 0)
+        if expected <= 0:
+            continue
+        statistic += (observed - expected) ** 2 / expected
+        bias = (observed / expected - 1) * 100
+        z = (observed - expected) / math.sqrt(expected * (1 - probability)) if probability < 1 else 0.0
+        if worst is None or abs(z) > abs(worst[2]):
+            worst = (outcome, bias, z)
+        if abs(bias) > args.max_bias and abs(z) > SIGNIFICANT_Z:
+            biased += 1
+    p = chi_square_p(statistic, len(case.expect) - 1)
+    if p < args.alpha:
+        failures.append("not the expected distribution (p %.2g)" % p)
+    if biased:
+        failures.append("%d outcome(s) more than %g%% off" % (biased, args.max_bias))
+    return p, worst, failures
+
+
+def print_outcomes(case, stats, out):
+    outcomes = sorted(set(stats.counts) | set(case.expect or {}))
+    out.write("    %8s %10s %9s %9s %8s\n" % ("outcome", "calls", "share", "expected", "bias"))
+    for outcome in outcomes:
+        observed = stats.counts.get(outcome, 0)
+        probability = (case.expect or {}).get(outcome)
+        out.write("    %8d %10d %8.3f%% %9s %8s\n" % (outcome, observed, 100.0 * observed / max(1, stats.calls),
+                  "%.3f%%" % (100 * probability) if probability is not None else "-",
+                  "%+.2f%%" % ((observed / (stats.calls * probability) - 1) * 100) if probability else "-"))
+
+
+def parse_call(text):
+    match = re.match(r"^\s*(\w+)\s*\((.*)\)\s*$", text)
+    if not match:
+        raise argparse.ArgumentTypeError("wants a call like \"PickSpace(12)\"")
+    try:
+        values = [int(arg, 0) for arg in match.group(2).split(",") if arg.strip()]
+    except ValueError:
+        raise argparse.ArgumentTypeError("arguments must be numbers: %s" % text)
+    return match.group(1), tuple(values)
+
+
+def parse_range(text):
+    low, _, high = text.partition("-")
+    try:
+        return int(low), int(high or low)
+    except ValueError:
+        raise argparse.ArgumentTypeError("wants LOW-HIGH, like 0-11")
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("object", help="the event compiled to a big-endian MIPS .o")
+    parser.add_argument("--samples", type=int, default=DEFAULT_SAMPLES,
+                        help="calls of each helper (default %d)" % DEFAULT_SAMPLES)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--only", action="append", default=[], metavar="FUNCTION", help="run only these helpers")
+    parser.add_argument("--call", type=parse_call, help="run this call instead of the suite, like \"PickSpace(12)\"")
+    parser.add_argument("--uniform", type=parse_range, metavar="LOW-HIGH", help="--call should return these evenly")
+    parser.add_argument("--percent", type=float, help="--call should return 1 this percent of the time, else 0")
+    parser.add_argument("--minimum", type=int, help="--call should never return less than this")
+    parser.add_argument("--alpha", type=float, default=DEFAULT_ALPHA,
+                        help="fail when the chi-square p-value is under this (default %g)" % DEFAULT_ALPHA)
+    parser.add_argument("--max-bias", type=float, default=DEFAULT_MAX_BIAS,
+                        help="fail when an outcome is significantly more than this percent off (default %g)"
+                             % DEFAULT_MAX_BIAS)
+    parser.add_argument("--max-draws", type=float, help="fail when a call uses more random bytes than this on average")
+    parser.add_argument("--outcomes", action="store_true", help="list every outcome's share")
+    args = parser.parse_args(argv)
+
+    try:
+        with open(args.object, "rb") as f:
+            data = f.read()
+        symbols = event_harness.Game(StubInputs(args.seed)).load(data).symbols
+    except (ValueError, OSError) as e:
+        sys.stderr.write("RNG benchmark failed: %s\n" % e)
+        return 1
+
+    if args.call:
+        expect = uniform(*args.uniform) if args.uniform else chance(args.percent) if args.percent is not None else None
+        cases = [Case(args.call[0], args.call[1], expect, args.minimum)]
+    else:
+        cases = [case for case in SUITE if not args.only or case.function in args.only]
+    missing = sorted(set(case.function for case in cases if case.function not in symbols))
+    cases = [case for case in cases if case.function in symbols]
+
+    out = sys.stdout
+    out.write("%s: %d calls of each helper, GetRandomByte seeded with %d\n\n" % (args.object, args.samples, args.seed))
+    out.write("%-44s %8s %6s %10s %24s  %s\n" % ("case", "draws", "most", "p", "furthest off", "result"))
+    failed = 0
+    for case in cases:
+        stats = run_case(data, case, args.samples, args.seed)
+        p, worst, failures = judge(case, stats, args)
+        draws = stats.draws / stats.calls if stats.calls else 0
+        furthest = "%d: %+.2f%% (z %+.1f)" % worst if worst else "-"
+        out.write("%-44s %8.3f %6d %10s %24s  %s\n" % (case.name()[:44], draws, stats.most_draws,
+                  "%.3g" % p if p is not None else "-", furthest, "; ".join(failures) or "ok"))
+        if args.outcomes and stats.calls:
+            print_outcomes(case, stats, out)
+        failed += bool(failures)
+    if missing:
+        out.write("\nskipped (not in this object): %s\n" % ", ".join(missing))
+    if not cases:
+        out.write("\nNo helpers to run\n")
+        return 1
+    if failed:
+        out.write("\n%d of %d case(s) FAILED\n" % (failed, len(cases)))
+        return 1
+    out.write("\nAll %d case(s) ok\n" % len(cases))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
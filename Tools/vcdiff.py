@@ -0,0 +1,412 @@
+#!/usr/bin/env python3
+"""VCDIFF (RFC 3284) patches, the format .xdelta files use, in plain Python.
+
+Patches made here open in xdelta3, Delta Patcher and the other xdelta
+patchers players already use.  They carry no secondary compression, so
+they're bigger than xdelta3's for large rewrites, but a patch between two
+nearly identical ROMs is mostly COPY instructions and comes out tiny.
+
+The encoder looks for matches in two passes:
+  - same offset: the bytes at the same position in the source ROM.  A ROM
+    that PartyPlanner64 re-exported after a small change is identical almost
+    everywhere, and those stretches are compared with C-speed slice compares
+    instead of byte by byte.
+  - moved data: a hash of 32-byte blocks of the source, for data that moved.
+Anything left is a RUN (padding) or an ADD.
+
+The decoder understands every window the encoder writes, plus any xdelta3
+patch made without secondary compression (xdelta3 -S none), so it's also how
+release_patch.py checks a patch before writing it.
+
+Usage:
+    python3 Tools/vcdiff.py encode old.z64 new.z64 update.xdelta
+    python3 Tools/vcdiff.py apply old.z64 update.xdelta new.z64
+"""
+
+import argparse
+import sys
+import zlib
+
+MAGIC = b"\xd6\xc3\xc4\x00"
+
+VCD_DECOMPRESS = 0x01
+VCD_CODETABLE = 0x02
+VCD_APPHEADER = 0x04
+
+VCD_SOURCE = 0x01
+VCD_TARGET = 0x02
+VCD_ADLER32 = 0x04      # xdelta3's extension: adler32 of the target window
+
+NOOP, ADD, RUN, COPY = 0, 1, 2, 3
+
+WINDOW_SIZE = 1 << 20   # Comfortably under xdelta3's default 8 MB decode window
+MIN_SAME_OFFSET_COPY = 8
+HASH_BLOCK = 32
+MIN_RUN = 8
+
+
+def _default_code_table():
+    """The RFC 3284 section 5.6 default instruction code table: 256 (inst1, size1, mode1, inst2, size2, mode2)."""
+    table = [(RUN, 0, 0, NOOP, 0, 0)]
+    table += [(ADD, size, 0, NOOP, 0, 0) for size in range(0, 18)]
+    for mode in range(9):
+        table.append((COPY, 0, mode, NOOP, 0, 0))
+        table += [(COPY, size, mode, NOOP, 0, 0) for size in range(4, 19)]
+    for mode in range(6):
+        table += [(ADD, add, 0, COPY, copy, mode) for add in range(1, 5) for copy in range(4, 7)]
+    for mode in range(6, 9):
+        table += [(ADD, add, 0, COPY, 4, mode) for add in range(1, 5)]
+    table += [(COPY, 4, mode, ADD, 1, 0) for mode in range(9)]
+    assert len(table) == 256
+    return table
+
+
+CODE_TABLE = _default_code_table()
+# Code table indices the encoder uses: every instruction with its size written out.
+CODE_RUN = 0
+CODE_ADD = 1
+CODE_COPY_SELF = 19
+
+
+#***************************************************************************#
+#******************************** Integers *********************************#
+#***************************************************************************#
+
+def write_int(out, value):
+    """RFC 3284 variable-length integer: base 128, most significant digit first."""
+    digits = [value & 0x7F]
+    value >>= 7
+    while value:
+        digits.append(0x80 | (value & 0x7F))
+        value >>= 7
+    out.extend(reversed(digits))
+
+
+class _Reader:
+    def __init__(self, data, pos=0, end=None):
+        self.data = data
+        self.pos = pos
+        self.end = len(data) if end is None else end
+
+    def byte(self):
+        if self.pos >= self.end:
+            raise ValueError("VCDIFF: unexpected end of data")
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def int(self):
+        value = 0
+        for _ in range(10):
+            digit = self.byte()
+            value = (value << 7) | (digit & 0x7F)
+            if not digit & 0x80:
+                return value
+        raise ValueError("VCDIFF: integer too long")
+
+    def bytes(self, count):
+        if self.pos + count > self.end:
+            raise ValueError("VCDIFF: unexpected end of data")
+        value = self.data[self.pos:self.pos + count]
+        self.pos += count
+        return value
+
+
+#***************************************************************************#
+#********************************* Encoding ********************************#
+#***************************************************************************#
+
+def match_length(a, a_pos, b, b_pos, limit):
+    """How many bytes a[a_pos:] and b[b_pos:] have in common, up to limit.
+
+    Compares big slices first and narrows down on a mismatch, so long equal
+    stretches cost a handful of memcmp calls instead of a Python loop.
+    """
+    limit = min(limit, len(a) - a_pos, len(b) - b_pos)
+    length = 0
+    step = 4096
+    while length < limit:
+        size = min(step, limit - length)
+        if a[a_pos + length:a_pos + length + size] == b[b_pos + length:b_pos + length + size]:
+            length += size
+            step = min(step * 2, 1 << 20)
+        elif size == 1:
+            break
+        else:
+            step = max(1, size // 16)
+    return length
+
+
+def build_source_index(source):
+    """Maps 32-byte blocks of the source (at 32-byte boundaries) to their offsets.
+
+    Blocks of a single repeated byte are skipped: they're ROM padding, and RUN
+    encodes them better than a COPY would.
+    """
+    index = {}
+    for pos in range(0, len(source) - HASH_BLOCK + 1, HASH_BLOCK):
+        block = source[pos:pos + HASH_BLOCK]
+        if block.count(block[0]) == HASH_BLOCK:
+            continue
+        index.setdefault(block, pos)
+    return index
+
+
+def _find_moved(source, index, target, pos, end):
+    """Returns (source offset, length) of a match at target[pos] from the block index, or None.
+
+    Blocks are only indexed at 32-byte boundaries, so a moved stretch is found
+    once pos reaches the first indexed block inside it; the bytes before that
+    go out as an ADD.  Matches shorter than a block are left to ADD.
+    """
+    if end - pos < HASH_BLOCK:
+        return None
+    src = index.get(target[pos:pos + HASH_BLOCK])
+    if src is None:
+        return None
+    return src, HASH_BLOCK + match_length(source, src + HASH_BLOCK, target, pos + HASH_BLOCK,
+                                          end - pos - HASH_BLOCK)
+
+
+def _encode_window(source, index, target, start, end):
+    """Returns the instructions for target[start:end] as (kind, size, value) tuples.
+
+    COPY values are source offsets, RUN values the repeated byte, ADD values the bytes.
+    """
+    instructions = []
+    pending = start     # Start of the bytes waiting to become an ADD
+
+    def flush(upto):
+        if upto > pending:
+            instructions.append((ADD, upto - pending, target[pending:upto]))
+
+    pos = start
+    while pos < end:
+        # Cheap checks first: most positions in a changed stretch match nothing.
+        length = 0
+        if source[pos:pos + MIN_SAME_OFFSET_COPY] == target[pos:pos + MIN_SAME_OFFSET_COPY]:
+            length = match_length(source, pos, target, pos, end - pos)
+        if length >= MIN_SAME_OFFSET_COPY:
+            flush(pos)
+            instructions.append((COPY, length, pos))
+            pos += length
+            pending = pos
+            continue
+
+        moved = _find_moved(source, index, target, pos, end) if index else None
+        if moved:
+            flush(pos)
+            instructions.append((COPY, moved[1], moved[0]))
+            pos += moved[1]
+            pending = pos
+            continue
+
+        # target[pos:] against itself one byte on is the length of the run of target[pos].
+        run = 1
+        if target[pos:pos + MIN_RUN - 1] == target[pos + 1:pos + MIN_RUN]:
+            run += match_length(target, pos, target, pos + 1, end - pos - 1)
+        if run >= MIN_RUN:
+            flush(pos)
+            instructions.append((RUN, run, target[pos]))
+            pos += run
+            pending = pos
+            continue
+
+        pos += run
+    flush(end)
+    return instructions
+
+
+def encode(source, target, window_size=WINDOW_SIZE, index=None):
+    """Returns a VCDIFF patch that turns source into target."""
+    source = bytes(source)
+    target = bytes(target)
+    if index is None:
+        index = build_source_index(source)
+
+    out = bytearray(MAGIC)
+    out.append(0)   # Hdr_Indicator: no secondary compressor, default code table, no app header
+
+    for start in range(0, max(len(target), 1), window_size):
+        end = min(start + window_size, len(target))
+        instructions = _encode_window(source, index, target, start, end)
+
+        copies = [(value, value + size) for kind, size, value in instructions if kind == COPY]
+        segment_pos = min(lo for lo, _ in copies) if copies else 0
+        segment_len = (max(hi for _, hi in copies) - segment_pos) if copies else 0
+
+        data, inst, addr = bytearray(), bytearray(), bytearray()
+        for kind, size, value in instructions:
+            if kind == ADD:
+                inst.append(CODE_ADD)
+                write_int(inst, size)
+                data.extend(value)
+            elif kind == RUN:
+                inst.append(CODE_RUN)
+                write_int(inst, size)
+                data.append(value)
+            else:
+                inst.append(CODE_COPY_SELF)
+                write_int(inst, size)
+                write_int(addr, value - segment_pos)
+
+        delta = bytearray()
+        write_int(delta, end - start)
+        delta.append(0)     # Delta_Indicator: no section is compressed
+        write_int(delta, len(data))
+        write_int(delta, len(inst))
+        write_int(delta, len(addr))
+        delta.extend((zlib.adler32(target[start:end]) & 0xFFFFFFFF).to_bytes(4, "big"))
+        delta.extend(data)
+        delta.extend(inst)
+        delta.extend(addr)
+
+        if copies:
+            out.append(VCD_SOURCE | VCD_ADLER32)
+            write_int(out, segment_len)
+            write_int(out, segment_pos)
+        else:
+            out.append(VCD_ADLER32)
+        write_int(out, len(delta))
+        out.extend(delta)
+    return bytes(out)
+
+
+#***************************************************************************#
+#********************************* Decoding ********************************#
+#***************************************************************************#
+
+class _AddressCache:
+    NEAR = 4
+    SAME = 3
+
+    def __init__(self):
+        self.near = [0] * self.NEAR
+        self.next_near = 0
+        self.same = [0] * (self.SAME * 256)
+
+    def decode(self, reader, here, mode):
+        if mode == 0:
+            address = reader.int()
+        elif mode == 1:
+            address = here - reader.int()
+        elif mode < 2 + self.NEAR:
+            address = self.near[mode - 2] + reader.int()
+        else:
+            address = self.same[(mode - 2 - self.NEAR) * 256 + reader.byte()]
+        self.near[self.next_near] = address
+        self.next_near = (self.next_near + 1) % self.NEAR
+        self.same[address % len(self.same)] = address
+        return address
+
+
+def decode(source, patch):
+    """Applies a VCDIFF patch to source and returns the target."""
+    reader = _Reader(patch)
+    if reader.bytes(4) != MAGIC:
+        raise ValueError("not a VCDIFF patch")
+    indicator = reader.byte()
+    if indicator & VCD_DECOMPRESS:
+        raise ValueError("patch uses a secondary compressor (make it with xdelta3 -S none)")
+    if indicator & VCD_CODETABLE:
+        raise ValueError("patch uses a custom code table")
+    if indicator & VCD_APPHEADER:
+        reader.bytes(reader.int())
+
+    target = bytearray()
+    while reader.pos < len(patch):
+        window = reader.byte()
+        segment = b""
+        if window & (VCD_SOURCE | VCD_TARGET):
+            length = reader.int()
+            position = reader.int()
+            base = source if window & VCD_SOURCE else target
+            if position + length > len(base):
+                raise ValueError("patch reads past the end of its %s" % ("source" if window & VCD_SOURCE else "target"))
+            segment = bytes(base[position:position + length])
+        delta_end = reader.int()
+        delta_end += reader.pos
+
+        target_len = reader.int()
+        if reader.byte() != 0:
+            raise ValueError("patch has compressed sections (make it with xdelta3 -S none)")
+        data_len = reader.int()
+        inst_len = reader.int()
+        addr_len = reader.int()
+        checksum = int.from_bytes(reader.bytes(4), "big") if window & VCD_ADLER32 else None
+        data = _Reader(patch, reader.pos, reader.pos + data_len)
+        inst = _Reader(patch, data.end, data.end + inst_len)
+        addr = _Reader(patch, inst.end, inst.end + addr_len)
+        if addr.end != delta_end:
+            raise ValueError("patch window sizes don't add up")
+
+        out = bytearray()
+        cache = _AddressCache()
+        while inst.pos < inst.end:
+            code = CODE_TABLE[inst.byte()]
+            for kind, size, mode in ((code[0], code[1], code[2]), (code[3], code[4], code[5])):
+                if kind == NOOP:
+                    continue
+                if size == 0:
+                    size = inst.int()
+                if kind == ADD:
+                    out += data.bytes(size)
+                elif kind == RUN:
+                    out += bytes([data.byte()]) * size
+                else:
+                    here = len(segment) + len(out)
+                    address = cache.decode(addr, here, mode)
+                    if address + size <= len(segment):
+                        out += segment[address:address + size]
+                        continue
+                    for i in range(size):     # Reaches into this window's own output, maybe overlapping
+                        a = address + i
+                        out.append(segment[a] if a < len(segment) else out[a - len(segment)])
+        if len(out) != target_len:
+            raise ValueError("patch window decoded to %d bytes, expected %d" % (len(out), target_len))
+        if checksum is not None and zlib.adler32(out) & 0xFFFFFFFF != checksum:
+            raise ValueError("patch window checksum mismatch (wrong source ROM?)")
+        target += out
+        reader.pos = delta_end
+    return bytes(target)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_encode = sub.add_parser("encode", help="make a patch from source to target")
+    p_encode.add_argument("source")
+    p_encode.add_argument("target")
+    p_encode.add_argument("patch")
+    p_apply = sub.add_parser("apply", help="apply a patch to source")
+    p_apply.add_argument("source")
+    p_apply.add_argument("patch")
+    p_apply.add_argument("target")
+    args = parser.parse_args(argv)
+
+    with open(args.source, "rb") as f:
+        source = f.read()
+    if args.command == "encode":
+        with open(args.target, "rb") as f:
+            target = f.read()
+        patch = encode(source, target)
+        with open(args.patch, "wb") as f:
+            f.write(patch)
+        sys.stdout.write("Wrote %s (%d bytes)\n" % (args.patch, len(patch)))
+        return 0
+
+    with open(args.patch, "rb") as f:
+        patch = f.read()
+    try:
+        target = decode(source, patch)
+    except ValueError as e:
+        sys.stderr.write("%s: %s\n" % (args.patch, e))
+        return 1
+    with open(args.target, "wb") as f:
+        f.write(target)
+    sys.stdout.write("Wrote %s (%d bytes)\n" % (args.target, len(target)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())